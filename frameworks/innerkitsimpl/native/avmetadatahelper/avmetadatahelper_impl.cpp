@@ -66,6 +66,15 @@ int32_t AVMetadataHelperImpl::SetSource(const std::string &uri, int32_t usage)
     return avMetadataHelperService_->SetSource(uri, usage);
 }
 
+int32_t AVMetadataHelperImpl::SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage)
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperService_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist..");
+    CHECK_AND_RETURN_RET_LOG(fd >= 0 && offset >= 0, MSERR_INVALID_VAL, "invalid fd or offset.");
+
+    return avMetadataHelperService_->SetSource(fd, offset, size, usage);
+}
+
 std::string AVMetadataHelperImpl::ResolveMetadata(int32_t key)
 {
     CHECK_AND_RETURN_RET_LOG(avMetadataHelperService_ != nullptr, "",
@@ -90,6 +99,44 @@ sptr<PixelMap> AVMetadataHelperImpl::FetchFrameAtTime(int64_t timeUs, int32_t op
     return nullptr;
 }
 
+std::vector<sptr<PixelMap>> AVMetadataHelperImpl::FetchFramesAtTimes(const std::vector<int64_t> &timesUs,
+    int32_t option, PixelMapParams param)
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperService_ != nullptr, {},
+        "avmetadatahelper service does not exist.");
+    CHECK_AND_RETURN_RET_LOG(!timesUs.empty() &&
+        timesUs.size() <= static_cast<size_t>(OutputFrameSlab::MAX_FRAME_COUNT), {},
+        "invalid timestamp count: %{public}zu", timesUs.size());
+
+    // the same as FetchFrameAtTime, the frames can not be wrapped into the pixelmap yet.
+    (void)option;
+    (void)param;
+    return std::vector<sptr<PixelMap>>(timesUs.size(), nullptr);
+}
+
+int32_t AVMetadataHelperImpl::ScanMetadata(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+    const std::shared_ptr<AVMetadataScanCallback> &callback)
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperService_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+    CHECK_AND_RETURN_RET_LOG(!sources.empty() &&
+        sources.size() <= static_cast<size_t>(IAVMetadataHelperService::MAX_SCAN_SOURCE_COUNT), MSERR_INVALID_VAL,
+        "invalid scan source count: %{public}zu", sources.size());
+    CHECK_AND_RETURN_RET_LOG(priority == AV_META_SCAN_PRIORITY_BACKGROUND ||
+        priority == AV_META_SCAN_PRIORITY_FOREGROUND, MSERR_INVALID_VAL, "invalid scan priority: %{public}d", priority);
+    CHECK_AND_RETURN_RET_LOG(callback != nullptr, MSERR_INVALID_VAL, "scan callback is nullptr");
+
+    return avMetadataHelperService_->ScanMetadata(sources, priority, callback);
+}
+
+int32_t AVMetadataHelperImpl::CancelScan()
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperService_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+
+    return avMetadataHelperService_->CancelScan();
+}
+
 void AVMetadataHelperImpl::Release()
 {
     CHECK_AND_RETURN_LOG(avMetadataHelperService_ != nullptr, "avmetadatahelper service does not exist.");
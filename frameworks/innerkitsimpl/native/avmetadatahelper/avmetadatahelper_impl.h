@@ -28,9 +28,15 @@ public:
     DISALLOW_COPY_AND_MOVE(AVMetadataHelperImpl);
 
     int32_t SetSource(const std::string &uri, int32_t usage) override;
+    int32_t SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage) override;
     std::string ResolveMetadata(int32_t key) override;
     std::unordered_map<int32_t, std::string> ResolveMetadata() override;
     sptr<PixelMap> FetchFrameAtTime(int64_t timeUs, int32_t option, PixelMapParams param) override;
+    std::vector<sptr<PixelMap>> FetchFramesAtTimes(const std::vector<int64_t> &timesUs,
+        int32_t option, PixelMapParams param) override;
+    int32_t ScanMetadata(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+        const std::shared_ptr<AVMetadataScanCallback> &callback) override;
+    int32_t CancelScan() override;
     void Release() override;
     int32_t Init();
 private:
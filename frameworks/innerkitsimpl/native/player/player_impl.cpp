@@ -88,6 +88,27 @@ int32_t PlayerImpl::SetSource(const std::string &uri)
     return playerService_->SetSource(uri);
 }
 
+int32_t PlayerImpl::SetSource(int32_t fd, int64_t offset, int64_t size)
+{
+    CHECK_AND_RETURN_RET_LOG(playerService_ != nullptr, MSERR_INVALID_OPERATION, "player service does not exist..");
+    CHECK_AND_RETURN_RET_LOG(fd >= 0 && offset >= 0, MSERR_INVALID_VAL, "invalid fd or offset..");
+    return playerService_->SetSource(fd, offset, size);
+}
+
+int32_t PlayerImpl::SetNextSource(const std::string &uri)
+{
+    CHECK_AND_RETURN_RET_LOG(playerService_ != nullptr, MSERR_INVALID_OPERATION, "player service does not exist..");
+    CHECK_AND_RETURN_RET_LOG(!uri.empty(), MSERR_INVALID_VAL, "uri is empty..");
+    return playerService_->SetNextSource(uri);
+}
+
+int32_t PlayerImpl::SetNextSource(int32_t fd, int64_t offset, int64_t size)
+{
+    CHECK_AND_RETURN_RET_LOG(playerService_ != nullptr, MSERR_INVALID_OPERATION, "player service does not exist..");
+    CHECK_AND_RETURN_RET_LOG(fd >= 0 && offset >= 0, MSERR_INVALID_VAL, "invalid fd or offset..");
+    return playerService_->SetNextSource(fd, offset, size);
+}
+
 int32_t PlayerImpl::Play()
 {
     CHECK_AND_RETURN_RET_LOG(playerService_ != nullptr, MSERR_INVALID_OPERATION, "player service does not exist..");
@@ -210,6 +231,13 @@ int32_t PlayerImpl::SetLooping(bool loop)
     return playerService_->SetLooping(loop);
 }
 
+int32_t PlayerImpl::SetAudioOnly(bool audioOnly)
+{
+    CHECK_AND_RETURN_RET_LOG(playerService_ != nullptr, MSERR_INVALID_OPERATION, "player service does not exist..");
+
+    return playerService_->SetAudioOnly(audioOnly);
+}
+
 int32_t PlayerImpl::SetPlayerCallback(const std::shared_ptr<PlayerCallback> &callback)
 {
     CHECK_AND_RETURN_RET_LOG(playerService_ != nullptr, MSERR_INVALID_OPERATION, "player service does not exist..");
@@ -248,15 +248,26 @@ std::shared_ptr<AVSharedMemory> MediaDataSourceNapi::GetMem()
     size_t arrayBufferLength = 0;
     napi_status status = napi_get_arraybuffer_info(env_, result, &tmpArrayBufferPtr, &arrayBufferLength);
     CHECK_AND_RETURN_RET_LOG(status == napi_ok, nullptr, "get value for ref failed");
-    std::string name = "mediaData";
-    std::shared_ptr<AVSharedMemory> mem = AVSharedMemory::Create(static_cast<int32_t>(arrayBufferLength),
-        AVSharedMemory::Flags::FLAGS_READ_ONLY, name);
+    std::shared_ptr<AVSharedMemory> mem = AcquireMem(static_cast<int32_t>(arrayBufferLength));
     CHECK_AND_RETURN_RET_LOG(mem != nullptr && mem->GetBase() != nullptr, nullptr, "create avshmem failed");
     errno_t rc = memcpy_s(mem->GetBase(), static_cast<size_t>(mem->GetSize()), tmpArrayBufferPtr, arrayBufferLength);
     CHECK_AND_RETURN_RET_LOG(rc == EOK, nullptr, "memcpy_s failed");
     return mem;
 }
 
+std::shared_ptr<AVSharedMemory> MediaDataSourceNapi::AcquireMem(int32_t size)
+{
+    if (memPool_ == nullptr) {
+        // the service consumes the memory before the next ReadAt, so a few memories are enough.
+        auto pool = std::make_shared<AVSharedMemoryPool>("mediaData");
+        AVSharedMemoryPool::InitializeOption option;
+        option.flags = AVSharedMemory::Flags::FLAGS_READ_ONLY;
+        CHECK_AND_RETURN_RET_LOG(pool->Init(option) == MSERR_OK, nullptr, "init mem pool failed");
+        memPool_ = pool;
+    }
+    return memPool_->AcquireMemory(size);
+}
+
 int32_t MediaDataSourceNapi::ReadAt(int64_t pos, uint32_t length)
 {
     CHECK_AND_RETURN_RET_LOG(env_ != nullptr, 0, "env is nullptr");
@@ -307,6 +318,7 @@ int32_t MediaDataSourceNapi::GetSize(int64_t &size) const
 
 void MediaDataSourceNapi::Release()
 {
+    memPool_ = nullptr;
     CHECK_AND_RETURN_LOG(callbackWorks_ != nullptr, "callbackwork is null");
     callbackWorks_->CancelAll();
 }
@@ -113,6 +113,10 @@ napi_value AudioPlayerNapi::Constructor(napi_env env, napi_callback_info info)
     playerNapi->env_ = env;
     playerNapi->nativePlayer_ = PlayerFactory::CreatePlayer();
     CHECK_AND_RETURN_RET_LOG(playerNapi->nativePlayer_ != nullptr, nullptr, "nativePlayer_ no memory");
+    // the audio player never has a surface, the gstplayer is built without the video chain.
+    if (playerNapi->nativePlayer_->SetAudioOnly(true) != MSERR_OK) {
+        MEDIA_LOGW("set audio only failed, the video chain is built");
+    }
 
     if (playerNapi->callbackNapi_ == nullptr) {
         playerNapi->callbackNapi_ = std::make_shared<PlayerCallbackNapi>(env);
@@ -19,6 +19,7 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 #include "refbase.h"
 #include "display_type.h"
 #include "nocopyable.h"
@@ -171,6 +172,68 @@ struct PixelMapParams {
     int32_t colorFormat = PixelFormat::PIXEL_FMT_RGB_565;
 };
 
+/**
+ * @brief Provides the priority of the metadata scanning, the sources of the higher priority
+ * scans are scanned ahead of the lower ones, even if they are submitted later.
+ */
+enum AVMetadataScanPriority : int32_t {
+    /**
+     * Indicates the scanning for the background work, such as the media library scanning.
+     */
+    AV_META_SCAN_PRIORITY_BACKGROUND,
+    /**
+     * Indicates the scanning requested by the foreground user interface, such as the gallery.
+     */
+    AV_META_SCAN_PRIORITY_FOREGROUND,
+};
+
+/**
+ * @brief Provides the definition of one media source to be scanned.
+ */
+struct AVMetadataScanSource {
+    /**
+     * The uri of the media source, used if the fd is negative.
+     */
+    std::string uri;
+    /**
+     * The file descriptor of the media source, it is not closed by the scanning.
+     */
+    int32_t fd = -1;
+    /**
+     * The start offset of the media in the file.
+     */
+    int64_t offset = 0;
+    /**
+     * The size of the media in bytes, -1 means to the end of the file.
+     */
+    int64_t size = -1;
+};
+
+/**
+ * @brief Provides the callback of the metadata scanning.
+ */
+class AVMetadataScanCallback {
+public:
+    virtual ~AVMetadataScanCallback() = default;
+
+    /**
+     * Called when the metadata of one source is resolved or failed, in the order of the
+     * completion, not the order of the sources.
+     * @param index the index of the source in the scanned sources.
+     * @param errorCode {@link MSERR_OK} if resolved, or the error code.
+     * @param metadata the metadata of the source, empty on failure.
+     */
+    virtual void OnScanResult(int32_t index, int32_t errorCode,
+        const std::unordered_map<int32_t, std::string> &metadata) = 0;
+
+    /**
+     * Called once after the results of all sources, or after the scanning is canceled.
+     * @param scannedCount the number of the results reported.
+     * @param canceled whether the scanning is canceled.
+     */
+    virtual void OnScanFinished(int32_t scannedCount, bool canceled) = 0;
+};
+
 /**
  * @brief Provides the interfaces to resolve metadata or fetch frame
  * from a given media resource.
@@ -191,6 +254,21 @@ public:
      */
     virtual int32_t SetSource(const std::string &uri, int32_t usage = AVMetadataUsage::AV_META_USAGE_PIXEL_MAP) = 0;
 
+    /**
+     * Set the media source by a file descriptor, the data is read by the media service directly.
+     * This method maybe time consuming.
+     * @param fd the file descriptor of a regular file opened for reading. It is not owned by
+     * the avmetadatahelper, the caller can close it after this method returns.
+     * @param offset the start offset of the media in the file.
+     * @param size the size of the media in bytes, -1 means to the end of the file.
+     * @param usage indicates which scene the avmedatahelper's instance will
+     * be used to, see {@link AVMetadataUsage}.
+     * @return Returns {@link MSERR_OK} if the setting is successful; returns
+     * an error code otherwise.
+     */
+    virtual int32_t SetSource(int32_t fd, int64_t offset = 0, int64_t size = -1,
+        int32_t usage = AVMetadataUsage::AV_META_USAGE_PIXEL_MAP) = 0;
+
     /**
      * Retrieve the meta data associated with the specified key. This method must be
      * called after the SetSource.
@@ -223,6 +301,42 @@ public:
      */
     virtual sptr<PixelMap> FetchFrameAtTime(int64_t timeUs, int32_t option, PixelMapParams param) = 0;
 
+    /**
+     * Fetch the video frames at the given timestamps in one call, for example the thumbnails of
+     * the seek bar. It's much faster than calling the FetchFrameAtTime for each timestamp, the
+     * media source is prepared only once, and the frames after the same key frame are decoded
+     * forward. This method must be called after the SetSource.
+     * @param timesUs the time positions in microseconds, at most 64 positions.
+     * @param option the hint about how to fetch a frame, see {@link AVMetadataQueryOption}
+     * @param param the desired configuration of returned pixelmaps, see {@link PixelMapParams}.
+     * @return Returns the pixelmaps in the order of the given timestamps, the pixelmap is null if
+     * the frame at that timestamp cannot be fetched. Returns empty vector on failure.
+     */
+    virtual std::vector<sptr<PixelMap>> FetchFramesAtTimes(const std::vector<int64_t> &timesUs,
+        int32_t option, PixelMapParams param) = 0;
+
+    /**
+     * Scan the metadata of the given media sources in the media service, which is much cheaper than
+     * creating an avmetadatahelper for each source. The sources are scanned in parallel with the
+     * scannings of the other avmetadatahelpers, the results are reported by the callback once each
+     * of them is resolved. Only one scanning can be running for an avmetadatahelper, and it does
+     * not affect the source set by the SetSource.
+     * @param sources the media sources to be scanned, at most 512 sources.
+     * @param priority the priority of this scanning, see {@link AVMetadataScanPriority}.
+     * @param callback the callback to receive the results.
+     * @return Returns {@link MSERR_OK} if the scanning is started; returns an error code otherwise.
+     */
+    virtual int32_t ScanMetadata(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+        const std::shared_ptr<AVMetadataScanCallback> &callback) = 0;
+
+    /**
+     * Cancel the running scanning, the sources not scanned yet are dropped, and the
+     * OnScanFinished is called with the canceled flag.
+     * @return Returns {@link MSERR_OK} if the scanning is canceled or not running; returns
+     * an error code otherwise.
+     */
+    virtual int32_t CancelScan() = 0;
+
     /**
      * Release the internel resource. After this method called, the avmetadatahelper instance
      * can not be used again.
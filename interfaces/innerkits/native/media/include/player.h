@@ -69,7 +69,10 @@ enum PlayerOnInfoType : int32_t {
     /* return the message when volume changed.  */
     INFO_TYPE_VOLUME_CHANGE,
     /* return the message with extra infomation in format. */
-    INFO_TYPE_EXTRA_FORMAT
+    INFO_TYPE_EXTRA_FORMAT,
+    /* return the message when the next source starts to play, the measured gap between the end of the
+       previous source and the start of the next source in microseconds passed by "extra", -1 if unknown. */
+    INFO_TYPE_NEXT_SOURCE_START,
 };
 
 enum PlayerStates : int32_t {
@@ -102,6 +105,12 @@ enum PlayerSeekMode : int32_t {
     SEEK_CLOSEST_SYNC,
     /* seek to frames closest the time point. */
     SEEK_CLOSEST,
+    /**
+     * seek to keyframes while the seek bar is being dragged, only the latest pending target is
+     * executed and the audio is skipped. Seek with another mode at the released position to end
+     * the scrubbing, SEEK_CLOSEST is suggested.
+     */
+    SEEK_SCRUB,
 };
 
 enum PlaybackRateMode : int32_t {
@@ -165,6 +174,52 @@ public:
      */
     virtual int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc) = 0;
 
+    /**
+     * @brief Sets the playback source for the player by a file descriptor. The data is read by the media
+     * service directly, and a sub-range of the file can be played, such as a media embedded in a package.
+     *
+     * @param fd Indicates the file descriptor of a regular file opened for reading. The player does not take the
+     * ownership, the caller can close it after this function returns.
+     * @param offset Indicates the start offset of the media in the file.
+     * @param size Indicates the size of the media in bytes, -1 means to the end of the file.
+     * @return Returns {@link MSERR_OK} if the fd is set successfully; returns an error code defined
+     * in {@link media_errors.h} otherwise.
+     * @since 1.0
+     * @version 1.0
+     */
+    virtual int32_t SetSource(int32_t fd, int64_t offset = 0, int64_t size = -1) = 0;
+
+    /**
+     * @brief Sets the source to be played right after the current one without a gap, such as the next track
+     * of a playlist. The pipeline and the renderer of the current source are kept, the next source is prepared
+     * before the current one ends, and {@link INFO_TYPE_NEXT_SOURCE_START} is reported when it starts to play.
+     * The end of stream of the current source is not reported, and the looping does not take effect.
+     *
+     * This function must be called after {@link Prepare}, the next source set before is replaced if it has not
+     * been started. The media data source can not be used as the current or the next source.
+     *
+     * @param uri Indicates the next playback source.
+     * @return Returns {@link MSERR_OK} if the next source is set successfully; returns an error code defined
+     * in {@link media_errors.h} otherwise.
+     * @since 1.0
+     * @version 1.0
+     */
+    virtual int32_t SetNextSource(const std::string &uri) = 0;
+
+    /**
+     * @brief Sets the source to be played right after the current one without a gap by a file descriptor.
+     * See {@link SetNextSource} and {@link SetSource} for the details.
+     *
+     * @param fd Indicates the file descriptor of a regular file opened for reading, not owned by the player.
+     * @param offset Indicates the start offset of the media in the file.
+     * @param size Indicates the size of the media in bytes, -1 means to the end of the file.
+     * @return Returns {@link MSERR_OK} if the next source is set successfully; returns an error code defined
+     * in {@link media_errors.h} otherwise.
+     * @since 1.0
+     * @version 1.0
+     */
+    virtual int32_t SetNextSource(int32_t fd, int64_t offset = 0, int64_t size = -1) = 0;
+
     /**
      * @brief Start playback.
      *
@@ -360,6 +415,20 @@ public:
      */
     virtual int32_t SetLooping(bool loop) = 0;
 
+    /**
+     * @brief Sets the player to render the audio only, such as the player of an audio app.
+     *
+     * No video, subtitle and visualization chain is built, and the network buffering is smaller. This method
+     * must be called before {@link Prepare} or {@link PrepareAsync}, and it is kept by {@link Reset}.
+     *
+     * @param audioOnly whether the player renders the audio only.
+     * @return Returns {@link MSERR_OK} if the mode is set; returns an error code defined
+     * in {@link media_errors.h} otherwise.
+     * @since 1.0
+     * @version 1.0
+     */
+    virtual int32_t SetAudioOnly(bool audioOnly) = 0;
+
     /**
      * @brief Method to set player callback.
      *
@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmetadatahelper_bench.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "i_media_service.h"
+#include "media_errors.h"
+#include "string_ex.h"
+#ifdef AVMETADATAHELPER_BENCH_LOCAL
+#include "avmetadatahelper_engine_pool.h"
+#else
+#include "ipc_types.h"
+#include "iservice_registry.h"
+#include "system_ability_definition.h"
+#endif
+
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace std;
+
+namespace {
+    constexpr int32_t MAX_CORPUS_DEPTH = 8;
+    constexpr int64_t US_PER_MS = 1000;
+    constexpr double US_PER_SECOND = 1000000.0;
+    constexpr double MS_PER_US = 0.001;
+    constexpr double PERCENT = 100.0;
+    constexpr int64_t DEFAULT_FRAME_TIME_US = 1000000; // if the duration is unknown.
+    constexpr int32_t PERCENTILES[] = { 50, 95, 99 };
+    const vector<string> CORPUS_EXTENSIONS = { "mp4", "m4a", "mp3", "ogg", "flac", "wav" };
+    const vector<pair<int32_t, string>> QUERY_OPTIONS = {
+        { AV_META_QUERY_NEXT_SYNC, "next_sync" },
+        { AV_META_QUERY_PREVIOUS_SYNC, "previous_sync" },
+        { AV_META_QUERY_CLOSEST_SYNC, "closest_sync" },
+        { AV_META_QUERY_CLOSEST, "closest" },
+    };
+#ifdef AVMETADATAHELPER_BENCH_LOCAL
+    const string BENCH_MODE = "local";
+#else
+    const string BENCH_MODE = "ipc";
+#endif
+
+    int64_t GetCurTimeUs()
+    {
+        auto now = chrono::steady_clock::now().time_since_epoch();
+        return chrono::duration_cast<chrono::microseconds>(now).count();
+    }
+
+    bool IsCorpusFile(const string &name)
+    {
+        size_t dot = name.find_last_of('.');
+        if (dot == string::npos) {
+            return false;
+        }
+        string ext = name.substr(dot + 1);
+        transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char ch) { return tolower(ch); });
+        return find(CORPUS_EXTENSIONS.begin(), CORPUS_EXTENSIONS.end(), ext) != CORPUS_EXTENSIONS.end();
+    }
+
+    // the nearest rank percentile of the sorted samples.
+    int64_t Percentile(const vector<int64_t> &sorted, int32_t percentile)
+    {
+        size_t rank = static_cast<size_t>((percentile * sorted.size() + PERCENT - 1) / PERCENT);
+        return sorted[(rank == 0) ? 0 : rank - 1];
+    }
+
+    string EscapeJson(const string &str)
+    {
+        string escaped;
+        for (char ch : str) {
+            if (ch == '"' || ch == '\\') {
+                escaped += '\\';
+            }
+            escaped += ch;
+        }
+        return escaped;
+    }
+
+    bool CopyFile(const string &from, const string &to)
+    {
+        ifstream input(from, ios::in | ios::binary);
+        ofstream output(to, ios::out | ios::binary | ios::trunc);
+        if (!input.is_open() || !output.is_open()) {
+            return false;
+        }
+        output << input.rdbuf();
+        output.close();
+        return !output.fail();
+    }
+
+    // drop the idle engines kept by the service, so that the next source starts cold.
+    bool ClearEngines()
+    {
+#ifdef AVMETADATAHELPER_BENCH_LOCAL
+        AVMetadataHelperEnginePool::GetInstance().Clear();
+        return true;
+#else
+        auto samgr = SystemAbilityManagerClient::GetInstance().GetSystemAbilityManager();
+        if (samgr == nullptr) {
+            return false;
+        }
+        sptr<IRemoteObject> object = samgr->GetSystemAbility(OHOS::PLAYER_DISTRIBUTED_SERVICE_ID);
+        if (object == nullptr) {
+            return false;
+        }
+        int32_t fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        // the same as: hidumper -s <id> -a "avmetadata clear"
+        int32_t ret = object->Dump(fd, { u"avmetadata", u"clear" });
+        (void)close(fd);
+        return ret == ERR_NONE;
+#endif
+    }
+
+    /**
+     * The source file of one sample. The cold one is a fresh copy of the file made in the scratch
+     * directory and removed after the sample, and the idle engines are dropped before it.
+     */
+    class SampleSource {
+    public:
+        SampleSource(const string &path, const string &scratchDir, bool cold, bool &enginesCleared) : path_(path)
+        {
+            if (!cold) {
+                return;
+            }
+            static uint32_t copySeq = 0;
+            copyPath_ = scratchDir + "/.avmeta_bench_" + to_string(copySeq++) + "_" +
+                path.substr(path.find_last_of('/') + 1);
+            if (!CopyFile(path, copyPath_)) {
+                cerr << "failed to copy " << path << " to " << copyPath_ << endl;
+                valid_ = false;
+                return;
+            }
+            path_ = copyPath_;
+            if (!ClearEngines()) {
+                enginesCleared = false;
+            }
+        }
+
+        ~SampleSource()
+        {
+            if (!copyPath_.empty()) {
+                (void)unlink(copyPath_.c_str());
+            }
+        }
+
+        bool IsValid() const
+        {
+            return valid_;
+        }
+
+        const string &GetPath() const
+        {
+            return path_;
+        }
+
+        DISALLOW_COPY_AND_MOVE(SampleSource);
+
+    private:
+        string path_;
+        string copyPath_;
+        bool valid_ = true;
+    };
+
+    class ServiceHolder {
+    public:
+        ServiceHolder() : service_(MeidaServiceFactory::GetInstance().CreateAVMetadataHelperService()) {}
+        ~ServiceHolder()
+        {
+            if (service_ != nullptr) {
+                service_->Release();
+                (void)MeidaServiceFactory::GetInstance().DestroyAVMetadataHelperService(service_);
+            }
+        }
+
+        const shared_ptr<IAVMetadataHelperService> &Get() const
+        {
+            return service_;
+        }
+
+        DISALLOW_COPY_AND_MOVE(ServiceHolder);
+
+    private:
+        shared_ptr<IAVMetadataHelperService> service_;
+    };
+}
+
+int32_t AVMetadataHelperBench::Run(const Option &option)
+{
+    option_ = option;
+    if (option_.scratchDir.empty()) {
+        option_.scratchDir = option_.corpusDir;
+    }
+    files_.clear();
+    samples_.clear();
+    enginesCleared_ = true;
+    CollectCorpus(option_.corpusDir, 0);
+    sort(files_.begin(), files_.end());
+    if (files_.empty()) {
+        cerr << "no media file under " << option_.corpusDir << endl;
+        return MSERR_INVALID_VAL;
+    }
+
+    for (int32_t round = 0; round < option_.rounds; round++) {
+        bool cold = (round == 0);
+        if (round == 1) {
+            // the cold round read the copies, so the original files are not in the cache yet.
+            for (auto &path : files_) {
+                WarmUp(path);
+            }
+        }
+        string phase = cold ? "cold" : "warm";
+        for (auto &path : files_) {
+            bool hasVideo = false;
+            int64_t durationMs = -1;
+            BenchMetadata(path, phase, cold, hasVideo, durationMs);
+            if (hasVideo) {
+                BenchFrames(path, phase, cold, durationMs);
+            }
+        }
+    }
+
+    string report = ToJson();
+    cout << report;
+    if (!option_.outputPath.empty()) {
+        ofstream output(option_.outputPath, ios::out | ios::trunc);
+        output << report;
+        if (!output.good()) {
+            cerr << "failed to save the report to " << option_.outputPath << endl;
+            return MSERR_INVALID_OPERATION;
+        }
+    }
+    return MSERR_OK;
+}
+
+void AVMetadataHelperBench::CollectCorpus(const string &dir, int32_t depth)
+{
+    DIR *dirp = opendir(dir.c_str());
+    if (dirp == nullptr) {
+        cerr << "failed to open " << dir << endl;
+        return;
+    }
+
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dirp)) != nullptr) {
+        string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        string path = dir + "/" + name;
+        struct stat st = {};
+        if (stat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode) && depth < MAX_CORPUS_DEPTH) {
+            CollectCorpus(path, depth + 1);
+        } else if (S_ISREG(st.st_mode) && IsCorpusFile(name)) {
+            files_.push_back(path);
+        }
+    }
+    (void)closedir(dirp);
+}
+
+bool AVMetadataHelperBench::Measure(const string &op, const string &phase, const function<bool()> &func)
+{
+    int64_t startUs = GetCurTimeUs();
+    bool ok = func();
+    int64_t costUs = GetCurTimeUs() - startUs;
+
+    Samples &samples = samples_[{ op, phase }];
+    if (ok) {
+        samples.costUs.push_back(costUs);
+    } else {
+        samples.failedCount++;
+    }
+    return ok;
+}
+
+void AVMetadataHelperBench::WarmUp(const string &path)
+{
+    ServiceHolder holder;
+    if (holder.Get() != nullptr && holder.Get()->SetSource(path, AV_META_USAGE_META_ONLY) == MSERR_OK) {
+        (void)holder.Get()->ResolveMetadata();
+    }
+}
+
+void AVMetadataHelperBench::BenchMetadata(const string &path, const string &phase, bool cold, bool &hasVideo,
+    int64_t &durationMs)
+{
+    {
+        // a single key returns once the key is collected, measured on its own source.
+        SampleSource source(path, option_.scratchDir, cold, enginesCleared_);
+        ServiceHolder holder;
+        const auto &service = holder.Get();
+        if (source.IsValid() && service != nullptr && Measure("SetSource.meta_only.key", phase, [&]() {
+            return service->SetSource(source.GetPath(), AV_META_USAGE_META_ONLY) == MSERR_OK;
+        })) {
+            (void)Measure("ResolveMetadata.key", phase, [&]() {
+                return !service->ResolveMetadata(AV_KEY_DURATION).empty();
+            });
+        }
+    }
+
+    SampleSource source(path, option_.scratchDir, cold, enginesCleared_);
+    ServiceHolder holder;
+    const auto &service = holder.Get();
+    if (!source.IsValid() || service == nullptr || !Measure("SetSource.meta_only.all", phase, [&]() {
+        return service->SetSource(source.GetPath(), AV_META_USAGE_META_ONLY) == MSERR_OK;
+    })) {
+        return;
+    }
+    unordered_map<int32_t, string> metadata;
+    (void)Measure("ResolveMetadata.all", phase, [&]() {
+        metadata = service->ResolveMetadata();
+        return !metadata.empty();
+    });
+
+    hasVideo = metadata.count(AV_KEY_HAS_VIDEO) != 0;
+    auto it = metadata.find(AV_KEY_DURATION);
+    int32_t duration = -1;
+    if (it != metadata.end() && StrToInt(it->second, duration)) {
+        durationMs = duration;
+    }
+}
+
+void AVMetadataHelperBench::BenchFrames(const string &path, const string &phase, bool cold, int64_t durationMs)
+{
+    SampleSource source(path, option_.scratchDir, cold, enginesCleared_);
+    ServiceHolder holder;
+    const auto &service = holder.Get();
+    if (!source.IsValid() || service == nullptr || !Measure("SetSource.pixel_map", phase, [&]() {
+        return service->SetSource(source.GetPath(), AV_META_USAGE_PIXEL_MAP) == MSERR_OK;
+    })) {
+        return;
+    }
+
+    int64_t timeUs = (durationMs > 0) ? (durationMs * US_PER_MS / 2) : DEFAULT_FRAME_TIME_US; // the middle
+    OutputConfiguration param;
+    for (auto &[option, name] : QUERY_OPTIONS) {
+        (void)Measure("FetchFrameAtTime." + name, phase, [&]() {
+            return service->FetchFrameAtTime(timeUs, option, param) != nullptr;
+        });
+    }
+}
+
+string AVMetadataHelperBench::ToJson() const
+{
+    ostringstream json;
+    json << fixed << setprecision(3);
+    json << "{\n  \"corpus\": \"" << EscapeJson(option_.corpusDir) << "\",\n  \"mode\": \"" << BENCH_MODE
+         << "\",\n  \"files\": " << files_.size() << ",\n  \"rounds\": " << option_.rounds
+         << ",\n  \"engines_cleared\": " << (enginesCleared_ ? "true" : "false") << ",\n  \"results\": [";
+
+    bool first = true;
+    for (auto &[key, samples] : samples_) {
+        vector<int64_t> sorted = samples.costUs;
+        sort(sorted.begin(), sorted.end());
+        int64_t totalUs = 0;
+        for (int64_t costUs : sorted) {
+            totalUs += costUs;
+        }
+
+        json << (first ? "\n" : ",\n") << "    {\"op\": \"" << key.first << "\", \"phase\": \"" << key.second
+             << "\", \"count\": " << sorted.size() << ", \"failed\": " << samples.failedCount;
+        first = false;
+        if (!sorted.empty()) {
+            for (int32_t percentile : PERCENTILES) {
+                json << ", \"p" << percentile << "_ms\": " << Percentile(sorted, percentile) * MS_PER_US;
+            }
+            json << ", \"mean_ms\": " << totalUs * MS_PER_US / sorted.size()
+                 << ", \"max_ms\": " << sorted.back() * MS_PER_US
+                 << ", \"throughput_ops\": " << (totalUs == 0 ? 0.0 : sorted.size() * US_PER_SECOND / totalUs);
+        }
+        json << "}";
+    }
+    json << "\n  ]\n}\n";
+    return json.str();
+}
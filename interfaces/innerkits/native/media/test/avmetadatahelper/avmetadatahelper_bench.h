@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETADATAHELPER_BENCH_H
+#define AVMETADATAHELPER_BENCH_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "i_avmetadatahelper_service.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Measure the latency of the avmetadatahelper service over the media files of a local corpus,
+ * and write the percentiles and the throughput of each operation in json. The first round is
+ * reported as "cold", the following rounds as "warm".
+ *
+ * Each cold sample reads a fresh copy of the file, whose identity is never in the metadata cache,
+ * and the idle engines are dropped before it. The warm rounds follow an unmeasured round over the
+ * original files, they are served by the metadata cache and the warm engines.
+ *
+ * The service is created by the MeidaServiceFactory, so the latency is over the ipc if linked
+ * with the media_client, or in-process if linked with the media_local.
+ */
+class AVMetadataHelperBench {
+public:
+    struct Option {
+        std::string corpusDir;
+        int32_t rounds = 3;
+        std::string outputPath; // the json is also saved to it if not empty.
+        std::string scratchDir; // the cold copies are made in it, the corpus dir if empty.
+    };
+
+    AVMetadataHelperBench() = default;
+    ~AVMetadataHelperBench() = default;
+    // only the json report is written to the stdout, the errors go to the stderr.
+    int32_t Run(const Option &option);
+
+private:
+    struct Samples {
+        std::vector<int64_t> costUs;
+        int32_t failedCount = 0;
+    };
+
+    void CollectCorpus(const std::string &dir, int32_t depth);
+    void WarmUp(const std::string &path);
+    void BenchMetadata(const std::string &path, const std::string &phase, bool cold, bool &hasVideo,
+        int64_t &durationMs);
+    void BenchFrames(const std::string &path, const std::string &phase, bool cold, int64_t durationMs);
+    bool Measure(const std::string &op, const std::string &phase, const std::function<bool()> &func);
+    std::string ToJson() const;
+
+    Option option_;
+    std::vector<std::string> files_;
+    bool enginesCleared_ = true; // false if the idle engines failed to be dropped before any cold sample.
+    // the samples of each operation and phase.
+    std::map<std::pair<std::string, std::string>, Samples> samples_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETADATAHELPER_BENCH_H
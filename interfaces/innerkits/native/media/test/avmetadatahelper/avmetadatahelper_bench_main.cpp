@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include "avmetadatahelper_bench.h"
+#include "media_errors.h"
+#include "string_ex.h"
+
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace std;
+
+namespace {
+    void PrintUsage(const char *name)
+    {
+        cerr << "usage: " << name << " <corpus dir> [-r rounds] [-o json report path] [-t scratch dir]" << endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    constexpr int32_t minArgCount = 2;
+    if (argc < minArgCount) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    AVMetadataHelperBench::Option option;
+    option.corpusDir = argv[1];
+    for (int32_t i = minArgCount; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        string value = argv[++i];
+        if (arg == "-r") {
+            if (!StrToInt(value, option.rounds) || option.rounds <= 0) {
+                cerr << "invalid rounds: " << value << endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "-o") {
+            option.outputPath = value;
+        } else if (arg == "-t") {
+            option.scratchDir = value;
+        } else {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    AVMetadataHelperBench bench;
+    return (bench.Run(option) == MSERR_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -17,6 +17,7 @@
 #define MEDIA_DATA_SOURCE_NAPI_H_
 
 #include "media_data_source.h"
+#include "avsharedmemorypool.h"
 #include "callback_works.h"
 
 namespace OHOS {
@@ -43,12 +44,14 @@ private:
     static napi_value GetSize(napi_env env, napi_callback_info info);
     void SaveCallbackReference(napi_env env, const std::string &callbackName, napi_value callback);
     int32_t CheckCallbackWorks();
+    std::shared_ptr<AVSharedMemory> AcquireMem(int32_t size);
     static napi_ref constructor_;
     napi_env env_ = nullptr;
     napi_ref wrapper_ = nullptr;
     std::shared_ptr<CallbackWorks> callbackWorks_ = nullptr;
     std::shared_ptr<JsCallback> readAt_ = nullptr;
     std::shared_ptr<JsCallback> getMem_ = nullptr;
+    std::shared_ptr<AVSharedMemoryPool> memPool_ = nullptr;
     int64_t size_ = -1;
     bool noChange_ = false;
 };
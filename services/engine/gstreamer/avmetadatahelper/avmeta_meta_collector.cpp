@@ -106,13 +106,46 @@ void AVMetaMetaCollector::Stop()
 }
 
 std::unordered_map<int32_t, std::string> AVMetaMetaCollector::GetMetadata()
+{
+    bool completed = false;
+    return GetMetadata({}, completed);
+}
+
+std::unordered_map<int32_t, std::string> AVMetaMetaCollector::GetMetadata(const std::vector<int32_t> &keys,
+    bool &completed)
 {
     std::unique_lock<std::mutex> lock(mutex_);
-    cond_.wait(lock, [this]() { return CheckCollectCompleted() || stopCollecting_; });
+    cond_.wait(lock, [this, &keys]() {
+        return CheckCollectCompleted() || stopCollecting_ || CheckKeysCollected(keys);
+    });
+
+    completed = CheckCollectCompleted() || stopCollecting_;
+    if (completed) {
+        AdjustMimeType();
+        return allMeta_.tbl_;
+    }
 
-    AdjustMimeType();
+    // only the requested keys, the others may be changed by the tracks not collected yet.
+    std::unordered_map<int32_t, std::string> result;
+    for (int32_t key : keys) {
+        result[key] = allMeta_.tbl_.at(key);
+    }
+    return result;
+}
 
-    return allMeta_.tbl_;
+bool AVMetaMetaCollector::CheckKeysCollected(const std::vector<int32_t> &keys) const
+{
+    if (keys.empty()) {
+        return false;
+    }
+
+    for (int32_t key : keys) {
+        // decided by all tracks, and the absent has_audio or has_video is only known at the end.
+        if (key == AV_KEY_MIME_TYPE || key == AV_KEY_NUM_TRACKS || !allMeta_.HasMeta(key)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool AVMetaMetaCollector::CheckCollectCompleted() const
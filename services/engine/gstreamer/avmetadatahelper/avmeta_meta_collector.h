@@ -18,6 +18,7 @@
 
 #include <unordered_map>
 #include <set>
+#include <vector>
 #include <condition_variable>
 #include <mutex>
 #include <nocopyable.h>
@@ -38,6 +39,11 @@ public:
     void AddMetaSource(GstElement &source);
     void Stop();
     std::unordered_map<int32_t, std::string> GetMetadata();
+    /**
+     * Wait until the given keys are collected, or until nothing more can be collected. Only the
+     * given keys are returned if the collecting is not completed, it goes on for the later calls.
+     */
+    std::unordered_map<int32_t, std::string> GetMetadata(const std::vector<int32_t> &keys, bool &completed);
 
 private:
     uint8_t ProbeElemType(GstElement &source);
@@ -46,6 +52,7 @@ private:
     void UpdateElemBlocker(GstElement &source, uint8_t elemType);
     void UpdataMeta(int32_t trackId, const Metadata &metadata);
     bool CheckCollectCompleted() const;
+    bool CheckKeysCollected(const std::vector<int32_t> &keys) const;
     void AdjustMimeType();
     static void PadAdded(GstElement *elem, GstPad *pad, gpointer userdata);
 
@@ -0,0 +1,957 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmeta_mp4_parser.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "avmetadatahelper.h"
+#include "gst_meta_parser.h"
+#include "media_errors.h"
+#include "media_log.h"
+#include "uri_helper.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetaMp4Parser"};
+
+    constexpr uint32_t Fourcc(const char (&str)[5])
+    {
+        return (static_cast<uint32_t>(static_cast<uint8_t>(str[0])) << 24) | // 24: the first char
+            (static_cast<uint32_t>(static_cast<uint8_t>(str[1])) << 16) | // 16: the second char
+            (static_cast<uint32_t>(static_cast<uint8_t>(str[2])) << 8) | // 8: the third char
+            static_cast<uint32_t>(static_cast<uint8_t>(str[3]));
+    }
+
+    constexpr uint32_t BOX_FTYP = Fourcc("ftyp");
+    constexpr uint32_t BOX_MOOV = Fourcc("moov");
+    constexpr uint32_t BOX_MVHD = Fourcc("mvhd");
+    constexpr uint32_t BOX_MVEX = Fourcc("mvex");
+    constexpr uint32_t BOX_TRAK = Fourcc("trak");
+    constexpr uint32_t BOX_TKHD = Fourcc("tkhd");
+    constexpr uint32_t BOX_MDIA = Fourcc("mdia");
+    constexpr uint32_t BOX_HDLR = Fourcc("hdlr");
+    constexpr uint32_t BOX_MINF = Fourcc("minf");
+    constexpr uint32_t BOX_STBL = Fourcc("stbl");
+    constexpr uint32_t BOX_STSD = Fourcc("stsd");
+    constexpr uint32_t BOX_STSS = Fourcc("stss");
+    constexpr uint32_t BOX_STTS = Fourcc("stts");
+    constexpr uint32_t BOX_CTTS = Fourcc("ctts");
+    constexpr uint32_t BOX_STSC = Fourcc("stsc");
+    constexpr uint32_t BOX_STCO = Fourcc("stco");
+    constexpr uint32_t BOX_CO64 = Fourcc("co64");
+    constexpr uint32_t BOX_STSZ = Fourcc("stsz");
+    constexpr uint32_t BOX_MDHD = Fourcc("mdhd");
+    constexpr uint32_t BOX_EDTS = Fourcc("edts");
+    constexpr uint32_t BOX_ELST = Fourcc("elst");
+    constexpr uint32_t BOX_ESDS = Fourcc("esds");
+    constexpr uint32_t BOX_UDTA = Fourcc("udta");
+    constexpr uint32_t BOX_META = Fourcc("meta");
+    constexpr uint32_t BOX_ILST = Fourcc("ilst");
+    constexpr uint32_t BOX_DATA = Fourcc("data");
+    constexpr uint32_t BOX_MP4A = Fourcc("mp4a");
+    constexpr uint32_t HANDLER_VIDE = Fourcc("vide");
+    constexpr uint32_t HANDLER_SOUN = Fourcc("soun");
+    constexpr uint32_t HANDLER_TEXT = Fourcc("text");
+    constexpr uint32_t HANDLER_SBTL = Fourcc("sbtl");
+    constexpr uint32_t HANDLER_SUBT = Fourcc("subt");
+
+    constexpr size_t BOX_HEADER_SIZE = 8;
+    constexpr size_t LARGE_BOX_HEADER_SIZE = 16;
+    constexpr size_t FULL_BOX_HEADER_SIZE = 4;
+    constexpr size_t MAX_LEAF_BOX_SIZE = 1024; // the leaf boxes read are small, the longer strings are cut.
+    constexpr int32_t MAX_CHILD_BOXES = 256;
+    constexpr int32_t MAX_TOP_LEVEL_BOXES = 64;
+    constexpr int32_t MAX_TRACKS = 64;
+    constexpr int64_t MS_PER_SECOND = 1000;
+    constexpr int64_t US_PER_SECOND = 1000000;
+    constexpr uint32_t MAX_INDEX_SAMPLES = 4 * 1024 * 1024; // the tables are walked up to the last sync sample.
+    constexpr size_t TABLE_BLOCK_SIZE = 4096;
+
+    // the ilst items of the itunes metadata, and the 3gpp asset boxes in the udta.
+    const std::unordered_map<uint32_t, int32_t> ILST_ITEM_TO_KEY = {
+        { Fourcc("\xa9nam"), OHOS::Media::AV_KEY_TITLE },
+        { Fourcc("\xa9" "ART"), OHOS::Media::AV_KEY_ARTIST },
+        { Fourcc("aART"), OHOS::Media::AV_KEY_ALBUM_ARTIST },
+        { Fourcc("\xa9" "alb"), OHOS::Media::AV_KEY_ALBUM },
+        { Fourcc("\xa9wrt"), OHOS::Media::AV_KEY_COMPOSER },
+        { Fourcc("\xa9gen"), OHOS::Media::AV_KEY_GENRE },
+    };
+
+    const std::unordered_map<uint32_t, int32_t> UDTA_ASSET_TO_KEY = {
+        { Fourcc("titl"), OHOS::Media::AV_KEY_TITLE },
+        { Fourcc("perf"), OHOS::Media::AV_KEY_ARTIST },
+        { Fourcc("auth"), OHOS::Media::AV_KEY_COMPOSER },
+        { Fourcc("albm"), OHOS::Media::AV_KEY_ALBUM },
+        { Fourcc("gnre"), OHOS::Media::AV_KEY_GENRE },
+    };
+
+    // the time in the timescale to us, false if it overflows, the tables of a broken file may be so.
+    bool ScaleToUs(int64_t time, int64_t timescale, int64_t &us)
+    {
+        int64_t secondsUs = 0;
+        int64_t remainderUs = (time % timescale) * US_PER_SECOND / timescale;
+        return !__builtin_mul_overflow(time / timescale, US_PER_SECOND, &secondsUs) &&
+            !__builtin_add_overflow(secondsUs, remainderUs, &us);
+    }
+
+    const int32_t AAC_SAMPLE_RATES[] = {
+        96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350
+    };
+
+    inline uint16_t GetU16(const uint8_t *buf)
+    {
+        return static_cast<uint16_t>((buf[0] << 8) | buf[1]); // 8: big endian
+    }
+
+    inline uint32_t GetU32(const uint8_t *buf)
+    {
+        return (static_cast<uint32_t>(GetU16(buf)) << 16) | GetU16(buf + 2); // 16, 2: big endian
+    }
+
+    inline uint64_t GetU64(const uint8_t *buf)
+    {
+        return (static_cast<uint64_t>(GetU32(buf)) << 32) | GetU32(buf + 4); // 32, 4: big endian
+    }
+
+    // the size of mpeg4 descriptor is encoded in 1 to 4 bytes, 7 bits each.
+    bool ReadDescriptor(const uint8_t *&pos, const uint8_t *end, uint8_t &tag, uint32_t &size)
+    {
+        if (pos >= end) {
+            return false;
+        }
+        tag = *pos++;
+        size = 0;
+        for (int32_t i = 0; i < 4; i++) { // 4: at most 4 bytes
+            if (pos >= end) {
+                return false;
+            }
+            uint8_t byte = *pos++;
+            size = (size << 7) | (byte & 0x7F); // 7 bits each
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        return size <= static_cast<uint32_t>(end - pos);
+    }
+}
+
+namespace OHOS {
+namespace Media {
+AVMetaMp4Parser::~AVMetaMp4Parser()
+{
+    if (ownFd_ && fd_ >= 0) {
+        (void)::close(fd_);
+        fd_ = -1;
+    }
+}
+
+int32_t AVMetaMp4Parser::Parse(const std::string &uri, std::unordered_map<int32_t, std::string> &metadata)
+{
+    int32_t ret = ParseFile(uri);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    FillMetadata(metadata);
+    return MSERR_OK;
+}
+
+int32_t AVMetaMp4Parser::BuildSyncIndex(const std::string &uri, std::vector<AVMetaSyncSample> &index)
+{
+    int32_t ret = ParseFile(uri);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+    CHECK_AND_RETURN_RET_LOG(hasVideo_, MSERR_UNSUPPORT, "no video track");
+
+    return BuildSyncIndexFromTables(index);
+}
+
+int32_t AVMetaMp4Parser::ParseFile(const std::string &uri)
+{
+    int32_t ret = OpenSource(uri);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    Box box;
+    CHECK_AND_RETURN_RET(ReadBox(start_, end_, box) && box.type == BOX_FTYP, MSERR_UNSUPPORT);
+    uint8_t brand[4] = {0}; // 4: the major brand
+    CHECK_AND_RETURN_RET(ReadAt(box.payload, brand, sizeof(brand)), MSERR_UNSUPPORT);
+    majorBrand_ = GetU32(brand);
+
+    int64_t pos = box.end;
+    for (int32_t count = 0; count < MAX_TOP_LEVEL_BOXES && pos < end_; count++) {
+        CHECK_AND_RETURN_RET_LOG(ReadBox(pos, end_, box), MSERR_UNSUPPORT, "invalid box at %{public}" PRIi64, pos);
+        if (box.type == BOX_MOOV) {
+            return ParseMoov(box);
+        }
+        pos = box.end;
+    }
+
+    MEDIA_LOGW("no moov found");
+    return MSERR_UNSUPPORT;
+}
+
+int32_t AVMetaMp4Parser::OpenSource(const std::string &uri)
+{
+    UriHelper uriHelper(uri);
+    uriHelper.FormatMe();
+
+    if (uriHelper.UriType() == UriHelper::URI_TYPE_FD) {
+        fd_ = uriHelper.GetFd();
+        start_ = uriHelper.GetOffset();
+        end_ = uriHelper.GetSize() < 0 ? -1 : start_ + uriHelper.GetSize();
+    } else if (uriHelper.UriType() == UriHelper::URI_TYPE_FILE) {
+        static const std::string fileHead = "file://";
+        std::string path = uriHelper.FormattedUri().substr(fileHead.size());
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        ownFd_ = true;
+        start_ = 0;
+        end_ = -1;
+    }
+    CHECK_AND_RETURN_RET(fd_ >= 0, MSERR_UNSUPPORT);
+
+    struct stat64 st = {};
+    CHECK_AND_RETURN_RET(fstat64(fd_, &st) == 0 && S_ISREG(st.st_mode), MSERR_UNSUPPORT);
+    if (end_ < 0 || end_ > st.st_size) {
+        end_ = st.st_size;
+    }
+    CHECK_AND_RETURN_RET(start_ >= 0 && start_ < end_, MSERR_UNSUPPORT);
+    return MSERR_OK;
+}
+
+bool AVMetaMp4Parser::ReadAt(int64_t pos, void *buf, size_t len)
+{
+    if (pos < start_ || pos > end_ || static_cast<int64_t>(len) > end_ - pos) {
+        return false;
+    }
+    return ::pread64(fd_, buf, len, pos) == static_cast<ssize_t>(len);
+}
+
+bool AVMetaMp4Parser::ReadBox(int64_t pos, int64_t limit, Box &box)
+{
+    uint8_t header[LARGE_BOX_HEADER_SIZE];
+    if (limit - pos < static_cast<int64_t>(BOX_HEADER_SIZE) || !ReadAt(pos, header, BOX_HEADER_SIZE)) {
+        return false;
+    }
+
+    uint64_t size = GetU32(header);
+    box.type = GetU32(header + 4); // 4: the type follows the size
+    box.payload = pos + static_cast<int64_t>(BOX_HEADER_SIZE);
+    if (size == 1) {
+        if (!ReadAt(pos + BOX_HEADER_SIZE, header + BOX_HEADER_SIZE, LARGE_BOX_HEADER_SIZE - BOX_HEADER_SIZE)) {
+            return false;
+        }
+        size = GetU64(header + BOX_HEADER_SIZE);
+        box.payload = pos + static_cast<int64_t>(LARGE_BOX_HEADER_SIZE);
+    } else if (size == 0) {
+        size = static_cast<uint64_t>(limit - pos); // extends to the end of the container.
+    }
+
+    if (size < static_cast<uint64_t>(box.payload - pos) || size > static_cast<uint64_t>(limit - pos)) {
+        return false;
+    }
+    box.end = pos + static_cast<int64_t>(size);
+    return true;
+}
+
+bool AVMetaMp4Parser::ReadPayload(const Box &box, uint8_t *buf, size_t minLen, size_t &len)
+{
+    int64_t payloadSize = box.end - box.payload;
+    if (payloadSize < static_cast<int64_t>(minLen)) {
+        return false;
+    }
+    len = payloadSize > static_cast<int64_t>(MAX_LEAF_BOX_SIZE) ? MAX_LEAF_BOX_SIZE : static_cast<size_t>(payloadSize);
+    return ReadAt(box.payload, buf, len);
+}
+
+int32_t AVMetaMp4Parser::ParseMoov(const Box &moov)
+{
+    bool hasMvhd = false;
+    int64_t pos = moov.payload;
+    Box box;
+    for (int32_t count = 0; count < MAX_CHILD_BOXES && ReadBox(pos, moov.end, box); count++) {
+        pos = box.end;
+        switch (box.type) {
+            case BOX_MVHD:
+                hasMvhd = ParseMvhd(box);
+                break;
+            case BOX_MVEX:
+                // the duration and the samples are in the fragments.
+                MEDIA_LOGI("fragmented file, not supported");
+                return MSERR_UNSUPPORT;
+            case BOX_TRAK:
+                CHECK_AND_RETURN_RET(ParseTrak(box), MSERR_UNSUPPORT);
+                break;
+            case BOX_UDTA:
+                ParseUdta(box);
+                break;
+            default:
+                break;
+        }
+    }
+
+    CHECK_AND_RETURN_RET_LOG(hasMvhd && durationMs_ > 0, MSERR_UNSUPPORT, "no duration");
+    CHECK_AND_RETURN_RET_LOG(hasVideo_ || hasAudio_, MSERR_UNSUPPORT, "no audio or video track");
+    return MSERR_OK;
+}
+
+bool AVMetaMp4Parser::ParseMvhd(const Box &box)
+{
+    uint8_t buf[MAX_LEAF_BOX_SIZE];
+    size_t len = 0;
+    // version 0: fullbox(4) creation(4) modification(4) timescale(4) duration(4)
+    // version 1: fullbox(4) creation(8) modification(8) timescale(4) duration(8)
+    constexpr size_t mvhdV0Size = 20;
+    constexpr size_t mvhdV1Size = 32;
+    CHECK_AND_RETURN_RET(ReadPayload(box, buf, mvhdV0Size, len), false);
+
+    uint32_t timescale = 0;
+    uint64_t duration = 0;
+    if (buf[0] == 1) {
+        CHECK_AND_RETURN_RET(len >= mvhdV1Size, false);
+        timescale = GetU32(buf + 20); // 20: the offset of timescale in version 1
+        duration = GetU64(buf + 24); // 24: the offset of duration in version 1
+    } else {
+        timescale = GetU32(buf + 12); // 12: the offset of timescale in version 0
+        duration = GetU32(buf + 16); // 16: the offset of duration in version 0
+        duration = (duration == UINT32_MAX) ? 0 : duration;
+    }
+    CHECK_AND_RETURN_RET(timescale != 0 && duration != UINT64_MAX, false);
+    movieTimescale_ = timescale;
+
+    // round to the nearest millisecond, the same as the pipeline.
+    uint64_t seconds = duration / timescale;
+    uint64_t remainder = duration % timescale;
+    durationMs_ = static_cast<int64_t>(seconds * MS_PER_SECOND +
+        (remainder * MS_PER_SECOND + timescale / 2) / timescale); // 2: round
+    return true;
+}
+
+bool AVMetaMp4Parser::ParseTrak(const Box &trak)
+{
+    CHECK_AND_RETURN_RET_LOG(trackCount_ < MAX_TRACKS, false, "too many tracks");
+
+    TrackInfo track;
+    int64_t pos = trak.payload;
+    Box box;
+    for (int32_t count = 0; count < MAX_CHILD_BOXES && ReadBox(pos, trak.end, box); count++) {
+        pos = box.end;
+        if (box.type == BOX_TKHD) {
+            ParseTkhd(box, track);
+        } else if (box.type == BOX_EDTS) {
+            ParseEdts(box, track);
+        } else if (box.type == BOX_MDIA) {
+            ParseMdia(box, track);
+        }
+    }
+
+    // the stsd is parsed after the hdlr, its layout depends on the handler type.
+    if (track.hasSampleDesc) {
+        ParseStsd(track);
+    }
+
+    switch (track.handler) {
+        case HANDLER_VIDE:
+            if (!hasVideo_) {
+                width_ = track.width;
+                height_ = track.height;
+                videoTrack_ = track;
+            }
+            hasVideo_ = true;
+            break;
+        case HANDLER_SOUN:
+            if (!hasAudio_) {
+                sampleRate_ = track.sampleRate;
+            }
+            hasAudio_ = true;
+            break;
+        case HANDLER_TEXT:
+        case HANDLER_SBTL:
+        case HANDLER_SUBT:
+            break;
+        default:
+            return true; // the hint and the timecode tracks are not exposed.
+    }
+    trackCount_++;
+    return true;
+}
+
+void AVMetaMp4Parser::ParseTkhd(const Box &box, TrackInfo &track)
+{
+    uint8_t buf[MAX_LEAF_BOX_SIZE];
+    size_t len = 0;
+    // the width and height are 16.16 fixed point at the end, after the matrix.
+    constexpr size_t tkhdV0Size = 84;
+    constexpr size_t tkhdV1Size = 96;
+    if (!ReadPayload(box, buf, tkhdV0Size, len)) {
+        return;
+    }
+    size_t sizeOffset = (buf[0] == 1) ? tkhdV1Size - 8 : tkhdV0Size - 8; // 8: width and height
+    if (len < sizeOffset + 8) { // 8: width and height
+        return;
+    }
+    track.width = static_cast<int32_t>(GetU32(buf + sizeOffset) >> 16); // 16: fixed point 16.16
+    track.height = static_cast<int32_t>(GetU32(buf + sizeOffset + 4) >> 16); // 4, 16: the height, 16.16
+}
+
+void AVMetaMp4Parser::ParseEdts(const Box &edts, TrackInfo &track)
+{
+    Box elst;
+    if (!ReadBox(edts.payload, edts.end, elst) || elst.type != BOX_ELST) {
+        return;
+    }
+
+    uint8_t buf[MAX_LEAF_BOX_SIZE];
+    size_t len = 0;
+    constexpr size_t elstHeaderSize = 8; // fullbox(4) entry_count(4)
+    if (!ReadPayload(elst, buf, elstHeaderSize, len)) {
+        return;
+    }
+
+    // version 0: segment_duration(4) media_time(4) media_rate(4), version 1: (8) (8) (4)
+    bool isV1 = buf[0] == 1;
+    size_t entrySize = isV1 ? 20 : 12; // 20, 12: the entry size of version 1 and 0
+    uint32_t entryCount = GetU32(buf + FULL_BOX_HEADER_SIZE);
+    const uint8_t *entry = buf + elstHeaderSize;
+    // the leading empty edits delay the presentation, the first normal edit gives the start in the media.
+    for (uint32_t i = 0; i < entryCount && entry + entrySize <= buf + len; i++, entry += entrySize) {
+        int64_t duration = isV1 ? static_cast<int64_t>(GetU64(entry)) : GetU32(entry);
+        int64_t mediaTime = isV1 ? static_cast<int64_t>(GetU64(entry + 8)) : // 8: after the duration
+            static_cast<int32_t>(GetU32(entry + 4)); // 4: after the duration
+        if (mediaTime != -1) {
+            track.editMediaTime = mediaTime;
+            return;
+        }
+        if (duration < 0 || __builtin_add_overflow(track.editEmptyDuration, duration, &track.editEmptyDuration)) {
+            // rejected when the sample time is converted.
+            track.editEmptyDuration = INT64_MAX;
+            return;
+        }
+    }
+}
+
+void AVMetaMp4Parser::ParseMdia(const Box &mdia, TrackInfo &track)
+{
+    int64_t pos = mdia.payload;
+    Box box;
+    for (int32_t count = 0; count < MAX_CHILD_BOXES && ReadBox(pos, mdia.end, box); count++) {
+        pos = box.end;
+        if (box.type == BOX_HDLR) {
+            uint8_t buf[12]; // 12: fullbox(4) pre_defined(4) handler_type(4)
+            if (box.end - box.payload >= static_cast<int64_t>(sizeof(buf)) && ReadAt(box.payload, buf, sizeof(buf))) {
+                track.handler = GetU32(buf + 8); // 8: the offset of handler_type
+            }
+        } else if (box.type == BOX_MDHD) {
+            ParseMdhd(box, track);
+        } else if (box.type == BOX_MINF) {
+            int64_t minfPos = box.payload;
+            Box stbl;
+            for (int32_t i = 0; i < MAX_CHILD_BOXES && ReadBox(minfPos, box.end, stbl); i++) {
+                minfPos = stbl.end;
+                if (stbl.type == BOX_STBL) {
+                    ParseStbl(stbl, track);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void AVMetaMp4Parser::ParseMdhd(const Box &box, TrackInfo &track)
+{
+    // version 0: fullbox(4) creation(4) modification(4) timescale(4), version 1: (4) (8) (8) (4)
+    uint8_t buf[24]; // 24: up to the timescale of version 1
+    int64_t payloadSize = box.end - box.payload;
+    size_t len = payloadSize > static_cast<int64_t>(sizeof(buf)) ? sizeof(buf) : static_cast<size_t>(payloadSize);
+    if (len < 16 || !ReadAt(box.payload, buf, len)) { // 16: up to the timescale of version 0
+        return;
+    }
+    if (buf[0] == 1) {
+        track.mediaTimescale = (len >= sizeof(buf)) ? GetU32(buf + 20) : 0; // 20: the offset of version 1
+    } else {
+        track.mediaTimescale = GetU32(buf + 12); // 12: the offset of version 0
+    }
+}
+
+void AVMetaMp4Parser::ParseStbl(const Box &stbl, TrackInfo &track)
+{
+    // only the positions are recorded, the tables are read when building the index.
+    int64_t pos = stbl.payload;
+    Box box;
+    for (int32_t count = 0; count < MAX_CHILD_BOXES && ReadBox(pos, stbl.end, box); count++) {
+        pos = box.end;
+        switch (box.type) {
+            case BOX_STSD:
+                track.sampleDesc = box;
+                track.hasSampleDesc = true;
+                break;
+            case BOX_STSS:
+                track.stss = box;
+                break;
+            case BOX_STTS:
+                track.stts = box;
+                break;
+            case BOX_CTTS:
+                track.ctts = box;
+                break;
+            case BOX_STSC:
+                track.stsc = box;
+                break;
+            case BOX_STCO:
+            case BOX_CO64:
+                track.stco = box;
+                track.isCo64 = box.type == BOX_CO64;
+                break;
+            case BOX_STSZ:
+                track.stsz = box;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void AVMetaMp4Parser::ParseStsd(TrackInfo &track)
+{
+    // fullbox(4) entry_count(4), then the first sample entry.
+    constexpr int64_t stsdHeaderSize = 8;
+    Box entry;
+    if (!ReadBox(track.sampleDesc.payload + stsdHeaderSize, track.sampleDesc.end, entry)) {
+        return;
+    }
+
+    if (track.handler == HANDLER_VIDE) {
+        // reserved(6) data_reference_index(2) pre_defined(2) reserved(2) pre_defined(12) width(2) height(2)
+        uint8_t buf[28];
+        if (entry.end - entry.payload >= static_cast<int64_t>(sizeof(buf)) && ReadAt(entry.payload, buf, sizeof(buf))) {
+            track.width = GetU16(buf + 24); // 24: the offset of width
+            track.height = GetU16(buf + 26); // 26: the offset of height
+        }
+    } else if (track.handler == HANDLER_SOUN) {
+        ParseAudioSampleEntry(entry, track);
+    }
+}
+
+void AVMetaMp4Parser::ParseAudioSampleEntry(const Box &entry, TrackInfo &track)
+{
+    uint8_t buf[64]; // 64: the size of the version 2 sound sample description
+    constexpr size_t soundV0Size = 28;
+    constexpr size_t soundV1Size = 44;
+    constexpr size_t soundV2Size = 64;
+    int64_t entrySize = entry.end - entry.payload;
+    size_t len = entrySize > static_cast<int64_t>(sizeof(buf)) ? sizeof(buf) : static_cast<size_t>(entrySize);
+    if (len < soundV0Size || !ReadAt(entry.payload, buf, len)) {
+        return;
+    }
+
+    // reserved(6) data_reference_index(2) version(2) revision(2) vendor(4) channels(2) sample_size(2)
+    // compression_id(2) packet_size(2) sample_rate(4, 16.16), the version 1 and 2 are of quicktime.
+    uint16_t version = GetU16(buf + 8); // 8: the offset of version
+    size_t childOffset = soundV0Size;
+    if (version == 1) {
+        childOffset = soundV1Size;
+    } else if (version == 2) { // 2: the sample rate is a float64 at offset 32
+        if (len < soundV2Size) {
+            return;
+        }
+        uint64_t bits = GetU64(buf + 32); // 32: the offset of the float64 sample rate
+        double rate = 0;
+        static_assert(sizeof(rate) == sizeof(bits), "double must be 64 bits");
+        (void)memcpy(&rate, &bits, sizeof(rate));
+        // the rate is read from the file, nan and the out of range ones are dropped before the cast.
+        if (rate >= 0 && rate <= static_cast<double>(INT32_MAX)) {
+            track.sampleRate = static_cast<int32_t>(rate);
+        }
+        childOffset = soundV2Size;
+    }
+    if (version != 2) { // 2: the sample rate of version 2 is got above
+        track.sampleRate = static_cast<int32_t>(GetU32(buf + 24) >> 16); // 24, 16: the offset, 16.16
+    }
+
+    // the rate in the sample entry is only 16 bits, the aac config has the actual one.
+    if (entry.type != BOX_MP4A) {
+        return;
+    }
+    int64_t pos = entry.payload + static_cast<int64_t>(childOffset);
+    Box box;
+    for (int32_t count = 0; count < MAX_CHILD_BOXES && ReadBox(pos, entry.end, box); count++) {
+        pos = box.end;
+        if (box.type == BOX_ESDS) {
+            ParseEsds(box, track);
+            return;
+        }
+    }
+}
+
+void AVMetaMp4Parser::ParseEsds(const Box &esds, TrackInfo &track)
+{
+    uint8_t buf[MAX_LEAF_BOX_SIZE];
+    size_t len = 0;
+    if (!ReadPayload(esds, buf, FULL_BOX_HEADER_SIZE, len)) {
+        return;
+    }
+
+    constexpr uint8_t esDescrTag = 0x03;
+    constexpr uint8_t decoderConfigDescrTag = 0x04;
+    constexpr uint8_t decSpecificInfoTag = 0x05;
+    constexpr uint8_t objectTypeMpeg4Audio = 0x40;
+    constexpr uint8_t objectTypeMpeg2AacMain = 0x66;
+    constexpr uint8_t objectTypeMpeg2AacSsr = 0x68;
+    const uint8_t *pos = buf + FULL_BOX_HEADER_SIZE;
+    const uint8_t *end = buf + len;
+    uint8_t tag = 0;
+    uint32_t size = 0;
+
+    // ES_ID(2) flags(1), and the optional fields indicated by the flags.
+    if (!ReadDescriptor(pos, end, tag, size) || tag != esDescrTag || size < 3) { // 3: ES_ID and flags
+        return;
+    }
+    uint8_t flags = pos[2]; // 2: the offset of flags
+    pos += 3; // 3: ES_ID and flags
+    if ((flags & 0x80) != 0) { // 0x80: streamDependenceFlag
+        pos += 2; // 2: dependsOn_ES_ID
+    }
+    if ((flags & 0x40) != 0 && pos < end) { // 0x40: URL_Flag
+        pos += 1 + *pos;
+    }
+    if ((flags & 0x20) != 0) { // 0x20: OCRstreamFlag
+        pos += 2; // 2: OCR_ES_Id
+    }
+
+    // objectTypeIndication(1) streamType(1) bufferSizeDB(3) maxBitrate(4) avgBitrate(4)
+    constexpr uint32_t decoderConfigSize = 13;
+    if (pos >= end || !ReadDescriptor(pos, end, tag, size) || tag != decoderConfigDescrTag ||
+        size < decoderConfigSize) {
+        return;
+    }
+    uint8_t objectType = pos[0];
+    if (objectType != objectTypeMpeg4Audio && (objectType < objectTypeMpeg2AacMain ||
+        objectType > objectTypeMpeg2AacSsr)) {
+        return;
+    }
+    pos += decoderConfigSize;
+    if (!ReadDescriptor(pos, end, tag, size) || tag != decSpecificInfoTag || size < 2) { // 2: the minimal config
+        return;
+    }
+
+    // AudioSpecificConfig: audioObjectType(5, 6 more bits if escaped) samplingFrequencyIndex(4)
+    uint32_t bits = (static_cast<uint32_t>(pos[0]) << 24) | (static_cast<uint32_t>(pos[1]) << 16); // 24, 16: msb
+    bits |= (size > 2 ? static_cast<uint32_t>(pos[2]) << 8 : 0); // 2, 8: the third byte
+    bits |= (size > 3 ? static_cast<uint32_t>(pos[3]) : 0); // 3: the fourth byte
+    uint32_t bitPos = 5; // 5: audioObjectType
+    if ((bits >> 27) == 31) { // 27, 31: the escaped object type
+        bitPos += 6; // 6: audioObjectTypeExt
+    }
+    uint32_t index = (bits >> (32 - bitPos - 4)) & 0xF; // 32, 4: the 4 bits index
+    if (index < sizeof(AAC_SAMPLE_RATES) / sizeof(AAC_SAMPLE_RATES[0])) {
+        track.sampleRate = AAC_SAMPLE_RATES[index];
+    } else if (index == 0xF && bitPos == 5 && size >= 5) { // 5: the explicit 24 bits rate follows
+        uint64_t rateBits = (static_cast<uint64_t>(bits) << 8) | pos[4]; // 8, 4: the fifth byte
+        track.sampleRate = static_cast<int32_t>((rateBits >> 7) & 0xFFFFFF); // 7: 5 + 4 + 24 = 33 bits, 40 - 33
+    }
+}
+
+void AVMetaMp4Parser::ParseUdta(const Box &udta)
+{
+    int64_t pos = udta.payload;
+    Box box;
+    for (int32_t count = 0; count < MAX_CHILD_BOXES && ReadBox(pos, udta.end, box); count++) {
+        pos = box.end;
+        auto assetIt = UDTA_ASSET_TO_KEY.find(box.type);
+        if (assetIt != UDTA_ASSET_TO_KEY.end()) {
+            ParseStringItem(box, assetIt->second, false);
+            continue;
+        }
+        if (box.type != BOX_META) {
+            continue;
+        }
+
+        // the meta is a fullbox in the iso files, but not in the quicktime files.
+        int64_t metaPos = box.payload;
+        uint8_t head[4] = {0}; // 4: version and flags
+        if (ReadAt(metaPos, head, sizeof(head)) && GetU32(head) == 0) {
+            metaPos += FULL_BOX_HEADER_SIZE;
+        }
+        Box child;
+        for (int32_t i = 0; i < MAX_CHILD_BOXES && ReadBox(metaPos, box.end, child); i++) {
+            metaPos = child.end;
+            if (child.type == BOX_ILST) {
+                ParseIlst(child);
+                break;
+            }
+        }
+    }
+}
+
+void AVMetaMp4Parser::ParseIlst(const Box &ilst)
+{
+    int64_t pos = ilst.payload;
+    Box item;
+    for (int32_t count = 0; count < MAX_CHILD_BOXES && ReadBox(pos, ilst.end, item); count++) {
+        pos = item.end;
+        auto it = ILST_ITEM_TO_KEY.find(item.type);
+        if (it == ILST_ITEM_TO_KEY.end()) {
+            continue;
+        }
+        Box data;
+        if (ReadBox(item.payload, item.end, data) && data.type == BOX_DATA) {
+            ParseStringItem(data, it->second, true);
+        }
+    }
+}
+
+void AVMetaMp4Parser::ParseStringItem(const Box &item, int32_t key, bool isIlst)
+{
+    uint8_t buf[MAX_LEAF_BOX_SIZE];
+    size_t len = 0;
+    size_t valueOffset = 0;
+    if (isIlst) {
+        // type(4) locale(4), only the utf-8 text is taken.
+        constexpr size_t dataHeaderSize = 8;
+        constexpr uint32_t utf8Type = 1;
+        if (!ReadPayload(item, buf, dataHeaderSize, len) || (GetU32(buf) & 0xFFFFFF) != utf8Type) {
+            return;
+        }
+        valueOffset = dataHeaderSize;
+    } else {
+        // fullbox(4) language(2), the utf-16 string starts with the BOM, it's not taken.
+        constexpr size_t assetHeaderSize = 6;
+        if (!ReadPayload(item, buf, assetHeaderSize, len) ||
+            (len >= assetHeaderSize + 2 && GetU16(buf + assetHeaderSize) == 0xFEFF)) { // 2: the BOM
+            return;
+        }
+        valueOffset = assetHeaderSize;
+    }
+
+    const char *value = reinterpret_cast<const char *>(buf + valueOffset);
+    size_t valueLen = strnlen(value, len - valueOffset);
+    if (valueLen == 0 || tags_.count(key) != 0) {
+        return; // the ilst item is preferred, it's parsed before the asset boxes normally.
+    }
+    tags_.emplace(key, std::string(value, valueLen));
+}
+
+// read the entries of a sample table sequentially, one block by one pread.
+class AVMetaMp4Parser::TableReader {
+public:
+    // the entry count is at countOffset of the payload, and the entries follow it.
+    TableReader(AVMetaMp4Parser &parser, const Box &box, size_t countOffset, size_t entrySize)
+        : parser_(parser), entrySize_(entrySize)
+    {
+        uint8_t buf[4] = {0}; // 4: the entry count
+        int64_t entriesPos = box.payload + static_cast<int64_t>(countOffset + sizeof(buf));
+        if (box.type == 0 || entriesPos > box.end || !parser_.ReadAt(entriesPos - sizeof(buf), buf, sizeof(buf))) {
+            return;
+        }
+        uint32_t count = GetU32(buf);
+        if (static_cast<uint64_t>(count) * entrySize_ > static_cast<uint64_t>(box.end - entriesPos)) {
+            return;
+        }
+        valid_ = true;
+        count_ = count;
+        pos_ = entriesPos;
+    }
+    ~TableReader() = default;
+
+    bool IsValid() const
+    {
+        return valid_;
+    }
+
+    uint32_t GetCount() const
+    {
+        return count_;
+    }
+
+    const uint8_t *Next()
+    {
+        if (index_ >= count_) {
+            return nullptr;
+        }
+        if (bufPos_ + entrySize_ > bufLen_) {
+            uint64_t left = static_cast<uint64_t>(count_ - index_) * entrySize_;
+            size_t len = (TABLE_BLOCK_SIZE / entrySize_) * entrySize_;
+            len = left < len ? static_cast<size_t>(left) : len;
+            if (!parser_.ReadAt(pos_, buf_, len)) {
+                count_ = 0;
+                return nullptr;
+            }
+            pos_ += static_cast<int64_t>(len);
+            bufLen_ = len;
+            bufPos_ = 0;
+        }
+        const uint8_t *entry = buf_ + bufPos_;
+        bufPos_ += entrySize_;
+        index_++;
+        return entry;
+    }
+
+    DISALLOW_COPY_AND_MOVE(TableReader);
+
+private:
+    AVMetaMp4Parser &parser_;
+    size_t entrySize_;
+    bool valid_ = false;
+    uint32_t count_ = 0;
+    uint32_t index_ = 0;
+    int64_t pos_ = 0;
+    uint8_t buf_[TABLE_BLOCK_SIZE];
+    size_t bufLen_ = 0;
+    size_t bufPos_ = 0;
+};
+
+bool AVMetaMp4Parser::ToPtsUs(int64_t mediaTime, int64_t &ptsUs) const
+{
+    const TrackInfo &track = videoTrack_;
+    int64_t time = 0;
+    if (__builtin_sub_overflow(mediaTime, track.editMediaTime, &time) ||
+        !ScaleToUs(time, track.mediaTimescale, ptsUs)) {
+        return false;
+    }
+    if (movieTimescale_ == 0) {
+        return true;
+    }
+    int64_t emptyUs = 0;
+    return ScaleToUs(track.editEmptyDuration, movieTimescale_, emptyUs) &&
+        !__builtin_add_overflow(ptsUs, emptyUs, &ptsUs);
+}
+
+int32_t AVMetaMp4Parser::BuildSyncIndexFromTables(std::vector<AVMetaSyncSample> &index)
+{
+    const TrackInfo &track = videoTrack_;
+    CHECK_AND_RETURN_RET_LOG(track.mediaTimescale != 0, MSERR_UNSUPPORT, "no media timescale");
+
+    // stss/stts/ctts/stsc/stco: fullbox(4) entry_count(4), stsz: fullbox(4) sample_size(4) sample_count(4)
+    constexpr size_t countOffset = 4;
+    constexpr size_t stszCountOffset = 8;
+    TableReader stss(*this, track.stss, countOffset, 4); // 4: sample_number
+    TableReader stts(*this, track.stts, countOffset, 8); // 8: sample_count sample_delta
+    TableReader ctts(*this, track.ctts, countOffset, 8); // 8: sample_count sample_offset
+    TableReader stsc(*this, track.stsc, countOffset, 12); // 12: first_chunk samples_per_chunk desc_index
+    TableReader stco(*this, track.stco, countOffset, track.isCo64 ? 8 : 4); // 8, 4: chunk_offset
+    TableReader stsz(*this, track.stsz, stszCountOffset, 4); // 4: entry_size
+    // all samples are sync samples without the stss, the index is no better than the key unit seeking.
+    CHECK_AND_RETURN_RET_LOG(stss.IsValid() && stts.IsValid() && stsc.IsValid() && stco.IsValid() &&
+        stsz.IsValid(), MSERR_UNSUPPORT, "incomplete sample tables");
+    bool hasCtts = ctts.IsValid();
+
+    uint8_t sizeBuf[4] = {0}; // 4: sample_size, not 0 if all samples are the same size
+    CHECK_AND_RETURN_RET(ReadAt(track.stsz.payload + FULL_BOX_HEADER_SIZE, sizeBuf, sizeof(sizeBuf)),
+        MSERR_UNSUPPORT);
+    uint32_t uniformSize = GetU32(sizeBuf);
+    uint32_t sampleCount = stsz.GetCount();
+    if (uniformSize != 0) {
+        uint8_t countBuf[4] = {0}; // 4: sample_count, there is no entry for the uniform size
+        CHECK_AND_RETURN_RET(ReadAt(track.stsz.payload + stszCountOffset, countBuf, sizeof(countBuf)),
+            MSERR_UNSUPPORT);
+        sampleCount = GetU32(countBuf);
+    }
+    CHECK_AND_RETURN_RET_LOG(sampleCount <= MAX_INDEX_SAMPLES, MSERR_UNSUPPORT, "too many samples");
+
+    // the samples per chunk of the current stsc entry, and the first chunk of the next entry.
+    const uint8_t *entry = stsc.Next();
+    CHECK_AND_RETURN_RET(entry != nullptr && GetU32(entry) == 1, MSERR_UNSUPPORT);
+    uint32_t samplesPerChunk = GetU32(entry + 4); // 4: samples_per_chunk
+    const uint8_t *nextStsc = stsc.Next();
+
+    const uint8_t *nextSync = stss.Next();
+    uint32_t chunk = 0;
+    uint32_t chunkSamplesLeft = 0;
+    int64_t samplePos = 0;
+    int64_t dts = 0;
+    uint32_t sttsLeft = 0;
+    uint32_t sttsDelta = 0;
+    uint32_t cttsLeft = 0;
+    int32_t cttsOffset = 0;
+    index.clear();
+    index.reserve(std::min({stss.GetCount(), sampleCount, MAX_INDEX_SAMPLES}));
+
+    for (uint32_t sample = 1; sample <= sampleCount && nextSync != nullptr; sample++) {
+        while (chunkSamplesLeft == 0) {
+            chunk++;
+            if (nextStsc != nullptr && GetU32(nextStsc) == chunk) {
+                samplesPerChunk = GetU32(nextStsc + 4); // 4: samples_per_chunk
+                nextStsc = stsc.Next();
+            }
+            entry = stco.Next();
+            CHECK_AND_RETURN_RET_LOG(entry != nullptr, MSERR_UNSUPPORT, "chunk %{public}u not found", chunk);
+            samplePos = track.isCo64 ? static_cast<int64_t>(GetU64(entry)) : GetU32(entry);
+            chunkSamplesLeft = samplesPerChunk;
+        }
+        while (sttsLeft == 0) {
+            entry = stts.Next();
+            CHECK_AND_RETURN_RET_LOG(entry != nullptr, MSERR_UNSUPPORT, "time of sample %{public}u not found", sample);
+            sttsLeft = GetU32(entry);
+            sttsDelta = GetU32(entry + 4); // 4: sample_delta
+        }
+        while (hasCtts && cttsLeft == 0) {
+            entry = ctts.Next();
+            CHECK_AND_RETURN_RET_LOG(entry != nullptr, MSERR_UNSUPPORT, "offset of sample %{public}u not found",
+                sample);
+            cttsLeft = GetU32(entry);
+            cttsOffset = static_cast<int32_t>(GetU32(entry + 4)); // 4: sample_offset, signed in practice
+        }
+        uint32_t sampleSize = uniformSize;
+        if (sampleSize == 0) {
+            entry = stsz.Next();
+            CHECK_AND_RETURN_RET(entry != nullptr, MSERR_UNSUPPORT);
+            sampleSize = GetU32(entry);
+        }
+
+        if (GetU32(nextSync) == sample) {
+            int64_t ptsUs = 0;
+            CHECK_AND_RETURN_RET_LOG(ToPtsUs(dts + (hasCtts ? cttsOffset : 0), ptsUs), MSERR_UNSUPPORT,
+                "sample time out of range");
+            index.push_back({ ptsUs, samplePos, sampleSize });
+            nextSync = stss.Next();
+        }
+
+        dts += sttsDelta;
+        sttsLeft--;
+        cttsLeft = hasCtts ? cttsLeft - 1 : 0;
+        samplePos += sampleSize;
+        chunkSamplesLeft--;
+    }
+    CHECK_AND_RETURN_RET_LOG(nextSync == nullptr && !index.empty(), MSERR_UNSUPPORT, "invalid sync samples");
+
+    std::sort(index.begin(), index.end(), [](const AVMetaSyncSample &lhs, const AVMetaSyncSample &rhs) {
+        return lhs.ptsUs < rhs.ptsUs;
+    });
+    return MSERR_OK;
+}
+
+void AVMetaMp4Parser::FillMetadata(std::unordered_map<int32_t, std::string> &metadata) const
+{
+    metadata = tags_;
+    metadata[AV_KEY_DURATION] = std::to_string(durationMs_);
+    metadata[AV_KEY_NUM_TRACKS] = std::to_string(trackCount_);
+    // the same as the pipeline, the mp4 without video is an audio/mp4.
+    metadata[AV_KEY_MIME_TYPE] = hasVideo_ ? FILE_MIMETYPE_VIDEO_MP4 : FILE_MIMETYPE_AUDIO_MP4;
+    if (hasVideo_) {
+        metadata[AV_KEY_HAS_VIDEO] = "yes";
+        if (width_ > 0 && height_ > 0) {
+            metadata[AV_KEY_VIDEO_WIDTH] = std::to_string(width_);
+            metadata[AV_KEY_VIDEO_HEIGHT] = std::to_string(height_);
+        }
+    }
+    if (hasAudio_) {
+        metadata[AV_KEY_HAS_AUDIO] = "yes";
+        if (sampleRate_ > 0) {
+            metadata[AV_KEY_SAMPLE_RATE] = std::to_string(sampleRate_);
+        }
+    }
+    MEDIA_LOGI("parsed, brand: 0x%{public}08x, duration: %{public}" PRIi64 " ms, tracks: %{public}d",
+        majorBrand_, durationMs_, trackCount_);
+}
+}
+}
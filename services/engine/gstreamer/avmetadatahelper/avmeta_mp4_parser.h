@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETA_MP4_PARSER_H
+#define AVMETA_MP4_PARSER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+struct AVMetaSyncSample {
+    int64_t ptsUs; // the presentation time, after the edit list is applied.
+    int64_t offset; // the position of the access unit in the file.
+    uint32_t size;
+};
+
+/**
+ * Resolve the metadata of the mp4, m4a and 3gp files from the iso base media file boxes
+ * directly, without building the playbin. Only the ftyp, moov/mvhd, trak/tkhd, mdia/hdlr,
+ * stsd and udta/meta/ilst boxes are read, each by one bounded pread, and the others are
+ * skipped by their headers. The resolved keys are the same as the ones collected from the
+ * gstreamer pipeline, so AV_KEY_AUTHOR is not resolved: gstreamer has no author tag, and the
+ * 3gpp auth box is reported as the composer by qtdemux.
+ *
+ * The sync sample index of the first video track is built from its stss, stts, ctts, stsc,
+ * stco/co64 and stsz tables, which are read sequentially in blocks.
+ *
+ * The fragmented files and the files that can not be parsed are rejected, the caller falls
+ * back to the pipeline for them.
+ */
+class AVMetaMp4Parser {
+public:
+    AVMetaMp4Parser() = default;
+    ~AVMetaMp4Parser();
+
+    // the uri is a file or fd uri, return MSERR_UNSUPPORT if the source is not supported.
+    int32_t Parse(const std::string &uri, std::unordered_map<int32_t, std::string> &metadata);
+    // the sync samples of the first video track, in the presentation order.
+    int32_t BuildSyncIndex(const std::string &uri, std::vector<AVMetaSyncSample> &index);
+
+    DISALLOW_COPY_AND_MOVE(AVMetaMp4Parser);
+
+private:
+    struct Box {
+        uint32_t type = 0;
+        int64_t payload = 0; // the position of the payload.
+        int64_t end = 0;
+    };
+
+    struct TrackInfo {
+        uint32_t handler = 0;
+        int32_t width = 0;
+        int32_t height = 0;
+        int32_t sampleRate = 0;
+        Box sampleDesc;
+        bool hasSampleDesc = false;
+        // for the sync sample index.
+        uint32_t mediaTimescale = 0;
+        int64_t editMediaTime = 0; // in the media timescale.
+        int64_t editEmptyDuration = 0; // in the movie timescale.
+        Box stss;
+        Box stts;
+        Box ctts;
+        Box stsc;
+        Box stco;
+        Box stsz;
+        bool isCo64 = false;
+    };
+
+    class TableReader;
+
+    int32_t ParseFile(const std::string &uri);
+
+    int32_t OpenSource(const std::string &uri);
+    bool ReadAt(int64_t pos, void *buf, size_t len);
+    bool ReadBox(int64_t pos, int64_t limit, Box &box);
+    bool ReadPayload(const Box &box, uint8_t *buf, size_t minLen, size_t &len);
+    int32_t ParseMoov(const Box &moov);
+    bool ParseMvhd(const Box &box);
+    bool ParseTrak(const Box &trak);
+    void ParseTkhd(const Box &box, TrackInfo &track);
+    void ParseEdts(const Box &edts, TrackInfo &track);
+    void ParseMdia(const Box &mdia, TrackInfo &track);
+    void ParseMdhd(const Box &box, TrackInfo &track);
+    void ParseStbl(const Box &stbl, TrackInfo &track);
+    void ParseStsd(TrackInfo &track);
+    void ParseAudioSampleEntry(const Box &entry, TrackInfo &track);
+    void ParseEsds(const Box &esds, TrackInfo &track);
+    void ParseUdta(const Box &udta);
+    void ParseIlst(const Box &ilst);
+    void ParseStringItem(const Box &item, int32_t key, bool isIlst);
+    void FillMetadata(std::unordered_map<int32_t, std::string> &metadata) const;
+    int32_t BuildSyncIndexFromTables(std::vector<AVMetaSyncSample> &index);
+    // false if the time does not fit in int64 in us.
+    bool ToPtsUs(int64_t mediaTime, int64_t &ptsUs) const;
+
+    int32_t fd_ = -1;
+    bool ownFd_ = false;
+    int64_t start_ = 0;
+    int64_t end_ = 0;
+    uint32_t majorBrand_ = 0;
+    int64_t durationMs_ = 0;
+    uint32_t movieTimescale_ = 0;
+    int32_t trackCount_ = 0;
+    bool hasVideo_ = false;
+    bool hasAudio_ = false;
+    int32_t width_ = 0;
+    int32_t height_ = 0;
+    int32_t sampleRate_ = 0;
+    TrackInfo videoTrack_; // the first video track.
+    std::unordered_map<int32_t, std::string> tags_;
+};
+}
+}
+#endif
@@ -20,6 +20,8 @@
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetaSinkProvider"};
+    // the formats that the FrameConverter reads directly.
+    constexpr const char *FRAME_SINK_CAPS = "video/x-raw, format=(string){ NV12, NV21, I420, YV12 }";
 }
 
 namespace OHOS {
@@ -37,6 +39,11 @@ AVMetaSinkProvider::~AVMetaSinkProvider()
         audSink_ = nullptr;
     }
     if (vidSink_ != nullptr) {
+        // the sink may be still referenced by the playbin.
+        for (auto signalId : signalIds_) {
+            g_signal_handler_disconnect(vidSink_, signalId);
+        }
+        signalIds_.clear();
         gst_object_unref(vidSink_);
         vidSink_ = nullptr;
     }
@@ -61,8 +68,7 @@ PlayBinSinkProvider::SinkPtr AVMetaSinkProvider::CreateVideoSink()
         if (usage_ == AVMetadataUsage::AV_META_USAGE_META_ONLY) {
             vidSink_ = gst_element_factory_make("fakesink", "avmeta_vid_sink");
         } else {
-            vidSink_ = gst_element_factory_make("appsink", "avmeta_vid_sink");
-            // setup callbacks for appsink
+            vidSink_ = CreateFrameSink();
         }
     }
 
@@ -73,8 +79,66 @@ PlayBinSinkProvider::SinkPtr AVMetaSinkProvider::CreateVideoSink()
     return GST_ELEMENT_CAST(gst_object_ref(vidSink_));
 }
 
+GstElement *AVMetaSinkProvider::CreateFrameSink()
+{
+    GstElement *sink = gst_element_factory_make("appsink", "avmeta_vid_sink");
+    CHECK_AND_RETURN_RET_LOG(sink != nullptr, nullptr, "create appsink failed");
+
+    GstCaps *caps = gst_caps_from_string(FRAME_SINK_CAPS);
+    // only the latest frame is needed, and it is taken at preroll, no clock waiting.
+    g_object_set(G_OBJECT(sink), "caps", caps, "sync", FALSE, "max-buffers", 1u, "drop", TRUE,
+        "emit-signals", TRUE, nullptr);
+    if (caps != nullptr) {
+        gst_caps_unref(caps);
+    }
+
+    signalIds_.push_back(g_signal_connect(sink, "new-preroll", G_CALLBACK(&AVMetaSinkProvider::OnNewPreroll), this));
+    signalIds_.push_back(g_signal_connect(sink, "new-sample", G_CALLBACK(&AVMetaSinkProvider::OnNewSample), this));
+    return sink;
+}
+
+GstFlowReturn AVMetaSinkProvider::OnNewPreroll(GstElement *sink, gpointer userData)
+{
+    CHECK_AND_RETURN_RET(sink != nullptr && userData != nullptr, GST_FLOW_ERROR);
+    GstSample *sample = nullptr;
+    g_signal_emit_by_name(sink, "pull-preroll", &sample);
+    CHECK_AND_RETURN_RET_LOG(sample != nullptr, GST_FLOW_OK, "pull preroll failed");
+
+    auto provider = reinterpret_cast<AVMetaSinkProvider *>(userData);
+    provider->NotifyFrame(sample);
+    gst_sample_unref(sample);
+    return GST_FLOW_OK;
+}
+
+GstFlowReturn AVMetaSinkProvider::OnNewSample(GstElement *sink, gpointer userData)
+{
+    CHECK_AND_RETURN_RET(sink != nullptr && userData != nullptr, GST_FLOW_ERROR);
+    GstSample *sample = nullptr;
+    g_signal_emit_by_name(sink, "pull-sample", &sample);
+    CHECK_AND_RETURN_RET_LOG(sample != nullptr, GST_FLOW_OK, "pull sample failed");
+
+    auto provider = reinterpret_cast<AVMetaSinkProvider *>(userData);
+    provider->NotifyFrame(sample);
+    gst_sample_unref(sample);
+    return GST_FLOW_OK;
+}
+
+void AVMetaSinkProvider::NotifyFrame(GstSample *sample)
+{
+    std::shared_ptr<FrameCallback> callback;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        callback = callback_;
+    }
+
+    if (callback != nullptr) {
+        callback->OnFrameAvaiable(*sample);
+    }
+}
+
 void AVMetaSinkProvider::SetFrameCallback(const std::shared_ptr<FrameCallback> &callback)
 {
+    std::unique_lock<std::mutex> lock(mutex_);
     callback_ = callback;
 }
 }
@@ -18,6 +18,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include <nocopyable.h>
 #include <gst/gst.h>
 #include "playbin_sink_provider.h"
@@ -37,10 +39,17 @@ public:
     DISALLOW_COPY_AND_MOVE(AVMetaSinkProvider);
 
 private:
+    GstElement *CreateFrameSink();
+    static GstFlowReturn OnNewPreroll(GstElement *sink, gpointer userData);
+    static GstFlowReturn OnNewSample(GstElement *sink, gpointer userData);
+    void NotifyFrame(GstSample *sample);
+
     int32_t usage_;
     GstElement *audSink_ = nullptr;
     GstElement *vidSink_ = nullptr;
     std::shared_ptr<FrameCallback> callback_;
+    std::vector<gulong> signalIds_;
+    std::mutex mutex_;
 };
 }
 }
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmeta_sync_index_cache.h"
+#include <algorithm>
+
+namespace {
+    // a few sources are fetched in turn at most, such as the thumbnails of a gallery page.
+    constexpr size_t MAX_ENTRY_NUM = 8;
+}
+
+namespace OHOS {
+namespace Media {
+AVMetaSyncIndexCache &AVMetaSyncIndexCache::GetInstance()
+{
+    static AVMetaSyncIndexCache instance;
+    return instance;
+}
+
+std::shared_ptr<const AVMetaSyncIndex> AVMetaSyncIndexCache::Get(const AVMetadataCacheKey &key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(lruList_.begin(), lruList_.end(),
+        [&key](const auto &entry) { return entry.first == key; });
+    if (it == lruList_.end()) {
+        return nullptr;
+    }
+    lruList_.splice(lruList_.begin(), lruList_, it);
+    return it->second;
+}
+
+void AVMetaSyncIndexCache::Put(const AVMetadataCacheKey &key, const std::shared_ptr<const AVMetaSyncIndex> &index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    lruList_.remove_if([&key](const auto &entry) { return entry.first == key; });
+    lruList_.emplace_front(key, index);
+    if (lruList_.size() > MAX_ENTRY_NUM) {
+        lruList_.pop_back();
+    }
+}
+} // namespace Media
+} // namespace OHOS
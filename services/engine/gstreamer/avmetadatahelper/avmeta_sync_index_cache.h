@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETA_SYNC_INDEX_CACHE_H
+#define AVMETA_SYNC_INDEX_CACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "avmetadata_cache_key.h"
+#include "avmeta_mp4_parser.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+using AVMetaSyncIndex = std::vector<AVMetaSyncSample>;
+
+/**
+ * The sync indexes of the sources fetched recently, shared by all engines of the process, so that
+ * the sample table of a source fetched again is not walked again. Keyed by the identity of the file
+ * content, the same as the metadata cache.
+ */
+class AVMetaSyncIndexCache {
+public:
+    static AVMetaSyncIndexCache &GetInstance();
+
+    std::shared_ptr<const AVMetaSyncIndex> Get(const AVMetadataCacheKey &key);
+    void Put(const AVMetadataCacheKey &key, const std::shared_ptr<const AVMetaSyncIndex> &index);
+
+    DISALLOW_COPY_AND_MOVE(AVMetaSyncIndexCache);
+
+private:
+    AVMetaSyncIndexCache() = default;
+    ~AVMetaSyncIndexCache() = default;
+
+    std::mutex mutex_;
+    // the most recently used at the front.
+    std::list<std::pair<AVMetadataCacheKey, std::shared_ptr<const AVMetaSyncIndex>>> lruList_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETA_SYNC_INDEX_CACHE_H
@@ -14,6 +14,10 @@
  */
 
 #include "avmetadatahelper_engine_gst_impl.h"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <new>
 #include <gst/gst.h>
 #include "media_errors.h"
 #include "media_log.h"
@@ -25,6 +29,8 @@
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetaEngineGstImpl"};
+    // decode forward instead of the flushing seek if the next timestamp is not farther than this.
+    constexpr int64_t MAX_FORWARD_DECODE_US = 1000000;
 }
 
 namespace OHOS {
@@ -48,13 +54,18 @@ int32_t AVMetadataHelperEngineGstImpl::SetSource(const std::string &uri, int32_t
         return MSERR_INVALID_VAL;
     }
 
-    if (UriHelper(uri).FormatMe().UriType() != UriHelper::URI_TYPE_FILE) {
+    uint8_t uriType = UriHelper(uri).FormatMe().UriType();
+    if (uriType != UriHelper::URI_TYPE_FILE && uriType != UriHelper::URI_TYPE_FD) {
         MEDIA_LOGE("Unsupported uri type : %{public}s", uri.c_str());
         return MSERR_UNSUPPORT;
     }
 
     MEDIA_LOGI("uri: %{public}s, usage: %{public}d", uri.c_str(), usage);
 
+    if (usage == AVMetadataUsage::AV_META_USAGE_META_ONLY && SetSourceByParser(uri, usage) == MSERR_OK) {
+        return MSERR_OK;
+    }
+
     int32_t ret = SetSourceInternel(uri, usage);
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
@@ -66,7 +77,8 @@ std::string AVMetadataHelperEngineGstImpl::ResolveMetadata(int32_t key)
     MEDIA_LOGD("enter");
     std::string result;
 
-    int32_t ret = ExtractMetadata();
+    // only wait for this key, the others go on collecting for the later calls.
+    int32_t ret = ExtractMetadata({ key });
     CHECK_AND_RETURN_RET(ret == MSERR_OK, result);
 
     if (collectedMeta_.count(key) == 0) {
@@ -95,48 +107,295 @@ std::shared_ptr<AVSharedMemory> AVMetadataHelperEngineGstImpl::FetchFrameAtTime(
 {
     MEDIA_LOGD("enter");
 
+    auto startTime = std::chrono::steady_clock::now();
+    int32_t ret = CheckFetchFrame(option);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+    PrepareSyncIndex();
+
+    ret = InitConverter(param);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+
+    ret = PrepareInternel(IPlayBinCtrler::PlayBinScene::THUBNAIL);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+
+    AVMetaSyncSample sync;
+    if (FindSyncSample(timeUs, option, sync)) {
+        // seek to the key frame itself, only its access unit is decoded.
+        timeUs = sync.ptsUs;
+        option = AV_META_QUERY_CLOSEST_SYNC;
+    }
+    ret = SeekInternel(timeUs, option);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+
+    std::shared_ptr<AVSharedMemory> frame = converter_->GetOneFrame(); // need exception awaken up.
+    CHECK_AND_RETURN_RET(frame != nullptr, nullptr);
+
+    auto costUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    MEDIA_LOGI("fetched frame at %{public}" PRIi64 " us, indexed: %{public}d, cost: %{public}" PRIi64 " us",
+        timeUs, syncIndex_ != nullptr, static_cast<int64_t>(costUs));
+    return frame;
+}
+
+struct AVMetadataHelperEngineGstImpl::FrameBatch {
+    int32_t entryCount = 0;
+    std::shared_ptr<AVSharedMemory> slab;
+    OutputFrameSlab *header = nullptr;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t bytesPerPixel = 0;
+    // the last fetched frame, the decoding position of the pipeline.
+    int64_t lastPtsUs = -1;
+    int32_t lastOffset = 0;
+    int64_t lastSyncUs = -1; // the indexed key frame of the last fetched frame.
+    int32_t seekCount = 0;
+    int32_t stepCount = 0;
+};
+
+std::shared_ptr<AVSharedMemory> AVMetadataHelperEngineGstImpl::FetchFramesAtTimes(
+    const std::vector<int64_t> &timesUs, int32_t option, OutputConfiguration param)
+{
+    MEDIA_LOGD("enter");
+
+    CHECK_AND_RETURN_RET_LOG(!timesUs.empty() &&
+        timesUs.size() <= static_cast<size_t>(OutputFrameSlab::MAX_FRAME_COUNT), nullptr,
+        "invalid timestamp count: %{public}zu", timesUs.size());
+
+    int32_t ret = CheckFetchFrame(option);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+    PrepareSyncIndex();
+
+    ret = InitConverter(param);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+
+    ret = PrepareInternel(IPlayBinCtrler::PlayBinScene::THUBNAIL);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+
+    auto startTime = std::chrono::steady_clock::now();
+    FrameBatch batch;
+    batch.entryCount = static_cast<int32_t>(timesUs.size());
+    std::vector<OutputFrameSlab::Entry> entries(timesUs.size());
+
+    // visit in the time order, so that the frames after the same key frame are decoded forward.
+    std::vector<size_t> order(timesUs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&timesUs](size_t lhs, size_t rhs) {
+        return timesUs[lhs] < timesUs[rhs];
+    });
+
+    for (size_t index : order) {
+        OutputFrameSlab::Entry &entry = entries[index];
+        entry = { timesUs[index], -1, 0, 0 };
+        ret = FetchBatchFrame(batch, timesUs[index], option, entry);
+        if (ret != MSERR_OK) {
+            MEDIA_LOGW("fetch frame at %{public}" PRIi64 " failed, ret: %{public}d", timesUs[index], ret);
+            // the decoding position is unknown, seek for the next one.
+            batch.lastPtsUs = -1;
+            batch.lastOffset = 0;
+            batch.lastSyncUs = -1;
+        }
+    }
+    converter_->DropFrame();
+    CHECK_AND_RETURN_RET_LOG(batch.header != nullptr, nullptr, "no frame fetched");
+
+    std::copy(entries.begin(), entries.end(), batch.header->GetEntries());
+    auto costMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+        startTime).count();
+    MEDIA_LOGI("fetched %{public}d frames for %{public}d timestamps, seek: %{public}d, step: %{public}d, "
+        "cost: %{public}" PRIi64 " ms, %{public}" PRIi64 " ms per frame", batch.header->frameCount_,
+        batch.entryCount, batch.seekCount, batch.stepCount, static_cast<int64_t>(costMs),
+        static_cast<int64_t>(costMs) / batch.header->frameCount_);
+    return batch.slab;
+}
+
+int32_t AVMetadataHelperEngineGstImpl::FetchBatchFrame(FrameBatch &batch, int64_t timeUs, int32_t option,
+    OutputFrameSlab::Entry &entry)
+{
+    int64_t syncUs = -1;
+    AVMetaSyncSample sync;
+    if (FindSyncSample(timeUs, option, sync)) {
+        syncUs = sync.ptsUs;
+        timeUs = sync.ptsUs;
+        option = AV_META_QUERY_CLOSEST_SYNC;
+    }
+
+    // the next key frame of a time not after the last key frame is the last key frame itself.
+    bool reuseLast = batch.lastOffset != 0 && ((syncUs >= 0 && syncUs == batch.lastSyncUs) ||
+        (timeUs <= batch.lastPtsUs && (option == AV_META_QUERY_NEXT_SYNC || timeUs == batch.lastPtsUs)));
+    if (!reuseLast) {
+        converter_->DropFrame();
+        int32_t ret;
+        int64_t distanceUs = timeUs - batch.lastPtsUs;
+        if (option == AV_META_QUERY_CLOSEST && batch.lastPtsUs >= 0 && distanceUs > 0 &&
+            distanceUs <= MAX_FORWARD_DECODE_US) {
+            batch.stepCount++;
+            ret = StepInternel(distanceUs);
+        } else {
+            batch.seekCount++;
+            ret = SeekInternel(timeUs, option);
+        }
+        CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+        FrameConverter::FrameInfo info;
+        ret = converter_->WaitFrame(info);
+        CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+        if (batch.lastOffset == 0 || info.ptsUs < 0 || info.ptsUs != batch.lastPtsUs) {
+            ret = batch.header == nullptr ? AllocateBatchSlab(batch, info) : MSERR_OK;
+            CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+            CHECK_AND_RETURN_RET_LOG(info.width == batch.width && info.height == batch.height &&
+                info.bytesPerPixel == batch.bytesPerPixel, MSERR_INVALID_OPERATION, "frame size changed");
+
+            int32_t offset = OutputFrameSlab::GetHeaderSize(batch.entryCount) +
+                batch.header->frameCount_ * batch.header->frameSize_;
+            uint8_t *base = batch.slab->GetBase();
+            OutputFrame *frame = new (base + offset) OutputFrame(batch.width, batch.height, batch.bytesPerPixel);
+            ret = converter_->ConvertFrame(frame->GetFlattenedData());
+            CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+            batch.header->frameCount_++;
+            batch.lastOffset = offset;
+        }
+        batch.lastPtsUs = info.ptsUs;
+        batch.lastSyncUs = syncUs;
+    }
+
+    entry.ptsUs = batch.lastPtsUs;
+    entry.offset = batch.lastOffset;
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperEngineGstImpl::AllocateBatchSlab(FrameBatch &batch, const FrameConverter::FrameInfo &info)
+{
+    int64_t frameSize = static_cast<int64_t>(sizeof(OutputFrame)) +
+        static_cast<int64_t>(info.width) * info.height * info.bytesPerPixel;
+    // 8 bytes alignment for each frame.
+    frameSize = (frameSize + 7) & ~static_cast<int64_t>(7);
+    int64_t slabSize = OutputFrameSlab::GetHeaderSize(batch.entryCount) + frameSize * batch.entryCount;
+    CHECK_AND_RETURN_RET_LOG(slabSize <= OutputFrameSlab::MAX_SLAB_SIZE, MSERR_INVALID_VAL,
+        "frames too large, %{public}dx%{public}d, count: %{public}d", info.width, info.height, batch.entryCount);
+
+    // the pages of the frames that are not fetched are never touched.
+    batch.slab = AVSharedMemory::Create(static_cast<int32_t>(slabSize), AVSharedMemory::FLAGS_READ_ONLY,
+        "FetchFramesAtTimes");
+    CHECK_AND_RETURN_RET_LOG(batch.slab != nullptr && batch.slab->GetBase() != nullptr, MSERR_NO_MEMORY,
+        "create slab failed, size: %{public}" PRIi64 "", slabSize);
+
+    batch.header = new (batch.slab->GetBase()) OutputFrameSlab(batch.entryCount);
+    batch.header->frameSize_ = static_cast<int32_t>(frameSize);
+    batch.width = info.width;
+    batch.height = info.height;
+    batch.bytesPerPixel = info.bytesPerPixel;
+
+    // pin the output size, all frames in the slab are the same size even if the video size changes.
+    OutputConfiguration config;
+    config.dstWidth = info.width;
+    config.dstHeight = info.height;
+    config.colorFormat = config_.colorFormat;
+    return converter_->Init(config);
+}
+
+int32_t AVMetadataHelperEngineGstImpl::CheckFetchFrame(int32_t option)
+{
     if ((option != AV_META_QUERY_CLOSEST) && (option != AV_META_QUERY_CLOSEST_SYNC) &&
         (option != AV_META_QUERY_NEXT_SYNC) && (option != AV_META_QUERY_PREVIOUS_SYNC)) {
         MEDIA_LOGE("Invalid query option: %{public}d", option);
-        return nullptr;
+        return MSERR_INVALID_VAL;
     }
 
     if (usage_ != AVMetadataUsage::AV_META_USAGE_PIXEL_MAP) {
         MEDIA_LOGE("current instance is unavaiable for pixel map, check usage !");
-        return nullptr;
+        return MSERR_INVALID_OPERATION;
     }
 
     int32_t ret = ExtractMetadata();
-    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
     if (collectedMeta_.count(AV_KEY_HAS_VIDEO) == 0) {
         MEDIA_LOGE("the associated media source does not have video track");
-        return nullptr;
+        return MSERR_INVALID_OPERATION;
     }
+    return MSERR_OK;
+}
 
-    ret = InitConverter(param);
-    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+void AVMetadataHelperEngineGstImpl::PrepareSyncIndex()
+{
+    if (syncIndexPrepared_) {
+        return;
+    }
+    syncIndexPrepared_ = true;
 
-    ret = PrepareInternel(IPlayBinCtrler::PlayBinScene::THUBNAIL);
-    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+    AVMetadataCacheKey key;
+    bool cacheable = AVMetadataCacheKey::Make(uri_, key);
+    std::shared_ptr<const AVMetaSyncIndex> index = cacheable ? AVMetaSyncIndexCache::GetInstance().Get(key) : nullptr;
+    if (index != nullptr) {
+        MEDIA_LOGD("sync index cache hit, %{public}zu key frames", index->size());
+    } else {
+        auto startTime = std::chrono::steady_clock::now();
+        auto built = std::make_shared<AVMetaSyncIndex>();
+        int32_t ret = AVMetaMp4Parser().BuildSyncIndex(uri_, *built);
+        auto costUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+        if (ret != MSERR_OK) {
+            MEDIA_LOGD("no sync index, the sync options are left to the demuxer");
+            return;
+        }
 
-    ret = SeekInternel(timeUs, option);
-    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+        MEDIA_LOGI("sync index built, %{public}zu key frames, cost: %{public}" PRIi64 " us",
+            built->size(), static_cast<int64_t>(costUs));
+        index = built;
+        if (cacheable) {
+            AVMetaSyncIndexCache::GetInstance().Put(key, index);
+        }
+    }
 
-    std::shared_ptr<AVSharedMemory> frame = converter_->GetOneFrame(); // need exception awaken up.
-    CHECK_AND_RETURN_RET(frame != nullptr, nullptr);
+    std::unique_lock<std::mutex> lock(mutex_);
+    syncIndex_ = index;
+}
 
-    MEDIA_LOGD("exit");
-    return frame;
+bool AVMetadataHelperEngineGstImpl::FindSyncSample(int64_t timeUs, int32_t option, AVMetaSyncSample &sample) const
+{
+    if (syncIndex_ == nullptr || syncIndex_->empty() || timeUs < 0 || (option != AV_META_QUERY_CLOSEST_SYNC &&
+        option != AV_META_QUERY_NEXT_SYNC && option != AV_META_QUERY_PREVIOUS_SYNC)) {
+        return false;
+    }
+
+    // the first key frame not before the time, and the one before it.
+    auto next = std::lower_bound(syncIndex_->begin(), syncIndex_->end(), timeUs,
+        [](const AVMetaSyncSample &item, int64_t time) { return item.ptsUs < time; });
+    auto prev = (next == syncIndex_->begin()) ? next : std::prev(next);
+    if (next == syncIndex_->end()) {
+        next = prev;
+    } else if (next->ptsUs == timeUs) {
+        prev = next;
+    }
+
+    if (option == AV_META_QUERY_NEXT_SYNC) {
+        sample = *next;
+    } else if (option == AV_META_QUERY_PREVIOUS_SYNC) {
+        sample = *prev;
+    } else {
+        sample = (timeUs - prev->ptsUs <= next->ptsUs - timeUs) ? *prev : *next;
+    }
+    MEDIA_LOGD("key frame of %{public}" PRIi64 " us: %{public}" PRIi64 " us, offset: %{public}" PRIi64
+        ", size: %{public}u", timeUs, sample.ptsUs, sample.offset, sample.size);
+    return true;
 }
 
 int32_t AVMetadataHelperEngineGstImpl::SetSourceInternel(const std::string &uri, int32_t usage)
 {
     Reset();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        canceled_ = false;
+    }
 
-    auto notifier = std::bind(&AVMetadataHelperEngineGstImpl::OnNotifyMessage, this, std::placeholders::_1);
-    playBinCtrler_ = IPlayBinCtrler::Create(IPlayBinCtrler::PlayBinKind::PLAYBIN_KIND_PLAYBIN2, notifier);
-    CHECK_AND_RETURN_RET(playBinCtrler_ != nullptr, MSERR_UNKNOWN);
+    // the ctrler recycled by the reset is re-armed with the new source.
+    if (playBinCtrler_ == nullptr) {
+        auto notifier = std::bind(&AVMetadataHelperEngineGstImpl::OnNotifyMessage, this, std::placeholders::_1);
+        playBinCtrler_ = IPlayBinCtrler::Create(IPlayBinCtrler::PlayBinKind::PLAYBIN_KIND_PLAYBIN2, notifier);
+        CHECK_AND_RETURN_RET(playBinCtrler_ != nullptr, MSERR_UNKNOWN);
+    }
 
     metaCollector_ = std::make_unique<AVMetaMetaCollector>();
     auto listener = std::bind(&AVMetadataHelperEngineGstImpl::OnNotifyElemSetup, this, std::placeholders::_1);
@@ -157,12 +416,37 @@ int32_t AVMetadataHelperEngineGstImpl::SetSourceInternel(const std::string &uri,
 
     metaCollector_->Start();
     usage_ = usage;
+    uri_ = uri;
 
     return MSERR_OK;
 }
 
+int32_t AVMetadataHelperEngineGstImpl::SetSourceByParser(const std::string &uri, int32_t usage)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    std::unordered_map<int32_t, std::string> metadata;
+    int32_t ret = AVMetaMp4Parser().Parse(uri, metadata);
+    if (ret != MSERR_OK) {
+        MEDIA_LOGD("not parsed natively, fallback to the pipeline");
+        return ret;
+    }
+
+    Reset();
+    std::unique_lock<std::mutex> lock(mutex_);
+    collectedMeta_ = std::move(metadata);
+    hasCollecteMeta_ = true;
+    canceled_ = false;
+    usage_ = usage;
+
+    auto costUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    MEDIA_LOGI("metadata parsed without pipeline, cost: %{public}" PRIi64 " us", static_cast<int64_t>(costUs));
+    return MSERR_OK;
+}
+
 int32_t AVMetadataHelperEngineGstImpl::InitConverter(const OutputConfiguration &config)
 {
+    config_ = config;
     // need to skip the same config
     int32_t ret = converter_->Init(config);
     CHECK_AND_RETURN_RET(ret == MSERR_OK, MSERR_INVALID_OPERATION);
@@ -203,47 +487,85 @@ int32_t AVMetadataHelperEngineGstImpl::SeekInternel(int64_t timeUs, int32_t opti
     int32_t ret = playBinCtrler_->Seek(timeUs, option);
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
+    return WaitSeekDone(lock);
+}
+
+int32_t AVMetadataHelperEngineGstImpl::StepInternel(int64_t amountUs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    int32_t ret = playBinCtrler_->Step(amountUs);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    return WaitSeekDone(lock);
+}
+
+int32_t AVMetadataHelperEngineGstImpl::WaitSeekDone(std::unique_lock<std::mutex> &lock)
+{
     seeking_ = true;
     cond_.wait(lock, [this]() { return canceled_ || !seeking_; });
     CHECK_AND_RETURN_RET_LOG(!canceled_, MSERR_UNKNOWN, "Canceled !");
+    CHECK_AND_RETURN_RET_LOG(seekResult_ == MSERR_OK, seekResult_, "seek failed");
 
     return MSERR_OK;
 }
 
-int32_t AVMetadataHelperEngineGstImpl::ExtractMetadata()
+int32_t AVMetadataHelperEngineGstImpl::ExtractMetadata(const std::vector<int32_t> &keys)
 {
     if (!hasCollecteMeta_) {
         int32_t ret = PrepareInternel(IPlayBinCtrler::PlayBinScene::METADATA);
         CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
-        collectedMeta_ = metaCollector_->GetMetadata();
-        hasCollecteMeta_ = true;
+        bool completed = false;
+        std::unordered_map<int32_t, std::string> meta = metaCollector_->GetMetadata(keys, completed);
+        if (completed) {
+            collectedMeta_ = std::move(meta);
+            hasCollecteMeta_ = true;
+        } else {
+            for (auto &[key, value] : meta) {
+                collectedMeta_[key] = value;
+            }
+        }
     }
     return MSERR_OK;
 }
 
 void AVMetadataHelperEngineGstImpl::Reset()
 {
-    std::unique_lock<std::mutex> lock(mutex_);
-    if (metaCollector_ != nullptr) {
+    std::shared_ptr<IPlayBinCtrler> playBinCtrler;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
         metaCollector_ = nullptr;
+        // the metadata may be parsed without the collector.
         hasCollecteMeta_ = false;
+        collectedMeta_.clear();
+        uri_.clear();
+        syncIndexPrepared_ = false;
+        syncIndex_ = nullptr;
+        playBinCtrler = playBinCtrler_;
+
+        canceled_ = true;
+        seeking_ = false;
+        prepared_ = false;
+        cond_.notify_all();
     }
 
-    if (playBinCtrler_ != nullptr) {
-        playBinCtrler_ = nullptr;
-        sinkProvider_ = nullptr;
+    // out of the lock, the pending messages are notified during recycling.
+    if (playBinCtrler != nullptr && playBinCtrler->Recycle() != MSERR_OK) {
+        playBinCtrler = nullptr;
     }
 
+    std::unique_lock<std::mutex> lock(mutex_);
+    playBinCtrler_ = playBinCtrler;
+    sinkProvider_ = nullptr;
+    // the late messages of the previous source may have changed them.
+    seeking_ = false;
+    prepared_ = false;
+
     if (converter_ != nullptr) {
         (void)converter_->StopConvert();
         converter_ = nullptr;
     }
-
-    canceled_ = true;
-    seeking_ = false;
-    prepared_ = false;
-    cond_.notify_all();
 }
 
 void AVMetadataHelperEngineGstImpl::OnNotifyMessage(const PlayBinMessage &msg)
@@ -259,6 +581,7 @@ void AVMetadataHelperEngineGstImpl::OnNotifyMessage(const PlayBinMessage &msg)
         case PLAYBIN_MSG_SEEKDONE: {
             std::unique_lock<std::mutex> lock(mutex_);
             seeking_ = false;
+            seekResult_ = msg.code;
             cond_.notify_one();
             break;
         }
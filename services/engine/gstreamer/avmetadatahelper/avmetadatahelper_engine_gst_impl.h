@@ -19,10 +19,12 @@
 #include <mutex>
 #include <condition_variable>
 #include "nocopyable.h"
+#include "media_errors.h"
 #include "i_avmetadatahelper_engine.h"
 #include "i_playbin_ctrler.h"
 #include "frame_converter.h"
 #include "avmeta_meta_collector.h"
+#include "avmeta_sync_index_cache.h"
 
 namespace OHOS {
 namespace Media {
@@ -38,16 +40,30 @@ public:
     std::unordered_map<int32_t, std::string> ResolveMetadata() override;
     std::shared_ptr<AVSharedMemory> FetchFrameAtTime(
         int64_t timeUs, int32_t option, OutputConfiguration param) override;
+    std::shared_ptr<AVSharedMemory> FetchFramesAtTimes(
+        const std::vector<int64_t> &timesUs, int32_t option, OutputConfiguration param) override;
+    void Reset() override;
 
 private:
+    struct FrameBatch;
     void OnNotifyMessage(const PlayBinMessage &msg);
     int32_t SetSourceInternel(const std::string &uri, int32_t usage);
+    // parse the mp4 boxes for the metadata directly, no pipeline is created if it succeeds.
+    int32_t SetSourceByParser(const std::string &uri, int32_t usage);
     int32_t InitConverter(const OutputConfiguration &config);
     int32_t PrepareInternel(IPlayBinCtrler::PlayBinScene scene);
     int32_t SeekInternel(int64_t timeUs, int32_t option);
-    int32_t ExtractMetadata();
+    int32_t StepInternel(int64_t amountUs);
+    int32_t WaitSeekDone(std::unique_lock<std::mutex> &lock);
+    int32_t CheckFetchFrame(int32_t option);
+    // built at the first frame fetch, or shared from the AVMetaSyncIndexCache.
+    void PrepareSyncIndex();
+    bool FindSyncSample(int64_t timeUs, int32_t option, AVMetaSyncSample &sample) const;
+    int32_t FetchBatchFrame(FrameBatch &batch, int64_t timeUs, int32_t option, OutputFrameSlab::Entry &entry);
+    int32_t AllocateBatchSlab(FrameBatch &batch, const FrameConverter::FrameInfo &info);
+    // the empty keys means all keys.
+    int32_t ExtractMetadata(const std::vector<int32_t> &keys = {});
     void OnNotifyElemSetup(GstElement &elem);
-    void Reset();
 
     std::shared_ptr<IPlayBinCtrler> playBinCtrler_;
     std::shared_ptr<PlayBinSinkProvider> sinkProvider_;
@@ -56,10 +72,16 @@ private:
     std::unordered_map<int32_t, std::string> collectedMeta_;
     bool hasCollecteMeta_ = false;
     int32_t usage_ = AVMetadataUsage::AV_META_USAGE_PIXEL_MAP;
+    OutputConfiguration config_;
+    std::string uri_;
+    bool syncIndexPrepared_ = false;
+    // the sync samples of the source in the presentation order, nullptr if it's not indexed.
+    std::shared_ptr<const AVMetaSyncIndex> syncIndex_;
 
     std::mutex mutex_;
     std::condition_variable cond_;
     bool seeking_ = false;
+    int32_t seekResult_ = MSERR_OK;
     bool canceled_ = false;
     bool prepared_ = false;
 };
@@ -23,7 +23,8 @@ namespace Media {
 class FrameCallback {
 public:
     virtual ~FrameCallback() = default;
-    virtual void OnFrameAvaiable(GstBuffer &frame) = 0;
+    // called in the streaming thread for each prerolled or rendered video sample.
+    virtual void OnFrameAvaiable(GstSample &sample) = 0;
 };
 }
 }
@@ -14,15 +14,49 @@
  */
 
 #include "frame_converter.h"
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include "avsharedmemory.h"
 #include "media_errors.h"
 #include "media_log.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "FrameConvert"};
+    constexpr int32_t FRAME_WAIT_TIMEOUT_MS = 3000;
 }
 
 namespace OHOS {
 namespace Media {
+namespace {
+    // not pooled, the frame is mapped by the client after it is returned, and a pooled region would be
+    // overwritten by the next fetching as soon as the last local reference is released.
+    std::shared_ptr<AVSharedMemory> AcquireOutputMemory(int32_t size)
+    {
+        return AVSharedMemory::Create(size, AVSharedMemory::FLAGS_READ_ONLY, "FrameConverterOutput");
+    }
+
+    bool GetYuvLayout(GstVideoFormat format, YuvLayout &layout)
+    {
+        switch (format) {
+            case GST_VIDEO_FORMAT_I420:
+                layout = YUV_LAYOUT_I420;
+                return true;
+            case GST_VIDEO_FORMAT_YV12:
+                layout = YUV_LAYOUT_YV12;
+                return true;
+            case GST_VIDEO_FORMAT_NV12:
+                layout = YUV_LAYOUT_NV12;
+                return true;
+            case GST_VIDEO_FORMAT_NV21:
+                layout = YUV_LAYOUT_NV21;
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
 FrameConverter::FrameConverter()
 {
     MEDIA_LOGD("enter ctor, instance: 0x%{public}06" PRIXPTR "", FAKE_POINTER(this));
@@ -36,47 +70,196 @@ FrameConverter::~FrameConverter()
 
 int32_t FrameConverter::Init(const OutputConfiguration &config)
 {
-    (void)config;
+    CHECK_AND_RETURN_RET_LOG(FramePixelConverter::GetBytesPerPixel(config.colorFormat) != 0, MSERR_UNSUPPORT,
+        "unsupported color format: %{public}d", config.colorFormat);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    config_ = config;
     return MSERR_OK;
 }
 
-void FrameConverter::OnFrameAvaiable(GstBuffer &frame)
+void FrameConverter::OnFrameAvaiable(GstSample &sample)
 {
-    (void)frame;
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!started_) {
+        return;
+    }
+
+    // only the latest one is kept, the flushing seek delivers the target frame before the seek done.
+    ClearSampleLocked();
+    lastSample_ = gst_sample_ref(&sample);
+    cond_.notify_all();
 }
 
 int32_t FrameConverter::StartConvert()
 {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ClearSampleLocked();
+    started_ = true;
     return MSERR_OK;
 }
 
 std::shared_ptr<AVSharedMemory> FrameConverter::GetOneFrame()
 {
-    return nullptr;
+    FrameInfo info;
+    int32_t ret = WaitFrame(info);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+
+    int64_t frameSize = static_cast<int64_t>(sizeof(OutputFrame)) +
+        static_cast<int64_t>(info.width) * info.height * info.bytesPerPixel;
+    if (frameSize > INT32_MAX) {
+        MEDIA_LOGE("frame too large");
+        ReleaseHeldSample();
+        return nullptr;
+    }
+    std::shared_ptr<AVSharedMemory> memory = AcquireOutputMemory(static_cast<int32_t>(frameSize));
+    if (memory == nullptr || memory->GetBase() == nullptr) {
+        MEDIA_LOGE("acquire memory failed");
+        ReleaseHeldSample();
+        return nullptr;
+    }
+
+    OutputFrame *frame = new (memory->GetBase()) OutputFrame(info.width, info.height, info.bytesPerPixel);
+    ret = ConvertFrame(frame->GetFlattenedData());
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+    return memory;
 }
 
-int32_t FrameConverter::StopConvert()
+void FrameConverter::DropFrame()
 {
+    ReleaseHeldSample();
+    std::unique_lock<std::mutex> lock(mutex_);
+    ClearSampleLocked();
+}
+
+int32_t FrameConverter::WaitFrame(FrameInfo &info)
+{
+    ReleaseHeldSample();
+
+    GstSample *sample = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool ready = cond_.wait_for(lock, std::chrono::milliseconds(FRAME_WAIT_TIMEOUT_MS),
+            [this]() { return !started_ || lastSample_ != nullptr; });
+        CHECK_AND_RETURN_RET_LOG(ready && lastSample_ != nullptr, MSERR_INVALID_OPERATION, "no frame available");
+        sample = lastSample_;
+        lastSample_ = nullptr;
+    }
+
+    int32_t ret = HoldSample(sample, info);
+    if (ret != MSERR_OK) {
+        gst_sample_unref(sample);
+    }
+    return ret;
+}
+
+int32_t FrameConverter::HoldSample(GstSample *sample, FrameInfo &info)
+{
+    GstCaps *caps = gst_sample_get_caps(sample);
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+    CHECK_AND_RETURN_RET_LOG(caps != nullptr && buffer != nullptr, MSERR_INVALID_VAL, "invalid sample");
+
+    gst_video_info_init(&heldVideoInfo_);
+    CHECK_AND_RETURN_RET_LOG(gst_video_info_from_caps(&heldVideoInfo_, caps), MSERR_INVALID_VAL, "invalid caps");
+
+    CHECK_AND_RETURN_RET_LOG(GetYuvLayout(GST_VIDEO_INFO_FORMAT(&heldVideoInfo_), heldImage_.layout), MSERR_UNSUPPORT,
+        "unsupported video format: %{public}s", GST_VIDEO_INFO_NAME(&heldVideoInfo_));
+    heldImage_.width = GST_VIDEO_INFO_WIDTH(&heldVideoInfo_);
+    heldImage_.height = GST_VIDEO_INFO_HEIGHT(&heldVideoInfo_);
+
+    int32_t ret = InitPixelConverter(heldImage_.width, heldImage_.height, info.width, info.height);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+    info.bytesPerPixel = FramePixelConverter::GetBytesPerPixel(config_.colorFormat);
+
+    GstClockTime pts = GST_BUFFER_PTS(buffer);
+    const GstSegment *segment = gst_sample_get_segment(sample);
+    if (GST_CLOCK_TIME_IS_VALID(pts) && segment != nullptr) {
+        pts = gst_segment_to_stream_time(segment, GST_FORMAT_TIME, pts);
+    }
+    info.ptsUs = GST_CLOCK_TIME_IS_VALID(pts) ? static_cast<int64_t>(pts / GST_USECOND) : -1;
+
+    heldSample_ = sample;
+    heldFrameInfo_ = info;
     return MSERR_OK;
 }
 
-int32_t FrameConverter::Reset()
+int32_t FrameConverter::ConvertFrame(uint8_t *dst)
 {
-    if (pipeline_ != nullptr) {
-        gst_object_unref(pipeline_);
-        pipeline_ = nullptr;
+    CHECK_AND_RETURN_RET_LOG(heldSample_ != nullptr, MSERR_INVALID_OPERATION, "no frame held");
+    CHECK_AND_RETURN_RET_LOG(dst != nullptr, MSERR_INVALID_VAL, "invalid dst");
+
+    GstVideoFrame videoFrame;
+    GstBuffer *buffer = gst_sample_get_buffer(heldSample_);
+    if (!gst_video_frame_map(&videoFrame, &heldVideoInfo_, buffer, GST_MAP_READ)) {
+        MEDIA_LOGE("map video frame failed");
+        ReleaseHeldSample();
+        return MSERR_INVALID_OPERATION;
     }
 
-    if (appSink_ != nullptr) {
-        gst_object_unref(appSink_);
-        appSink_ = nullptr;
+    YuvImage image = heldImage_;
+    for (guint i = 0; i < GST_VIDEO_FRAME_N_PLANES(&videoFrame) && i < sizeof(image.planes) / sizeof(image.planes[0]);
+        i++) {
+        image.planes[i] = static_cast<const uint8_t *>(GST_VIDEO_FRAME_PLANE_DATA(&videoFrame, i));
+        image.strides[i] = GST_VIDEO_FRAME_PLANE_STRIDE(&videoFrame, i);
     }
+    int32_t ret = pixelConverter_.Convert(image, dst, heldFrameInfo_.width * heldFrameInfo_.bytesPerPixel);
+    gst_video_frame_unmap(&videoFrame);
+    ReleaseHeldSample();
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "convert frame failed");
 
-    if (appSrc_ != nullptr) {
-        gst_object_unref(appSrc_);
-        appSrc_ = nullptr;
+    MEDIA_LOGD("frame converted, %{public}dx%{public}d -> %{public}dx%{public}d",
+        image.width, image.height, heldFrameInfo_.width, heldFrameInfo_.height);
+    return MSERR_OK;
+}
+
+void FrameConverter::ReleaseHeldSample()
+{
+    if (heldSample_ != nullptr) {
+        gst_sample_unref(heldSample_);
+        heldSample_ = nullptr;
+    }
+}
+
+int32_t FrameConverter::InitPixelConverter(int32_t srcWidth, int32_t srcHeight, int32_t &dstWidth, int32_t &dstHeight)
+{
+    dstWidth = config_.dstWidth;
+    dstHeight = config_.dstHeight;
+    if (dstWidth <= 0 && dstHeight <= 0) {
+        dstWidth = srcWidth;
+        dstHeight = srcHeight;
+    } else if (dstHeight <= 0) {
+        // keep the aspect ratio if only one dimension is specified.
+        int64_t height = (static_cast<int64_t>(srcHeight) * dstWidth + srcWidth / 2) / srcWidth;
+        dstHeight = static_cast<int32_t>(std::max<int64_t>(std::min<int64_t>(height, INT32_MAX), 1));
+    } else if (dstWidth <= 0) {
+        int64_t width = (static_cast<int64_t>(srcWidth) * dstHeight + srcHeight / 2) / srcHeight;
+        dstWidth = static_cast<int32_t>(std::max<int64_t>(std::min<int64_t>(width, INT32_MAX), 1));
     }
+
+    return pixelConverter_.Init(srcWidth, srcHeight, dstWidth, dstHeight, config_.colorFormat);
+}
+
+int32_t FrameConverter::StopConvert()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    started_ = false;
+    ClearSampleLocked();
+    cond_.notify_all();
     return MSERR_OK;
 }
+
+void FrameConverter::ClearSampleLocked()
+{
+    if (lastSample_ != nullptr) {
+        gst_sample_unref(lastSample_);
+        lastSample_ = nullptr;
+    }
+}
+
+int32_t FrameConverter::Reset()
+{
+    ReleaseHeldSample();
+    return StopConvert();
+}
 }
 }
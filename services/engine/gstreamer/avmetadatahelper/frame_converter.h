@@ -16,32 +16,67 @@
 #ifndef FRAME_CONVERTER_H
 #define FRAME_CONVERTER_H
 
+#include <condition_variable>
+#include <mutex>
 #include <gst/gst.h>
+#include <gst/video/video.h>
 #include "i_avmetadatahelper_service.h"
 #include "frame_callback.h"
-#include "inner_msg_define.h"
-#include "gst_msg_processor.h"
+#include "frame_pixel_converter.h"
 
 namespace OHOS {
 namespace Media {
+/**
+ * Convert the video sample delivered by the appsink into the OutputFrame directly, the scaling
+ * and the color conversion are done in the caller thread of GetOneFrame or ConvertFrame.
+ */
 class FrameConverter : public FrameCallback {
 public:
     FrameConverter();
     ~FrameConverter() override;
 
+    struct FrameInfo {
+        int32_t width = 0; // the output size.
+        int32_t height = 0;
+        int32_t bytesPerPixel = 0;
+        int64_t ptsUs = -1; // the stream time of the frame, -1 if unknown.
+    };
+
     int32_t Init(const OutputConfiguration &config);
-    void OnFrameAvaiable(GstBuffer &frame) override;
+    void OnFrameAvaiable(GstSample &sample) override;
     int32_t StartConvert();
     std::shared_ptr<AVSharedMemory> GetOneFrame();
+
+    // drop the frame delivered before, so that the next WaitFrame gets the one after the next seek.
+    void DropFrame();
+    // wait for the next frame and hold it until ConvertFrame, the output size and pts are filled.
+    int32_t WaitFrame(FrameInfo &info);
+    // convert the held frame into the dst, which is width * height * bytesPerPixel of the FrameInfo.
+    int32_t ConvertFrame(uint8_t *dst);
+
     int32_t StopConvert();
     int32_t Reset();
 
+    DISALLOW_COPY_AND_MOVE(FrameConverter);
+
 private:
-    [[maybe_unused]] OutputConfiguration config_;
-    [[maybe_unused]] GstPipeline *pipeline_ = nullptr;
-    [[maybe_unused]] GstElement *appSink_ = nullptr;
-    [[maybe_unused]] GstElement *appSrc_ = nullptr;
-    [[maybe_unused]] std::unique_ptr<GstMsgProcessor> msgProcessor_;
+    int32_t HoldSample(GstSample *sample, FrameInfo &info);
+    int32_t InitPixelConverter(int32_t srcWidth, int32_t srcHeight, int32_t &dstWidth, int32_t &dstHeight);
+    void ClearSampleLocked();
+    void ReleaseHeldSample();
+
+    OutputConfiguration config_;
+    FramePixelConverter pixelConverter_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    GstSample *lastSample_ = nullptr;
+    bool started_ = false;
+
+    // only accessed in the caller thread.
+    GstSample *heldSample_ = nullptr;
+    GstVideoInfo heldVideoInfo_ {};
+    YuvImage heldImage_;
+    FrameInfo heldFrameInfo_;
 };
 }
 }
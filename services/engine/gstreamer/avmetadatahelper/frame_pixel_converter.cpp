@@ -0,0 +1,436 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_pixel_converter.h"
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include "display_type.h"
+#include "media_errors.h"
+#include "media_log.h"
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FRAME_CONVERTER_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define FRAME_CONVERTER_SSE2
+#endif
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "FramePixelConverter"};
+    constexpr int32_t FILTER_SHIFT = 14;
+    constexpr int32_t FILTER_ONE = 1 << FILTER_SHIFT;
+    constexpr int32_t FILTER_ROUND = 1 << (FILTER_SHIFT - 1);
+    constexpr int32_t MAX_FRAME_SIZE = 8192;
+    constexpr int32_t SIMD_WIDTH = 8;
+
+    // BT.601 limited range, Q10.
+    constexpr int32_t COEF_SHIFT = 10;
+    constexpr int32_t COEF_Y = 1192; // 1.164
+    constexpr int32_t COEF_VR = 1634; // 1.596
+    constexpr int32_t COEF_UG = 401; // 0.391
+    constexpr int32_t COEF_VG = 833; // 0.813
+    constexpr int32_t COEF_UB = 2066; // 2.018
+    constexpr int32_t Y_OFFSET = 16;
+    constexpr int32_t UV_OFFSET = 128;
+    constexpr int32_t MAX_PIXEL = 255;
+    constexpr uint8_t ALPHA_OPAQUE = 0xFF;
+
+    inline uint8_t Clamp255(int32_t val)
+    {
+        return static_cast<uint8_t>(std::min(std::max(val, 0), MAX_PIXEL));
+    }
+
+    // dst[x] = sum(src[t * stride + x] * weights[t]) for the Q14 weights.
+    void VerticalFilter(const uint8_t *src, int32_t stride, const int16_t *weights, int32_t taps,
+        int32_t width, uint8_t *dst)
+    {
+        int32_t x = 0;
+#if defined(FRAME_CONVERTER_NEON)
+        for (; x + SIMD_WIDTH <= width; x += SIMD_WIDTH) {
+            uint32x4_t acc0 = vdupq_n_u32(FILTER_ROUND);
+            uint32x4_t acc1 = vdupq_n_u32(FILTER_ROUND);
+            for (int32_t t = 0; t < taps; t++) {
+                uint16x8_t px = vmovl_u8(vld1_u8(src + static_cast<ptrdiff_t>(t) * stride + x));
+                uint16_t weight = static_cast<uint16_t>(weights[t]);
+                acc0 = vmlal_n_u16(acc0, vget_low_u16(px), weight);
+                acc1 = vmlal_n_u16(acc1, vget_high_u16(px), weight);
+            }
+            uint16x8_t res = vcombine_u16(vshrn_n_u32(acc0, FILTER_SHIFT), vshrn_n_u32(acc1, FILTER_SHIFT));
+            vst1_u8(dst + x, vqmovn_u16(res));
+        }
+#elif defined(FRAME_CONVERTER_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        for (; x + SIMD_WIDTH <= width; x += SIMD_WIDTH) {
+            __m128i acc0 = _mm_set1_epi32(FILTER_ROUND);
+            __m128i acc1 = _mm_set1_epi32(FILTER_ROUND);
+            for (int32_t t = 0; t < taps; t++) {
+                __m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64(
+                    reinterpret_cast<const __m128i *>(src + static_cast<ptrdiff_t>(t) * stride + x)), zero);
+                __m128i weight = _mm_set1_epi16(weights[t]);
+                // the products are less than 2^22, the signed high half is fine.
+                __m128i lo = _mm_mullo_epi16(px, weight);
+                __m128i hi = _mm_mulhi_epi16(px, weight);
+                acc0 = _mm_add_epi32(acc0, _mm_unpacklo_epi16(lo, hi));
+                acc1 = _mm_add_epi32(acc1, _mm_unpackhi_epi16(lo, hi));
+            }
+            acc0 = _mm_srai_epi32(acc0, FILTER_SHIFT);
+            acc1 = _mm_srai_epi32(acc1, FILTER_SHIFT);
+            __m128i res = _mm_packs_epi32(acc0, acc1);
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + x), _mm_packus_epi16(res, res));
+        }
+#endif
+        for (; x < width; x++) {
+            int32_t sum = FILTER_ROUND;
+            for (int32_t t = 0; t < taps; t++) {
+                sum += src[static_cast<ptrdiff_t>(t) * stride + x] * weights[t];
+            }
+            dst[x] = Clamp255(sum >> FILTER_SHIFT);
+        }
+    }
+
+    inline void YuvToRgb(uint8_t y, uint8_t u, uint8_t v, uint8_t &r, uint8_t &g, uint8_t &b)
+    {
+        int32_t c = (static_cast<int32_t>(y) - Y_OFFSET) * COEF_Y;
+        int32_t d = static_cast<int32_t>(u) - UV_OFFSET;
+        int32_t e = static_cast<int32_t>(v) - UV_OFFSET;
+        constexpr int32_t round = 1 << (COEF_SHIFT - 1);
+        r = Clamp255((c + COEF_VR * e + round) >> COEF_SHIFT);
+        g = Clamp255((c - COEF_UG * d - COEF_VG * e + round) >> COEF_SHIFT);
+        b = Clamp255((c + COEF_UB * d + round) >> COEF_SHIFT);
+    }
+
+#if defined(FRAME_CONVERTER_NEON)
+    // the 8 lanes of r, g, b from the 8 pixels of y, u, v.
+    inline void YuvToRgb8(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+        uint8x8_t &r, uint8x8_t &g, uint8x8_t &b)
+    {
+        // (2 * a * b) >> 16 with a = val << 6 and b = coef gives 2 * val * coef in Q0, keeps one fraction bit.
+        constexpr int32_t preShift = 6;
+        int16x8_t c = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y))),
+            vdupq_n_s16(Y_OFFSET)), preShift);
+        int16x8_t d = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u))),
+            vdupq_n_s16(UV_OFFSET)), preShift);
+        int16x8_t e = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v))),
+            vdupq_n_s16(UV_OFFSET)), preShift);
+        int16x8_t yy = vqdmulhq_n_s16(c, COEF_Y);
+        int16x8_t rr = vaddq_s16(yy, vqdmulhq_n_s16(e, COEF_VR));
+        int16x8_t gg = vsubq_s16(vsubq_s16(yy, vqdmulhq_n_s16(d, COEF_UG)), vqdmulhq_n_s16(e, COEF_VG));
+        int16x8_t bb = vaddq_s16(yy, vqdmulhq_n_s16(d, COEF_UB));
+        r = vqmovun_s16(vrshrq_n_s16(rr, 1));
+        g = vqmovun_s16(vrshrq_n_s16(gg, 1));
+        b = vqmovun_s16(vrshrq_n_s16(bb, 1));
+    }
+#elif defined(FRAME_CONVERTER_SSE2)
+    // the 8 lanes of r, g, b in 16 bits, clamped to [0, 255].
+    inline void YuvToRgb8(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+        __m128i &r, __m128i &g, __m128i &b)
+    {
+        // (a * b) >> 16 with a = val << 7 and b = coef gives 2 * val * coef in Q0, keeps one fraction bit.
+        constexpr int32_t preShift = 7;
+        const __m128i zero = _mm_setzero_si128();
+        __m128i c = _mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i *>(y)), zero), _mm_set1_epi16(Y_OFFSET)), preShift);
+        __m128i d = _mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i *>(u)), zero), _mm_set1_epi16(UV_OFFSET)), preShift);
+        __m128i e = _mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i *>(v)), zero), _mm_set1_epi16(UV_OFFSET)), preShift);
+        __m128i yy = _mm_mulhi_epi16(c, _mm_set1_epi16(COEF_Y));
+        __m128i rr = _mm_add_epi16(yy, _mm_mulhi_epi16(e, _mm_set1_epi16(COEF_VR)));
+        __m128i gg = _mm_sub_epi16(_mm_sub_epi16(yy, _mm_mulhi_epi16(d, _mm_set1_epi16(COEF_UG))),
+            _mm_mulhi_epi16(e, _mm_set1_epi16(COEF_VG)));
+        __m128i bb = _mm_add_epi16(yy, _mm_mulhi_epi16(d, _mm_set1_epi16(COEF_UB)));
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i maxPixel = _mm_set1_epi16(MAX_PIXEL);
+        r = _mm_min_epi16(_mm_max_epi16(_mm_srai_epi16(_mm_add_epi16(rr, one), 1), zero), maxPixel);
+        g = _mm_min_epi16(_mm_max_epi16(_mm_srai_epi16(_mm_add_epi16(gg, one), 1), zero), maxPixel);
+        b = _mm_min_epi16(_mm_max_epi16(_mm_srai_epi16(_mm_add_epi16(bb, one), 1), zero), maxPixel);
+    }
+#endif
+
+    void YuvRowToRgba(const uint8_t *y, const uint8_t *u, const uint8_t *v, int32_t width, uint8_t *dst)
+    {
+        int32_t x = 0;
+#if defined(FRAME_CONVERTER_NEON)
+        for (; x + SIMD_WIDTH <= width; x += SIMD_WIDTH) {
+            uint8x8x4_t rgba;
+            YuvToRgb8(y + x, u + x, v + x, rgba.val[0], rgba.val[1], rgba.val[2]);
+            rgba.val[3] = vdup_n_u8(ALPHA_OPAQUE); // 3: alpha
+            vst4_u8(dst + x * 4, rgba); // 4: bytes per pixel
+        }
+#elif defined(FRAME_CONVERTER_SSE2)
+        for (; x + SIMD_WIDTH <= width; x += SIMD_WIDTH) {
+            __m128i r;
+            __m128i g;
+            __m128i b;
+            YuvToRgb8(y + x, u + x, v + x, r, g, b);
+            __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8)); // 8: g in the high byte
+            __m128i ba = _mm_or_si128(b, _mm_set1_epi16(static_cast<int16_t>(0xFF00)));
+            __m128i *out = reinterpret_cast<__m128i *>(dst + x * 4); // 4: bytes per pixel
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(rg, ba));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(rg, ba));
+        }
+#endif
+        for (; x < width; x++) {
+            uint8_t *px = dst + x * 4; // 4: bytes per pixel
+            YuvToRgb(y[x], u[x], v[x], px[0], px[1], px[2]); // 0, 1, 2: r, g, b
+            px[3] = ALPHA_OPAQUE; // 3: alpha
+        }
+    }
+
+    void YuvRowToRgb565(const uint8_t *y, const uint8_t *u, const uint8_t *v, int32_t width, uint8_t *dst)
+    {
+        uint16_t *out = reinterpret_cast<uint16_t *>(dst);
+        int32_t x = 0;
+#if defined(FRAME_CONVERTER_NEON)
+        for (; x + SIMD_WIDTH <= width; x += SIMD_WIDTH) {
+            uint8x8_t r;
+            uint8x8_t g;
+            uint8x8_t b;
+            YuvToRgb8(y + x, u + x, v + x, r, g, b);
+            uint16x8_t px = vshll_n_u8(r, 8); // 8: r in the high byte
+            px = vsriq_n_u16(px, vshll_n_u8(g, 8), 5); // keep 5 bits of r, 6 bits of g follow
+            px = vsriq_n_u16(px, vshll_n_u8(b, 8), 11); // keep 5 + 6 bits, 5 bits of b follow
+            vst1q_u16(out + x, px);
+        }
+#elif defined(FRAME_CONVERTER_SSE2)
+        for (; x + SIMD_WIDTH <= width; x += SIMD_WIDTH) {
+            __m128i r;
+            __m128i g;
+            __m128i b;
+            YuvToRgb8(y + x, u + x, v + x, r, g, b);
+            __m128i px = _mm_slli_epi16(_mm_and_si128(r, _mm_set1_epi16(0xF8)), 8); // 8: 5 bits of r at 11
+            px = _mm_or_si128(px, _mm_slli_epi16(_mm_and_si128(g, _mm_set1_epi16(0xFC)), 3)); // 3: 6 bits at 5
+            px = _mm_or_si128(px, _mm_srli_epi16(b, 3)); // 3: 5 bits of b at 0
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), px);
+        }
+#endif
+        for (; x < width; x++) {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+            YuvToRgb(y[x], u[x], v[x], r, g, b);
+            // 8, 3: shift the 5 bits of r to 11, 6 bits of g to 5, and 5 bits of b to 0.
+            out[x] = static_cast<uint16_t>(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+        }
+    }
+}
+
+namespace OHOS {
+namespace Media {
+int32_t FramePixelConverter::GetBytesPerPixel(int32_t pixelFormat)
+{
+    switch (pixelFormat) {
+        case PIXEL_FMT_RGBA_8888:
+            return 4; // 4: r, g, b, a
+        case PIXEL_FMT_RGB_565:
+            return 2; // 2: 16 bits
+        default:
+            return 0;
+    }
+}
+
+int32_t FramePixelConverter::Init(int32_t srcWidth, int32_t srcHeight, int32_t dstWidth, int32_t dstHeight,
+    int32_t pixelFormat)
+{
+    CHECK_AND_RETURN_RET_LOG(srcWidth > 0 && srcHeight > 0 && srcWidth <= MAX_FRAME_SIZE &&
+        srcHeight <= MAX_FRAME_SIZE, MSERR_INVALID_VAL, "invalid src size %{public}dx%{public}d", srcWidth, srcHeight);
+    CHECK_AND_RETURN_RET_LOG(dstWidth > 0 && dstHeight > 0 && dstWidth <= MAX_FRAME_SIZE &&
+        dstHeight <= MAX_FRAME_SIZE, MSERR_INVALID_VAL, "invalid dst size %{public}dx%{public}d", dstWidth, dstHeight);
+    CHECK_AND_RETURN_RET_LOG(GetBytesPerPixel(pixelFormat) != 0, MSERR_UNSUPPORT,
+        "unsupported pixel format: %{public}d", pixelFormat);
+
+    if (srcWidth == srcWidth_ && srcHeight == srcHeight_ && dstWidth == dstWidth_ &&
+        dstHeight == dstHeight_ && pixelFormat == pixelFormat_) {
+        return MSERR_OK;
+    }
+
+    int32_t chromaWidth = (srcWidth + 1) / 2;
+    int32_t chromaHeight = (srcHeight + 1) / 2;
+    BuildFilter(srcWidth, dstWidth, lumaCols_);
+    BuildFilter(srcHeight, dstHeight, lumaRows_);
+    BuildFilter(chromaWidth, dstWidth, chromaCols_);
+    BuildFilter(chromaHeight, dstHeight, chromaRows_);
+
+    lumaLine_.resize(srcWidth);
+    chromaLine0_.resize(chromaWidth * 2); // 2: the interleaved u and v
+    chromaLine1_.resize(chromaWidth);
+    rowY_.resize(dstWidth);
+    rowU_.resize(dstWidth);
+    rowV_.resize(dstWidth);
+
+    srcWidth_ = srcWidth;
+    srcHeight_ = srcHeight;
+    dstWidth_ = dstWidth;
+    dstHeight_ = dstHeight;
+    pixelFormat_ = pixelFormat;
+    MEDIA_LOGD("src %{public}dx%{public}d, dst %{public}dx%{public}d, format %{public}d, taps %{public}d/%{public}d",
+        srcWidth, srcHeight, dstWidth, dstHeight, pixelFormat, lumaCols_.maxTaps, lumaRows_.maxTaps);
+    return MSERR_OK;
+}
+
+void FramePixelConverter::BuildFilter(int32_t srcSize, int32_t dstSize, FilterTable &table)
+{
+    double scale = static_cast<double>(srcSize) / dstSize;
+    // bilinear needs 2 taps, the area of the scale covers at most ceil(scale) + 1 source pixels.
+    table.maxTaps = (scale <= 1.0) ? 2 : static_cast<int32_t>(std::ceil(scale)) + 1; // 2: bilinear taps
+    table.starts.assign(dstSize, 0);
+    table.counts.assign(dstSize, 0);
+    table.weights.assign(static_cast<size_t>(dstSize) * table.maxTaps, 0);
+    table.identity = (srcSize == dstSize);
+
+    std::vector<double> coverage(table.maxTaps);
+    for (int32_t i = 0; i < dstSize; i++) {
+        int32_t first = 0;
+        int32_t count = 0;
+        if (scale <= 1.0) {
+            double center = (i + 0.5) * scale - 0.5; // 0.5: the pixel center
+            center = std::min(std::max(center, 0.0), static_cast<double>(srcSize - 1));
+            first = static_cast<int32_t>(std::floor(center));
+            double frac = center - first;
+            coverage[0] = 1.0 - frac;
+            coverage[1] = frac;
+            count = (first + 1 < srcSize) ? 2 : 1; // 2: bilinear taps
+        } else {
+            double begin = i * scale;
+            double end = std::min((i + 1) * scale, static_cast<double>(srcSize));
+            first = static_cast<int32_t>(std::floor(begin));
+            int32_t last = std::min(static_cast<int32_t>(std::ceil(end)), srcSize);
+            count = std::min(last - first, table.maxTaps);
+            for (int32_t t = 0; t < count; t++) {
+                double lo = std::max(begin, static_cast<double>(first + t));
+                double hi = std::min(end, static_cast<double>(first + t + 1));
+                coverage[t] = std::max(hi - lo, 0.0) / (end - begin);
+            }
+        }
+
+        // quantize, and make the weights sum to exactly one by adjusting the largest one.
+        int16_t *weights = &table.weights[static_cast<size_t>(i) * table.maxTaps];
+        int32_t sum = 0;
+        int32_t largest = 0;
+        for (int32_t t = 0; t < count; t++) {
+            weights[t] = static_cast<int16_t>(std::lround(coverage[t] * FILTER_ONE));
+            sum += weights[t];
+            largest = (weights[t] > weights[largest]) ? t : largest;
+        }
+        weights[largest] = static_cast<int16_t>(weights[largest] + FILTER_ONE - sum);
+
+        // drop the zero weights at both ends.
+        while (count > 1 && weights[count - 1] == 0) {
+            count--;
+        }
+        int32_t skip = 0;
+        while (skip < count - 1 && weights[skip] == 0) {
+            skip++;
+        }
+        if (skip > 0) {
+            (void)std::copy(weights + skip, weights + count, weights);
+            count -= skip;
+            first += skip;
+        }
+        table.starts[i] = first;
+        table.counts[i] = count;
+    }
+}
+
+const uint8_t *FramePixelConverter::FilterRows(const uint8_t *plane, int32_t stride, int32_t rowBytes,
+    const FilterTable &table, int32_t dstRow, std::vector<uint8_t> &line)
+{
+    const uint8_t *first = plane + static_cast<ptrdiff_t>(table.starts[dstRow]) * stride;
+    int32_t count = table.counts[dstRow];
+    if (count == 1) {
+        return first;
+    }
+
+    VerticalFilter(first, stride, &table.weights[static_cast<size_t>(dstRow) * table.maxTaps], count,
+        rowBytes, line.data());
+    return line.data();
+}
+
+void FramePixelConverter::FilterCols(const uint8_t *src, int32_t pixelStride, const FilterTable &table,
+    int32_t dstSize, uint8_t *dst)
+{
+    if (table.identity) {
+        for (int32_t i = 0; i < dstSize; i++) {
+            dst[i] = src[i * pixelStride];
+        }
+        return;
+    }
+
+    for (int32_t i = 0; i < dstSize; i++) {
+        const uint8_t *px = src + table.starts[i] * pixelStride;
+        const int16_t *weights = &table.weights[static_cast<size_t>(i) * table.maxTaps];
+        int32_t sum = FILTER_ROUND;
+        for (int32_t t = 0; t < table.counts[i]; t++) {
+            sum += px[t * pixelStride] * weights[t];
+        }
+        dst[i] = Clamp255(sum >> FILTER_SHIFT);
+    }
+}
+
+void FramePixelConverter::ConvertRow(uint8_t *dst) const
+{
+    if (pixelFormat_ == PIXEL_FMT_RGBA_8888) {
+        YuvRowToRgba(rowY_.data(), rowU_.data(), rowV_.data(), dstWidth_, dst);
+    } else {
+        YuvRowToRgb565(rowY_.data(), rowU_.data(), rowV_.data(), dstWidth_, dst);
+    }
+}
+
+int32_t FramePixelConverter::Convert(const YuvImage &src, uint8_t *dst, int32_t dstStride)
+{
+    CHECK_AND_RETURN_RET_LOG(pixelFormat_ != -1, MSERR_INVALID_OPERATION, "not inited");
+    CHECK_AND_RETURN_RET_LOG(src.width == srcWidth_ && src.height == srcHeight_, MSERR_INVALID_VAL,
+        "src size %{public}dx%{public}d mismatch", src.width, src.height);
+    CHECK_AND_RETURN_RET_LOG(dst != nullptr && dstStride >= dstWidth_ * GetBytesPerPixel(pixelFormat_),
+        MSERR_INVALID_VAL, "invalid dst");
+
+    bool semiPlanar = (src.layout == YUV_LAYOUT_NV12 || src.layout == YUV_LAYOUT_NV21);
+    size_t planeNum = semiPlanar ? 2 : 3; // 2: y and uv, 3: y, u and v
+    for (size_t i = 0; i < planeNum; i++) {
+        CHECK_AND_RETURN_RET_LOG(src.planes[i] != nullptr && src.strides[i] > 0, MSERR_INVALID_VAL,
+            "invalid plane %{public}zu", i);
+    }
+
+    int32_t chromaWidth = (srcWidth_ + 1) / 2;
+    // the indexes of u and v in the planes, and the offsets of them in the interleaved chroma.
+    size_t uPlane = (src.layout == YUV_LAYOUT_YV12) ? 2 : 1; // 2: v before u
+    size_t vPlane = (src.layout == YUV_LAYOUT_YV12) ? 1 : 2; // 2: v after u
+    int32_t uOffset = (src.layout == YUV_LAYOUT_NV21) ? 1 : 0;
+
+    for (int32_t row = 0; row < dstHeight_; row++) {
+        const uint8_t *luma = FilterRows(src.planes[0], src.strides[0], srcWidth_, lumaRows_, row, lumaLine_);
+        FilterCols(luma, 1, lumaCols_, dstWidth_, rowY_.data());
+
+        if (semiPlanar) {
+            const uint8_t *chroma = FilterRows(src.planes[1], src.strides[1], chromaWidth * 2, // 2: u and v
+                chromaRows_, row, chromaLine0_);
+            FilterCols(chroma + uOffset, 2, chromaCols_, dstWidth_, rowU_.data()); // 2: interleaved
+            FilterCols(chroma + (1 - uOffset), 2, chromaCols_, dstWidth_, rowV_.data()); // 2: interleaved
+        } else {
+            const uint8_t *chromaU = FilterRows(src.planes[uPlane], src.strides[uPlane], chromaWidth,
+                chromaRows_, row, chromaLine0_);
+            FilterCols(chromaU, 1, chromaCols_, dstWidth_, rowU_.data());
+            const uint8_t *chromaV = FilterRows(src.planes[vPlane], src.strides[vPlane], chromaWidth,
+                chromaRows_, row, chromaLine1_);
+            FilterCols(chromaV, 1, chromaCols_, dstWidth_, rowV_.data());
+        }
+
+        ConvertRow(dst + static_cast<ptrdiff_t>(row) * dstStride);
+    }
+    return MSERR_OK;
+}
+} // namespace Media
+} // namespace OHOS
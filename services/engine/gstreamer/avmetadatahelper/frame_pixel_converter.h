@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAME_PIXEL_CONVERTER_H
+#define FRAME_PIXEL_CONVERTER_H
+
+#include <cstdint>
+#include <vector>
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+enum YuvLayout : uint8_t {
+    YUV_LAYOUT_I420,
+    YUV_LAYOUT_YV12,
+    YUV_LAYOUT_NV12,
+    YUV_LAYOUT_NV21,
+};
+
+struct YuvImage {
+    YuvLayout layout = YUV_LAYOUT_I420;
+    int32_t width = 0;
+    int32_t height = 0;
+    // Y, U, V planes for I420, Y, V, U for YV12, Y and the interleaved chroma for NV12/NV21.
+    const uint8_t *planes[3] = { nullptr, nullptr, nullptr };
+    int32_t strides[3] = { 0, 0, 0 };
+};
+
+/**
+ * Scale a YUV 4:2:0 image and convert it to RGBA8888 or RGB565 in one pass, row by row.
+ *
+ * The scaling is separable, bilinear for upscaling and area averaging for downscaling, the
+ * filter tables are built at Init. Each output row is filtered vertically from the source
+ * rows, then horizontally to the output width, and then converted by BT.601 limited range
+ * into the destination. The vertical filter and the color conversion are vectorized by NEON
+ * or SSE2 when available.
+ */
+class FramePixelConverter {
+public:
+    FramePixelConverter() = default;
+    ~FramePixelConverter() = default;
+
+    // the pixelFormat is PIXEL_FMT_RGBA_8888 or PIXEL_FMT_RGB_565, reinit is skipped for the same arguments.
+    int32_t Init(int32_t srcWidth, int32_t srcHeight, int32_t dstWidth, int32_t dstHeight, int32_t pixelFormat);
+    int32_t Convert(const YuvImage &src, uint8_t *dst, int32_t dstStride);
+
+    // return 0 for the unsupported pixel format.
+    static int32_t GetBytesPerPixel(int32_t pixelFormat);
+
+    DISALLOW_COPY_AND_MOVE(FramePixelConverter);
+
+private:
+    struct FilterTable {
+        bool identity = false;
+        int32_t maxTaps = 0;
+        std::vector<int32_t> starts; // the first source index of each output index.
+        std::vector<int32_t> counts;
+        std::vector<int16_t> weights; // maxTaps weights for each output index, Q14.
+    };
+
+    static void BuildFilter(int32_t srcSize, int32_t dstSize, FilterTable &table);
+    static const uint8_t *FilterRows(const uint8_t *plane, int32_t stride, int32_t rowBytes,
+        const FilterTable &table, int32_t dstRow, std::vector<uint8_t> &line);
+    static void FilterCols(const uint8_t *src, int32_t pixelStride, const FilterTable &table,
+        int32_t dstSize, uint8_t *dst);
+    void ConvertRow(uint8_t *dst) const;
+
+    int32_t srcWidth_ = 0;
+    int32_t srcHeight_ = 0;
+    int32_t dstWidth_ = 0;
+    int32_t dstHeight_ = 0;
+    int32_t pixelFormat_ = -1;
+    FilterTable lumaCols_;
+    FilterTable lumaRows_;
+    FilterTable chromaCols_;
+    FilterTable chromaRows_;
+    std::vector<uint8_t> lumaLine_;
+    std::vector<uint8_t> chromaLine0_;
+    std::vector<uint8_t> chromaLine1_;
+    std::vector<uint8_t> rowY_;
+    std::vector<uint8_t> rowU_;
+    std::vector<uint8_t> rowV_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // FRAME_PIXEL_CONVERTER_H
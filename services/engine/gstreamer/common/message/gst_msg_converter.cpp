@@ -98,12 +98,32 @@ static int32_t ConvertStateChangedMessage(GstMessage &gstMsg, InnerMessage &inne
     return MSERR_OK;
 }
 
+static int32_t ConvertAsyncDoneMessage(GstMessage &gstMsg, InnerMessage &innerMsg)
+{
+    (void)gstMsg;
+    innerMsg.type = INNER_MSG_ASYNC_DONE;
+    return MSERR_OK;
+}
+
+static int32_t ConvertStepDoneMessage(GstMessage &gstMsg, InnerMessage &innerMsg)
+{
+    GstFormat format = GST_FORMAT_UNDEFINED;
+    guint64 amount = 0;
+    gst_message_parse_step_done(&gstMsg, &format, &amount, nullptr, nullptr, nullptr, nullptr, nullptr);
+    MEDIA_LOGD("step done, format: %{public}d, amount: %{public}" PRIu64 "", format, amount);
+
+    innerMsg.type = INNER_MSG_STEP_DONE;
+    return MSERR_OK;
+}
+
 using MsgConvFunc = std::function<int32_t(GstMessage&, InnerMessage&)>;
 static const std::unordered_map<GstMessageType, MsgConvFunc> MSG_CONV_FUNC_TABLE = {
     { GST_MESSAGE_ERROR, ConvertErrorMessage },
     { GST_MESSAGE_WARNING, ConvertWarningMessage },
     { GST_MESSAGE_INFO, ConvertInfoMessage },
     { GST_MESSAGE_STATE_CHANGED, ConvertStateChangedMessage },
+    { GST_MESSAGE_ASYNC_DONE, ConvertAsyncDoneMessage },
+    { GST_MESSAGE_STEP_DONE, ConvertStepDoneMessage },
 };
 
 int32_t GstMsgConverterDefault::ConvertToInnerMsg(GstMessage &gstMsg, InnerMessage &innerMsg) const
@@ -221,7 +221,8 @@ void GstMsgProcessor::ProcessGstMessage(GstMessage &msg)
         return; // ignore.
     }
 
-    if (innerMsg.type != InnerMsgType::INNER_MSG_ERROR) {
+    // the step done is posted by the sink that performs the step, not by the pipeline.
+    if (innerMsg.type != InnerMsgType::INNER_MSG_ERROR && innerMsg.type != InnerMsgType::INNER_MSG_STEP_DONE) {
         gchar *srcName = GST_OBJECT_NAME(GST_MESSAGE_SRC(&msg));
         if (srcName == nullptr) {
             return;
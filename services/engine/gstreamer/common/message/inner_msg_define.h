@@ -31,6 +31,8 @@ enum InnerMsgType : int32_t {
     INNER_MSG_STATE_CHANGED,
     INNER_MSG_SEEK_DONE,
     INNER_MSG_BUFFERING,
+    INNER_MSG_ASYNC_DONE,
+    INNER_MSG_STEP_DONE,
 };
 
 struct InnerMessage {
@@ -50,7 +50,16 @@ public:
     virtual int32_t Play() = 0; // async
     virtual int32_t Pause() = 0; // async
     virtual int32_t Seek(int64_t timeUs, int32_t seekOption) = 0; // async
+    // decode forward from the current position without flushing, the seek done is reported when finished.
+    virtual int32_t Step(int64_t amountUs) = 0; // async
     virtual int32_t Stop() = 0; // async
+    /**
+     * Release the current source and go back to the idle state, but keep the threads and the playbin,
+     * so that the next source is set up without creating them again. The sink provider, the element
+     * setup listener, the scene and the source need to be set again. If it fails, the ctrler can not
+     * be reused anymore.
+     */
+    virtual int32_t Recycle() = 0; // sync
 
     using ElemSetupListener = std::function<void(GstElement &elem)>;
     virtual void SetElemSetupListener(ElemSetupListener listener) = 0;
@@ -22,6 +22,8 @@
 #include "scope_guard.h"
 #include "playbin_state.h"
 #include "gst_utils.h"
+#include "inline_task_handler.h"
+#include "avmetadatahelper.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "PlayBinCtrlerBase"};
@@ -71,7 +73,7 @@ int32_t PlayBinCtrlerBase::Init()
     int32_t ret = taskQueue_->Start();
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
-    msgQueue_ = std::make_unique<TaskQueue>("playbin-ctrl-msg");
+    msgQueue_ = std::make_unique<TaskQueue>("playbin-ctrl-msg", TaskQueue::SHARED_POOL);
     ret = msgQueue_->Start();
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
@@ -116,7 +118,8 @@ int32_t PlayBinCtrlerBase::SetScene(PlayBinScene scene)
 int32_t PlayBinCtrlerBase::SetSource(const std::string &uri)
 {
     UriHelper uriHeper = UriHelper(uri).FormatMe();
-    if ((uriHeper.UriType() != UriHelper::URI_TYPE_FILE) || !uriHeper.AccessCheck(UriHelper::URI_READ)) {
+    if ((uriHeper.UriType() != UriHelper::URI_TYPE_FILE && uriHeper.UriType() != UriHelper::URI_TYPE_FD) ||
+        !uriHeper.AccessCheck(UriHelper::URI_READ)) {
         MEDIA_LOGE("Invalid uri : %{public}s", uri.c_str());
         return MSERR_UNSUPPORT;
     }
@@ -223,6 +226,22 @@ int32_t PlayBinCtrlerBase::Seek(int64_t timeUs, int32_t seekOption)
     return MSERR_OK;
 }
 
+int32_t PlayBinCtrlerBase::Step(int64_t amountUs)
+{
+    MEDIA_LOGD("enter");
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto stepTask = std::make_shared<TaskHandler<void>>([this, amountUs]() {
+        auto currState = std::static_pointer_cast<BaseState>(GetCurrState());
+        (void)currState->Step(amountUs);
+    });
+
+    int ret = taskQueue_->EnqueueTask(stepTask);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Step failed");
+
+    return MSERR_OK;
+}
+
 int32_t PlayBinCtrlerBase::Stop()
 {
     MEDIA_LOGD("enter");
@@ -243,6 +262,57 @@ int32_t PlayBinCtrlerBase::Stop()
     return MSERR_OK;
 }
 
+int32_t PlayBinCtrlerBase::Recycle()
+{
+    MEDIA_LOGD("enter");
+
+    auto recycleTask = std::make_shared<TaskHandler<int32_t>>([this]() {
+        isSeeking_ = false;
+        isStepping_ = false;
+        ChangeState(idleState_);
+        if (playbin_ == nullptr) {
+            return MSERR_OK;
+        }
+
+        // the messages of the previous source are dropped while the bus is flushing.
+        msgProcessor_->FlushBegin();
+        GstStateChangeReturn ret = gst_element_set_state(GST_ELEMENT_CAST(playbin_), GST_STATE_NULL);
+        msgProcessor_->FlushEnd();
+        CHECK_AND_RETURN_RET_LOG(ret != GST_STATE_CHANGE_FAILURE, MSERR_UNKNOWN, "Failed to change playbin to null");
+
+        // the sinks reference the frame callbacks of the previous source.
+        g_object_set(playbin_, "audio-sink", nullptr, "video-sink", nullptr, nullptr);
+        return MSERR_OK;
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        int32_t ret = taskQueue_->EnqueueTask(recycleTask);
+        CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Recycle failed");
+    }
+
+    // not wait in the lock, the streaming threads may be setting up elements until the playbin is null.
+    auto result = recycleTask->GetResult();
+    CHECK_AND_RETURN_RET_LOG(result.HasResult() && result.Value() == MSERR_OK, MSERR_UNKNOWN, "Recycle failed");
+
+    // deliver the pending reports to the previous notifier before the next source.
+    auto drainTask = std::make_shared<TaskHandler<void>>([]() {});
+    int32_t ret = msgQueue_->EnqueueTask(drainTask);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Recycle failed");
+    (void)drainTask->GetResult();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    isInitialized = false;
+    currScene_ = PlayBinScene::UNKNOWN;
+    uri_.clear();
+    preparedTask_ = nullptr;
+    sinkProvider_ = nullptr;
+    elemSetupListener_ = nullptr;
+
+    MEDIA_LOGD("exit");
+    return MSERR_OK;
+}
+
 void PlayBinCtrlerBase::Reset() noexcept
 {
     MEDIA_LOGD("enter");
@@ -346,6 +416,78 @@ void PlayBinCtrlerBase::SetupCustomElement()
     }
 }
 
+int32_t PlayBinCtrlerBase::SeekInternal(int64_t timeUs, int32_t seekOption)
+{
+    static const std::unordered_map<int32_t, int32_t> SEEK_FLAGS = {
+        { AV_META_QUERY_NEXT_SYNC, GST_SEEK_FLAG_SNAP_AFTER | GST_SEEK_FLAG_KEY_UNIT },
+        { AV_META_QUERY_PREVIOUS_SYNC, GST_SEEK_FLAG_SNAP_BEFORE | GST_SEEK_FLAG_KEY_UNIT },
+        { AV_META_QUERY_CLOSEST_SYNC, GST_SEEK_FLAG_SNAP_NEAREST | GST_SEEK_FLAG_KEY_UNIT },
+        { AV_META_QUERY_CLOSEST, GST_SEEK_FLAG_ACCURATE },
+    };
+
+    auto it = SEEK_FLAGS.find(seekOption);
+    if (it == SEEK_FLAGS.end() || timeUs < 0) {
+        MEDIA_LOGE("invalid seek, time: %{public}" PRIi64 ", option: %{public}d", timeUs, seekOption);
+        ReportSeekDone(MSERR_INVALID_VAL);
+        return MSERR_INVALID_VAL;
+    }
+
+    MEDIA_LOGI("seek to %{public}" PRIi64 " us, option: %{public}d", timeUs, seekOption);
+    auto flags = static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH | it->second);
+    constexpr int64_t nsPerUs = 1000;
+    if (!gst_element_seek_simple(GST_ELEMENT_CAST(playbin_), GST_FORMAT_TIME, flags, timeUs * nsPerUs)) {
+        MEDIA_LOGE("seek failed");
+        ReportSeekDone(MSERR_INVALID_OPERATION);
+        return MSERR_INVALID_OPERATION;
+    }
+
+    // the pipeline prerolls again after the flushing seek, the async done means the seek finished.
+    isSeeking_ = true;
+    isStepping_ = false;
+    return MSERR_OK;
+}
+
+int32_t PlayBinCtrlerBase::StepInternal(int64_t amountUs)
+{
+    if (amountUs <= 0) {
+        MEDIA_LOGE("invalid step amount: %{public}" PRIi64 "", amountUs);
+        ReportSeekDone(MSERR_INVALID_VAL);
+        return MSERR_INVALID_VAL;
+    }
+
+    // only step the video sink, otherwise each sink posts its own step done.
+    GstElement *videoSink = nullptr;
+    g_object_get(playbin_, "video-sink", &videoSink, nullptr);
+    if (videoSink == nullptr) {
+        MEDIA_LOGE("no video sink to step");
+        ReportSeekDone(MSERR_INVALID_OPERATION);
+        return MSERR_INVALID_OPERATION;
+    }
+
+    constexpr int64_t nsPerUs = 1000;
+    GstEvent *event = gst_event_new_step(GST_FORMAT_TIME, static_cast<guint64>(amountUs * nsPerUs), 1.0, TRUE, FALSE);
+    gboolean sent = gst_element_send_event(videoSink, event);
+    gst_object_unref(videoSink);
+    if (!sent) {
+        MEDIA_LOGE("step failed");
+        ReportSeekDone(MSERR_INVALID_OPERATION);
+        return MSERR_INVALID_OPERATION;
+    }
+
+    MEDIA_LOGD("step %{public}" PRIi64 " us", amountUs);
+    isStepping_ = true;
+    isSeeking_ = false;
+    return MSERR_OK;
+}
+
+void PlayBinCtrlerBase::ReportSeekDone(int32_t code)
+{
+    isSeeking_ = false;
+    isStepping_ = false;
+    PlayBinMessage msg = { PLAYBIN_MSG_SEEKDONE, 0, code, {} };
+    ReportMessage(msg);
+}
+
 int32_t PlayBinCtrlerBase::SetupSignalMessage()
 {
     MEDIA_LOGD("SetupSignalMessage enter");
@@ -402,7 +544,7 @@ void PlayBinCtrlerBase::DeferTask(const std::shared_ptr<TaskHandler<void>> &task
 
 void PlayBinCtrlerBase::OnMessageReceived(const InnerMessage &msg)
 {
-    auto msgHandler = std::make_shared<TaskHandler<void>>([this, msg]() { HandleMessage(msg); });
+    auto msgHandler = InlineTaskHandler::Create([this, msg]() { HandleMessage(msg); });
     int32_t ret = taskQueue_->EnqueueTask(msgHandler);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("sync process msg failed, type: %{public}d, detail1: %{public}d, detail2: %{public}d",
@@ -412,7 +554,7 @@ void PlayBinCtrlerBase::OnMessageReceived(const InnerMessage &msg)
 
 void PlayBinCtrlerBase::ReportMessage(const PlayBinMessage &msg)
 {
-    auto msgReportHandler = std::make_shared<TaskHandler<void>>([this, msg]() { notifier_(msg); });
+    auto msgReportHandler = InlineTaskHandler::Create([this, msg]() { notifier_(msg); });
     int32_t ret = msgQueue_->EnqueueTask(msgReportHandler);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("async report msg failed, type: %{public}d, subType: %{public}d, code: %{public}d",
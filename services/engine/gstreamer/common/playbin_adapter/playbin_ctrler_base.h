@@ -48,7 +48,9 @@ public:
     int32_t Play() override;
     int32_t Pause() override;
     int32_t Seek(int64_t timeUs, int32_t seekOption) override;
+    int32_t Step(int64_t amountUs) override;
     int32_t Stop() override;
+    int32_t Recycle() override;
     void SetElemSetupListener(ElemSetupListener listener) final;
 
 protected:
@@ -69,6 +71,9 @@ private:
     std::string GetSource();
     int32_t EnterInitializedState();
     void SetupCustomElement();
+    int32_t SeekInternal(int64_t timeUs, int32_t seekOption);
+    int32_t StepInternal(int64_t amountUs);
+    void ReportSeekDone(int32_t code);
     int32_t SetupSignalMessage();
     void DeferTask(const std::shared_ptr<TaskHandler<void>> &task, int64_t delayNs = 0);
     static void ElementSetup(const GstElement *playbin, GstElement *elem, gpointer userdata);
@@ -87,7 +92,11 @@ private:
     PlayBinScene currScene_ = PlayBinScene::UNKNOWN;
     std::string uri_;
     bool isInitialized = false;
+    uint32_t defaultPlayFlags_ = 0; // the playbin flags at creation, restored for each source.
     std::shared_ptr<TaskHandler<int32_t>> preparedTask_;
+    // only accessed in the task queue.
+    bool isSeeking_ = false;
+    bool isStepping_ = false;
 
     std::shared_ptr<IdleState> idleState_;
     std::shared_ptr<InitializedState> initializedState_;
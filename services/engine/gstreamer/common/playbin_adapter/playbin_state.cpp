@@ -56,6 +56,16 @@ int32_t PlayBinCtrlerBase::BaseState::Seek(int64_t timeUs, int32_t option)
     (void)option;
 
     MEDIA_LOGE("invalid state");
+    ctrler_.ReportSeekDone(MSERR_INVALID_STATE);
+    return MSERR_INVALID_STATE;
+}
+
+int32_t PlayBinCtrlerBase::BaseState::Step(int64_t amountUs)
+{
+    (void)amountUs;
+
+    MEDIA_LOGE("invalid state");
+    ctrler_.ReportSeekDone(MSERR_INVALID_STATE);
     return MSERR_INVALID_STATE;
 }
 
@@ -74,7 +84,15 @@ void PlayBinCtrlerBase::BaseState::OnMessageReceived(const InnerMessage &msg)
         Dumper::DumpDotGraph(*ctrler_.playbin_, msg.detail1, msg.detail2);
     }
 
+    if ((msg.type == INNER_MSG_ASYNC_DONE && ctrler_.isSeeking_) ||
+        (msg.type == INNER_MSG_STEP_DONE && ctrler_.isStepping_)) {
+        ctrler_.ReportSeekDone(MSERR_OK);
+    }
+
     if (msg.type == INNER_MSG_ERROR) {
+        if (ctrler_.isSeeking_ || ctrler_.isStepping_) {
+            ctrler_.ReportSeekDone(msg.detail1);
+        }
         if (ctrler_.GetCurrState() != ctrler_.idleState_) {
             auto stopTask = std::make_shared<TaskHandler<void>>([this]() {
                 ctrler_.ChangeState(ctrler_.stoppedState_);
@@ -91,22 +109,25 @@ int32_t PlayBinCtrlerBase::IdleState::SetUp()
 {
     MEDIA_LOGD("IdleState::SetUp enter");
 
-    int32_t ret = ctrler_.OnInit();
-    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
-    CHECK_AND_RETURN_RET(ctrler_.playbin_ != nullptr, static_cast<int32_t>(MSERR_UNKNOWN));
+    // the playbin is kept when the ctrler is recycled.
+    if (ctrler_.playbin_ == nullptr) {
+        int32_t ret = ctrler_.OnInit();
+        CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+        CHECK_AND_RETURN_RET(ctrler_.playbin_ != nullptr, static_cast<int32_t>(MSERR_UNKNOWN));
 
-    ctrler_.playbin_ = GST_PIPELINE_CAST(gst_object_ref(ctrler_.playbin_));
+        ctrler_.playbin_ = GST_PIPELINE_CAST(gst_object_ref(ctrler_.playbin_));
+        ret = ctrler_.SetupSignalMessage();
+        CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+        g_object_get(ctrler_.playbin_, "flags", &ctrler_.defaultPlayFlags_, nullptr);
+    }
     ctrler_.SetupCustomElement();
-    ret = ctrler_.SetupSignalMessage();
-    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
+    uint32_t flags = ctrler_.defaultPlayFlags_;
     if (ctrler_.currScene_ == PlayBinScene::METADATA || ctrler_.currScene_ == PlayBinScene::THUBNAIL) {
-        uint32_t flags;
-        g_object_get(ctrler_.playbin_, "flags", &flags, nullptr);
         flags |= GST_PLAY_FLAG_NATIVE_VIDEO | GST_PLAY_FLAG_NATIVE_AUDIO;
         flags &= ~(GST_PLAY_FLAG_SOFT_COLORBALANCE | GST_PLAY_FLAG_SOFT_VOLUME);
-        g_object_set(ctrler_.playbin_, "flags", flags, nullptr);
     }
+    g_object_set(ctrler_.playbin_, "flags", flags, nullptr);
 
     g_object_set(ctrler_.playbin_, "uri", ctrler_.uri_.c_str(), nullptr);
     ctrler_.ChangeState(ctrler_.initializedState_);
@@ -186,9 +207,12 @@ int32_t PlayBinCtrlerBase::PreparedState::Pause()
 
 int32_t PlayBinCtrlerBase::PreparedState::Seek(int64_t timeUs, int32_t option)
 {
-    (void)timeUs;
-    (void)option;
-    return MSERR_OK;
+    return ctrler_.SeekInternal(timeUs, option);
+}
+
+int32_t PlayBinCtrlerBase::PreparedState::Step(int64_t amountUs)
+{
+    return ctrler_.StepInternal(amountUs);
 }
 
 int32_t PlayBinCtrlerBase::PreparedState::Stop()
@@ -234,9 +258,7 @@ int32_t PlayBinCtrlerBase::PlayingState::Pause()
 
 int32_t PlayBinCtrlerBase::PlayingState::Seek(int64_t timeUs, int32_t option)
 {
-    (void)timeUs;
-    (void)option;
-    return MSERR_OK;
+    return ctrler_.SeekInternal(timeUs, option);
 }
 
 int32_t PlayBinCtrlerBase::PlayingState::Stop()
@@ -267,9 +289,12 @@ int32_t PlayBinCtrlerBase::PausedState::Pause()
 
 int32_t PlayBinCtrlerBase::PausedState::Seek(int64_t timeUs, int32_t option)
 {
-    (void)timeUs;
-    (void)option;
-    return MSERR_OK;
+    return ctrler_.SeekInternal(timeUs, option);
+}
+
+int32_t PlayBinCtrlerBase::PausedState::Step(int64_t amountUs)
+{
+    return ctrler_.StepInternal(amountUs);
 }
 
 int32_t PlayBinCtrlerBase::PausedState::Stop()
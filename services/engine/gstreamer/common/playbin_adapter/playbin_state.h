@@ -32,6 +32,7 @@ public:
     virtual int32_t Play();
     virtual int32_t Pause();
     virtual int32_t Seek(int64_t timeUs, int32_t option);
+    virtual int32_t Step(int64_t amountUs);
     virtual int32_t Stop();
 
 protected:
@@ -77,6 +78,7 @@ public:
     int32_t Play() override;
     int32_t Pause() override;
     int32_t Seek(int64_t timeUs, int32_t option) override;
+    int32_t Step(int64_t amountUs) override;
     int32_t Stop() override;
 
 protected:
@@ -107,6 +109,7 @@ public:
     int32_t Play() override;
     int32_t Pause() override;
     int32_t Seek(int64_t timeUs, int32_t option) override;
+    int32_t Step(int64_t amountUs) override;
     int32_t Stop() override;
 
 protected:
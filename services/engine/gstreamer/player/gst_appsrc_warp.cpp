@@ -14,13 +14,17 @@
  */
 
 #include "gst_appsrc_warp.h"
+#include <algorithm>
 #include "media_log.h"
 #include "media_errors.h"
 #include "player.h"
-#include "securec.h"
+#include "inline_task_handler.h"
+#include "media_trace.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "GstAppsrcWarp"};
+    constexpr uint32_t DEFAULT_READ_AHEAD_SIZE = 512 * 1024; // 512KB
+    constexpr uint32_t READ_AHEAD_CHUNK_SIZE = 64 * 1024; // 64KB
 }
 
 namespace OHOS {
@@ -38,6 +42,7 @@ std::shared_ptr<GstAppsrcWarp> GstAppsrcWarp::Create(const std::shared_ptr<IMedi
 GstAppsrcWarp::GstAppsrcWarp(const std::shared_ptr<IMediaDataSource> &dataSrc, const int64_t size)
     : dataSrc_(dataSrc),
       size_(size),
+      readAheadSize_(DEFAULT_READ_AHEAD_SIZE),
       taskQue_("appsrcWarpTask")
 {
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create and size %{public}" PRId64 "", FAKE_POINTER(this), size);
@@ -49,6 +54,12 @@ GstAppsrcWarp::~GstAppsrcWarp()
 {
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
     (void)taskQue_.Stop();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ClearCacheLocked();
+        MEDIA_LOGI("need-data requests: %{public}" PRIu64 ", served by the read-ahead cache: %{public}" PRIu64 "",
+            needDataCount_, cacheServedCount_);
+    }
     ClearAppsrc();
 }
 
@@ -94,6 +105,12 @@ bool GstAppsrcWarp::NoSeek() const
     return streamType_ == GST_APP_STREAM_TYPE_STREAM;
 }
 
+void GstAppsrcWarp::SetReadAheadSize(uint32_t size)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    readAheadSize_ = size;
+}
+
 int32_t GstAppsrcWarp::SetErrorCallback(const std::weak_ptr<IPlayerEngineObs> &obs)
 {
     CHECK_AND_RETURN_RET_LOG(obs.lock() != nullptr, MSERR_INVALID_OPERATION,
@@ -114,11 +131,15 @@ void GstAppsrcWarp::NeedData(const GstElement *appSrc, uint32_t size, gpointer s
 void GstAppsrcWarp::NeedDataInner(uint32_t size)
 {
     std::unique_lock<std::mutex> lock(mutex_);
+    needDataCount_++;
+    uint64_t startPos = curPos_;
     targetPos_ = curPos_ + size;
-    auto task = std::make_shared<TaskHandler<void>>([this] {
-        ReadAndGetMem();
-    });
-    CHECK_AND_RETURN_LOG(taskQue_.EnqueueTask(task) == MSERR_OK, "enque task failed");
+    ServeCachedLocked();
+    if (curPos_ >= targetPos_ && curPos_ > startPos) {
+        cacheServedCount_++;
+    }
+    // refill the read-ahead window even if served by the cache.
+    ScheduleReadLocked();
 }
 
 gboolean GstAppsrcWarp::SeekData(const GstElement *appSrc, uint64_t seekPos, gpointer self)
@@ -133,89 +154,155 @@ gboolean GstAppsrcWarp::SeekData(const GstElement *appSrc, uint64_t seekPos, gpo
 gboolean GstAppsrcWarp::SeekDataInner(uint64_t pos)
 {
     std::unique_lock<std::mutex> lock(mutex_);
+    ClearCacheLocked();
     curPos_ = pos;
     targetPos_ = pos;
+    readPos_ = pos;
+    readResult_ = 0;
+    seekGeneration_++;
     return TRUE;
 }
 
-void GstAppsrcWarp::ReadAndGetMem()
+void GstAppsrcWarp::ScheduleReadLocked()
 {
-    std::unique_lock<std::mutex> lock(mutex_);
-    CHECK_AND_RETURN_LOG(targetPos_ >= curPos_, "targetpos should larger than curpos error");
-    if (targetPos_ == curPos_) {
+    if (readScheduled_) {
         return;
     }
+    auto task = InlineTaskHandler::Create([this] {
+        ReadAhead();
+    });
+    CHECK_AND_RETURN_LOG(taskQue_.EnqueueTask(task) == MSERR_OK, "enque task failed");
+    readScheduled_ = true;
+}
+
+void GstAppsrcWarp::ReadAhead()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (readResult_ == 0) {
+        uint64_t endPos = std::max(targetPos_, curPos_ + readAheadSize_);
+        if (readPos_ >= endPos) {
+            break;
+        }
+        // read the requested data at once, and the data ahead of it in small chunks to serve the
+        // next need-data soon.
+        uint64_t len = targetPos_ > readPos_ ? targetPos_ - readPos_ :
+            std::min<uint64_t>(endPos - readPos_, READ_AHEAD_CHUNK_SIZE);
+        uint64_t pos = readPos_;
+        uint64_t generation = seekGeneration_;
+        lock.unlock();
+
+        GstBuffer *buffer = nullptr;
+        int32_t result = ReadBuffer(pos, static_cast<uint32_t>(std::min<uint64_t>(len, UINT32_MAX)), buffer);
+
+        lock.lock();
+        if (generation != seekGeneration_) {
+            // seeked during the reading, the data is stale.
+            if (buffer != nullptr) {
+                gst_buffer_unref(buffer);
+            }
+            continue;
+        }
+        if (buffer == nullptr) {
+            // no data for now if 0, read again at the next need-data.
+            readResult_ = result;
+            break;
+        }
+        cachedBuffers_.push_back(buffer);
+        readPos_ += static_cast<uint64_t>(result);
+        ServeCachedLocked();
+    }
+
+    ServeCachedLocked();
+    if (readResult_ == 0 && curPos_ < targetPos_) {
+        MEDIA_LOGD("no data for now, wait for the next need-data");
+    }
+    readScheduled_ = false;
+}
+
+int32_t GstAppsrcWarp::ReadBuffer(uint64_t pos, uint32_t len, GstBuffer *&buffer)
+{
+    MediaTraceScope trace("GstAppsrcWarp::ReadBuffer", MEDIA_TRACE_APPSRC, len);
     int32_t size = 0;
-    uint32_t len = static_cast<uint32_t>(targetPos_ - curPos_);
     if (size_ == -1) {
         size = dataSrc_->ReadAt(len);
     } else {
-        size = dataSrc_->ReadAt(static_cast<int64_t>(curPos_), len);
+        size = dataSrc_->ReadAt(static_cast<int64_t>(pos), len);
+    }
+    if (size <= 0) {
+        return size;
     }
 
-    AnalyzeSize(size);
+    std::shared_ptr<AVSharedMemory> mem = dataSrc_->GetMem();
+    if (mem == nullptr || mem->GetBase() == nullptr) {
+        MEDIA_LOGE("get mem failed");
+        OnError(MSERR_DATA_SOURCE_OBTAIN_MEM_ERROR);
+        return 0;
+    }
+    if (size > mem->GetSize()) {
+        size = mem->GetSize();
+    }
+    buffer = CopyMem(mem, size);
+    if (buffer == nullptr) {
+        OnError(MSERR_NO_MEMORY);
+        return 0;
+    }
+    GST_BUFFER_OFFSET(buffer) = pos;
+    return size;
 }
 
-void GstAppsrcWarp::AnalyzeSize(int32_t size)
+GstBuffer *GstAppsrcWarp::CopyMem(const std::shared_ptr<AVSharedMemory> &mem, int32_t size)
 {
-    if (size == 0) {
-        return;
+    // the memory is shared with the app, which can still write it, so the demuxer must parse a private copy.
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, static_cast<gsize>(size), nullptr);
+    CHECK_AND_RETURN_RET_LOG(buffer != nullptr, nullptr, "new buffer failed");
+    gsize copied = gst_buffer_fill(buffer, 0, mem->GetBase(), static_cast<gsize>(size));
+    if (copied != static_cast<gsize>(size)) {
+        gst_buffer_unref(buffer);
+        MEDIA_LOGE("copy memory failed");
+        return nullptr;
     }
-    if (size > 0) {
-        int32_t ret = GetAndPushMem(size);
-        if (ret != MSERR_OK) {
-            OnError(ret);
-        }
-        return;
+    return buffer;
+}
+
+void GstAppsrcWarp::ServeCachedLocked()
+{
+    while (curPos_ < targetPos_ && !cachedBuffers_.empty()) {
+        GstBuffer *buffer = cachedBuffers_.front();
+        cachedBuffers_.pop_front();
+        curPos_ += gst_buffer_get_size(buffer);
+        PushData(buffer);
+        gst_buffer_unref(buffer);
+    }
+
+    if (curPos_ < targetPos_ && cachedBuffers_.empty() && readResult_ != 0) {
+        AnalyzeResult(readResult_);
     }
+}
+
+void GstAppsrcWarp::AnalyzeResult(int32_t result)
+{
     targetPos_ = curPos_;
     PushEos();
-    switch (size) {
+    switch (result) {
         case SOURCE_ERROR_IO:
             OnError(MSERR_DATA_SOURCE_IO_ERROR);
-            MEDIA_LOGW("IO ERROR %d", size);
+            MEDIA_LOGW("IO ERROR %d", result);
             break;
         case SOURCE_ERROR_EOF:
             break;
         default:
             OnError(MSERR_DATA_SOURCE_ERROR_UNKNOWN);
-            MEDIA_LOGE("unknow error %d", size);
+            MEDIA_LOGE("unknow error %d", result);
             break;
     }
 }
 
-int32_t GstAppsrcWarp::GetAndPushMem(int32_t size)
+void GstAppsrcWarp::ClearCacheLocked()
 {
-    CHECK_AND_RETURN_RET_LOG(size > 0, MSERR_NO_MEMORY, "size should biger than zero");
-    GstBuffer *buffer = nullptr;
-    std::shared_ptr<AVSharedMemory> mem = dataSrc_->GetMem();
-    CHECK_AND_RETURN_RET_LOG(mem != nullptr, MSERR_DATA_SOURCE_OBTAIN_MEM_ERROR, "get mem is nullptr");
-    CHECK_AND_RETURN_RET_LOG(mem->GetBase() != nullptr, MSERR_DATA_SOURCE_OBTAIN_MEM_ERROR, "mem base is nullptr");
-    if (size > mem->GetSize()) {
-        size = mem->GetSize();
-    }
-    buffer = gst_buffer_new_allocate(nullptr, size, nullptr);
-    CHECK_AND_RETURN_RET_LOG(buffer != nullptr, MSERR_NO_MEMORY, "no mem error");
-    GstMapInfo info = GST_MAP_INFO_INIT;
-    if (gst_buffer_map(buffer, &info, GST_MAP_WRITE) == FALSE) {
+    for (auto buffer : cachedBuffers_) {
         gst_buffer_unref(buffer);
-        MEDIA_LOGE("map buffer failed");
-        return MSERR_NO_MEMORY;
     }
-    if (memcpy_s(info.data, static_cast<size_t>(size), mem->GetBase(), static_cast<size_t>(mem->GetSize())) != EOK) {
-        gst_buffer_unmap(buffer, &info);
-        gst_buffer_unref(buffer);
-        MEDIA_LOGE("memcpy_s failed");
-        return MSERR_DATA_SOURCE_OBTAIN_MEM_ERROR;
-    }
-    gst_buffer_unmap(buffer, &info);
-    GST_BUFFER_OFFSET(buffer) = curPos_;
-    curPos_ += size;
-    PushData(buffer);
-    gst_buffer_unref(buffer);
-    buffer = nullptr;
-
-    return MSERR_OK;
+    cachedBuffers_.clear();
 }
 
 void GstAppsrcWarp::OnError(int32_t errorCode)
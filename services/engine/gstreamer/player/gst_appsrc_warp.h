@@ -16,6 +16,7 @@
 #ifndef GST_APPSRC_WARP_H_
 #define GST_APPSRC_WARP_H_
 
+#include <deque>
 #include <gst/gst.h>
 #include "task_queue.h"
 #include "media_data_source.h"
@@ -34,6 +35,8 @@ public:
     int32_t SetAppsrc(GstElement *appSrc);
     int32_t SetErrorCallback(const std::weak_ptr<IPlayerEngineObs> &obs);
     bool NoSeek() const;
+    // the bytes read ahead of the data requested by the appsrc, 0 to disable the read-ahead.
+    void SetReadAheadSize(uint32_t size);
 
 private:
     void SetCallBackForAppSrc();
@@ -42,16 +45,31 @@ private:
     static gboolean SeekData(const GstElement *appSrc, uint64_t seekPos, gpointer self);
     void NeedDataInner(uint32_t size);
     gboolean SeekDataInner(uint64_t seekPos);
-    void ReadAndGetMem();
-    void AnalyzeSize(int32_t size);
-    int32_t GetAndPushMem(int32_t size);
+    void ScheduleReadLocked();
+    void ReadAhead();
+    int32_t ReadBuffer(uint64_t pos, uint32_t len, GstBuffer *&buffer);
+    GstBuffer *CopyMem(const std::shared_ptr<AVSharedMemory> &mem, int32_t size);
+    void ServeCachedLocked();
+    void AnalyzeResult(int32_t result);
+    void ClearCacheLocked();
     void OnError(int32_t errorCode);
     void PushData(const GstBuffer *buffer);
     void PushEos();
     std::shared_ptr<IMediaDataSource> dataSrc_ = nullptr;
     const int64_t size_;
-    uint64_t curPos_ = 0;
-    uint64_t targetPos_ = 0;
+    uint64_t curPos_ = 0; // the next byte to push to the appsrc.
+    uint64_t targetPos_ = 0; // the appsrc requested the data until this position.
+    uint64_t readPos_ = 0; // the next byte to read from the data source.
+    uint32_t readAheadSize_;
+    // the buffers read ahead, contiguous from the curPos_ to the readPos_.
+    std::deque<GstBuffer *> cachedBuffers_;
+    // the result of the read at the readPos_ if the data source has no more data, such as eos or error.
+    int32_t readResult_ = 0;
+    bool readScheduled_ = false;
+    // increased by the seek, the data of the former reading is dropped.
+    uint64_t seekGeneration_ = 0;
+    uint64_t needDataCount_ = 0;
+    uint64_t cacheServedCount_ = 0;
     std::mutex mutex_;
     GstElement *appSrc_ = nullptr;
     TaskQueue taskQue_;
@@ -14,10 +14,21 @@
  */
 
 #include "gst_player_build.h"
+#include <chrono>
 #include "media_log.h"
+#include "media_errors.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "GstPlayerBuild"};
+    constexpr int32_t RELEASE_CTRL_TIMEOUT_MS = 1000;
+    constexpr gdouble DEFAULT_RATE = 1.0;
+    // the GstPlayFlags of the playbin.
+    constexpr guint PLAY_FLAG_VIDEO = 1 << 0;
+    constexpr guint PLAY_FLAG_TEXT = 1 << 2;
+    constexpr guint PLAY_FLAG_VIS = 1 << 3;
+    // the network buffering of the audio only playback, instead of 2MB and 5s by default.
+    constexpr gint AUDIO_BUFFER_SIZE = 256 * 1024;
+    constexpr gint64 AUDIO_BUFFER_DURATION = 1000000000; // 1s
 }
 
 namespace OHOS {
@@ -44,9 +55,9 @@ class GstPlayerFactory {
 public:
     GstPlayerFactory() = delete;
     ~GstPlayerFactory() = delete;
+    // the renderer is nullptr for the audio only playback.
     static GstPlayer *Create(GstPlayerVideoRenderer *renderer, GstPlayerSignalDispatcher *dispatcher)
     {
-        CHECK_AND_RETURN_RET_LOG(renderer != nullptr, nullptr, "renderer is nullptr");
         CHECK_AND_RETURN_RET_LOG(dispatcher != nullptr, nullptr, "dispatcher is nullptr");
         return gst_player_new(renderer, dispatcher);
     }
@@ -69,13 +80,16 @@ GstPlayerBuild::~GstPlayerBuild()
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
 }
 
-std::shared_ptr<GstPlayerCtrl> GstPlayerBuild::Build(sptr<Surface> surface)
+std::shared_ptr<GstPlayerCtrl> GstPlayerBuild::Build(sptr<Surface> surface, bool audioOnly)
 {
-    if (surface == nullptr) {
+    if (audioOnly) {
+        MEDIA_LOGI("This is an audio only player.");
+    } else if (surface == nullptr) {
         MEDIA_LOGI("This is an audio scene.");
     } else {
         MEDIA_LOGI("This is an video scene.");
     }
+    audioOnly_ = audioOnly;
 
     context_ =  g_main_context_new();
     CHECK_AND_RETURN_RET_LOG(context_ != nullptr, nullptr, "g_main_context_new failed..");
@@ -89,15 +103,23 @@ std::shared_ptr<GstPlayerCtrl> GstPlayerBuild::Build(sptr<Surface> surface)
         return nullptr;
     }
 
-    videoRenderer_ = GstPlayerVideoRendererFactory::Create(rendererCtrl_);
+    if (!audioOnly) {
+        videoRenderer_ = GstPlayerVideoRendererFactory::Create(rendererCtrl_);
+    }
     signalDispatcher_ = GstPlayerSingnalDispatcherFactory::Create(context_);
-    if (signalDispatcher_ == nullptr || videoRenderer_ == nullptr) {
+    if (signalDispatcher_ == nullptr || (!audioOnly && videoRenderer_ == nullptr)) {
         Release();
         MEDIA_LOGE("signalDispatcher_ or videoRenderer_ is nullptr");
         return nullptr;
     }
 
     gstPlayer_ = GstPlayerFactory::Create(videoRenderer_, signalDispatcher_);
+    if (gstPlayer_ != nullptr && audioOnly && InitAudioOnly() != MSERR_OK) {
+        Release();
+        MEDIA_LOGE("init the audio only playback failed");
+        return nullptr;
+    }
+
     playerCtrl_ = std::make_shared<GstPlayerCtrl>(gstPlayer_);
     if (gstPlayer_ == nullptr || playerCtrl_ == nullptr) {
         Release();
@@ -108,6 +130,97 @@ std::shared_ptr<GstPlayerCtrl> GstPlayerBuild::Build(sptr<Surface> surface)
     return playerCtrl_;
 }
 
+int32_t GstPlayerBuild::InitAudioOnly()
+{
+    GstElement *playbin = gst_player_get_pipeline(gstPlayer_);
+    CHECK_AND_RETURN_RET_LOG(playbin != nullptr, MSERR_INVALID_OPERATION, "playbin is nullptr");
+
+    // without the video renderer, the audio sink is not installed at the creating of the video sink.
+    int32_t ret = rendererCtrl_->InitAudioSink(playbin);
+    if (ret == MSERR_OK) {
+        guint flags = 0;
+        g_object_get(playbin, "flags", &flags, nullptr);
+        flags &= ~(PLAY_FLAG_VIDEO | PLAY_FLAG_TEXT | PLAY_FLAG_VIS);
+        g_object_set(playbin, "flags", flags, "buffer-size", AUDIO_BUFFER_SIZE,
+            "buffer-duration", AUDIO_BUFFER_DURATION, nullptr);
+        MEDIA_LOGI("audio only playback, playbin flags: 0x%{public}x", flags);
+    }
+    gst_object_unref(playbin);
+    return ret;
+}
+
+bool GstPlayerBuild::CanRebuild(const sptr<Surface> &surface, bool audioOnly) const
+{
+    return gstPlayer_ != nullptr && rendererCtrl_ != nullptr && rendererCtrl_->GetSurface() == surface &&
+        audioOnly_ == audioOnly;
+}
+
+std::shared_ptr<GstPlayerCtrl> GstPlayerBuild::Rebuild()
+{
+    CHECK_AND_RETURN_RET_LOG(gstPlayer_ != nullptr && rendererCtrl_ != nullptr, nullptr, "not built yet");
+    CHECK_AND_RETURN_RET_LOG(playerCtrl_ == nullptr, nullptr, "the last control is not released");
+
+    // the gstplayer and the sinks keep the settings of the last source.
+    gst_player_set_rate(gstPlayer_, DEFAULT_RATE);
+    rendererCtrl_->ResetAudioSink();
+
+    playerCtrl_ = std::make_shared<GstPlayerCtrl>(gstPlayer_);
+    CHECK_AND_RETURN_RET_LOG(playerCtrl_ != nullptr, nullptr, "playerCtrl_ is nullptr");
+    MEDIA_LOGI("Rebuild the player control over the kept gstplayer");
+    return playerCtrl_;
+}
+
+gboolean GstPlayerBuild::ReleaseCtrlCb(gpointer userData)
+{
+    auto task = *reinterpret_cast<std::shared_ptr<ReleaseCtrlTask> *>(userData);
+    std::shared_ptr<GstPlayerCtrl> ctrl = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(task->mutex);
+        ctrl = std::move(task->ctrl);
+        task->ctrl = nullptr;
+    }
+    // the signal callbacks of the control are dispatched in this thread, none of them is running now.
+    ctrl = nullptr;
+    std::unique_lock<std::mutex> lock(task->mutex);
+    task->done = true;
+    task->cond.notify_all();
+    return G_SOURCE_REMOVE;
+}
+
+void GstPlayerBuild::DestroyReleaseCtrlTask(gpointer userData)
+{
+    delete reinterpret_cast<std::shared_ptr<ReleaseCtrlTask> *>(userData);
+}
+
+bool GstPlayerBuild::ReleaseCtrl()
+{
+    CHECK_AND_RETURN_RET_LOG(context_ != nullptr, false, "context_ is nullptr");
+    auto task = std::make_shared<ReleaseCtrlTask>();
+    task->ctrl = std::move(playerCtrl_);
+    playerCtrl_ = nullptr;
+
+    auto userData = new (std::nothrow) std::shared_ptr<ReleaseCtrlTask>(task);
+    CHECK_AND_RETURN_RET_LOG(userData != nullptr, false, "new task failed");
+    g_main_context_invoke_full(context_, G_PRIORITY_DEFAULT, ReleaseCtrlCb, userData, DestroyReleaseCtrlTask);
+
+    std::unique_lock<std::mutex> lock(task->mutex);
+    if (task->cond.wait_for(lock, std::chrono::milliseconds(RELEASE_CTRL_TIMEOUT_MS),
+        [&task] { return task->done; })) {
+        return true;
+    }
+    if (task->ctrl == nullptr) {
+        // being destroyed in the loop thread right now.
+        task->cond.wait(lock, [&task] { return task->done; });
+        return true;
+    }
+
+    // not dispatched in time, taken back so that it is destroyed before the gstplayer by the Release.
+    playerCtrl_ = std::move(task->ctrl);
+    task->ctrl = nullptr;
+    MEDIA_LOGW("release the player control in the loop thread timeout");
+    return false;
+}
+
 void GstPlayerBuild::CreateLoop()
 {
     MEDIA_LOGI("Create the loop for the current context");
@@ -16,7 +16,9 @@
 #ifndef PLAYER_PIPELINE_BUILD_H
 #define PLAYER_PIPELINE_BUILD_H
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <gst/gst.h>
 #include <gst/player/player.h>
@@ -29,11 +31,29 @@ class GstPlayerBuild {
 public:
     GstPlayerBuild();
     ~GstPlayerBuild();
-    std::shared_ptr<GstPlayerCtrl> Build(sptr<Surface> surface = nullptr);
+    // the audio only gstplayer has no video renderer, even if the surface is set.
+    std::shared_ptr<GstPlayerCtrl> Build(sptr<Surface> surface = nullptr, bool audioOnly = false);
+    // the renderer is bound to the surface, so the gstplayer can only be reused for the same one and mode.
+    bool CanRebuild(const sptr<Surface> &surface, bool audioOnly) const;
+    // create a new control over the gstplayer, context and renderer kept from the last source.
+    std::shared_ptr<GstPlayerCtrl> Rebuild();
+    // drop the control of the last source in the loop thread. If it is not done in time, the control is
+    // kept and false is returned, then the whole build must be released after the loop is stopped.
+    bool ReleaseCtrl();
     void CreateLoop();
     void DestroyLoop() const;
 
 private:
+    struct ReleaseCtrlTask {
+        std::shared_ptr<GstPlayerCtrl> ctrl;
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool done = false;
+    };
+    static gboolean ReleaseCtrlCb(gpointer userData);
+    static void DestroyReleaseCtrlTask(gpointer userData);
+    // no video, subtitle and visualization chain for the audio only player.
+    int32_t InitAudioOnly();
     void Release();
     GMainContext *context_ = nullptr;
     GMainLoop *loop_ = nullptr;
@@ -42,6 +62,7 @@ private:
     GstPlayer *gstPlayer_ = nullptr;
     std::shared_ptr<GstPlayerCtrl> playerCtrl_ = nullptr;
     std::shared_ptr<GstPlayerVideoRendererCtrl> rendererCtrl_ = nullptr;
+    bool audioOnly_ = false;
 };
 } // Media
 } // OHOS
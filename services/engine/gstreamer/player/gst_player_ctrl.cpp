@@ -18,12 +18,17 @@
 #include "audio_system_manager.h"
 #include "media_errors.h"
 #include "audio_errors.h"
+#include "inline_task_handler.h"
+#include "scrub_stats.h"
+#include "player_startup_stats.h"
+#include "latency_histogram.h"
 
 namespace {
     constexpr float INVALID_VOLUME = -1.0;
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "GstPlayerCtrl"};
     constexpr int MILLI = 1000;
     constexpr int MICRO = MILLI * 1000;
+    constexpr uint64_t NS_PER_US = 1000;
     using namespace OHOS::Media;
     using StreamToServiceErrFunc = void (*)(const gchar *name, int32_t &errorCode);
     static const std::unordered_map<int32_t, StreamToServiceErrFunc> STREAM_TO_SERVICE_ERR_FUNC_TABLE = {
@@ -60,6 +65,12 @@ GstPlayerCtrl::GstPlayerCtrl(GstPlayer *gstPlayer)
 
 GstPlayerCtrl::~GstPlayerCtrl()
 {
+    RemoveSwitchProbes();
+    if (playbin_ != nullptr) {
+        g_signal_handler_disconnect(playbin_, signalIdAboutToFinish_);
+        gst_object_unref(playbin_);
+        playbin_ = nullptr;
+    }
     condVarPlaySync_.notify_all();
     condVarPauseSync_.notify_all();
     condVarStopSync_.notify_all();
@@ -79,6 +90,14 @@ void GstPlayerCtrl::SetRingBufferMaxSize(uint64_t size)
     g_object_set(gstPlayer_, "ring-buffer-max-size", static_cast<guint64>(size), nullptr);
 }
 
+void GstPlayerCtrl::SetStartupInfo(uint64_t sourceNs, bool warm, bool audioOnly)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    sourceNs_ = sourceNs;
+    warmStartup_ = warm;
+    audioOnly_ = audioOnly;
+}
+
 int32_t GstPlayerCtrl::SetUri(const std::string &uri)
 {
     std::unique_lock<std::mutex> lock(mutex_);
@@ -98,6 +117,17 @@ int32_t GstPlayerCtrl::SetSource(const std::shared_ptr<GstAppsrcWarp> &appsrcWar
     return MSERR_OK;
 }
 
+int32_t GstPlayerCtrl::SetNextUri(const std::string &uri)
+{
+    std::unique_lock<std::mutex> lock(nextMutex_);
+    CHECK_AND_RETURN_RET_LOG(playbin_ != nullptr, MSERR_INVALID_OPERATION, "playbin is nullptr");
+    CHECK_AND_RETURN_RET_LOG(nextState_ != NEXT_SOURCE_SWITCHING, MSERR_INVALID_OPERATION,
+        "switching to the next source, try later");
+    nextUri_ = uri;
+    nextState_ = NEXT_SOURCE_PENDING;
+    return MSERR_OK;
+}
+
 int32_t GstPlayerCtrl::SetCallbacks(const std::weak_ptr<IPlayerEngineObs> &obs)
 {
     CHECK_AND_RETURN_RET_LOG(obs.lock() != nullptr,
@@ -114,6 +144,12 @@ int32_t GstPlayerCtrl::SetCallbacks(const std::weak_ptr<IPlayerEngineObs> &obs)
     signalIds_.push_back(g_signal_connect(gstPlayer_, "position-updated", G_CALLBACK(OnPositionUpdatedCb), this));
     signalIds_.push_back(g_signal_connect(gstPlayer_, "source-setup", G_CALLBACK(OnSourceSetupCb), this));
 
+    if (playbin_ == nullptr) {
+        playbin_ = gst_player_get_pipeline(gstPlayer_);
+        CHECK_AND_RETURN_RET_LOG(playbin_ != nullptr, MSERR_INVALID_OPERATION, "playbin is nullptr");
+        signalIdAboutToFinish_ = g_signal_connect(playbin_, "about-to-finish", G_CALLBACK(OnAboutToFinishCb), this);
+    }
+
     obs_ = obs;
     currentState_ = PLAYER_PREPARING;
     return MSERR_OK;
@@ -134,7 +170,7 @@ void GstPlayerCtrl::Pause(bool cancelNotExecuted)
         PauseSync();
     } else {
         std::unique_lock<std::mutex> lock(mutex_);
-        auto task = std::make_shared<TaskHandler<void>>([this] { PauseSync(); });
+        auto task = InlineTaskHandler::Create([this] { PauseSync(); });
         (void)taskQue_.EnqueueTask(task);
     }
 }
@@ -160,7 +196,7 @@ void GstPlayerCtrl::PauseSync()
 void GstPlayerCtrl::Play()
 {
     std::unique_lock<std::mutex> lock(mutex_);
-    auto task = std::make_shared<TaskHandler<void>>([this] { PlaySync(); });
+    auto task = InlineTaskHandler::Create([this] { PlaySync(); });
     (void)taskQue_.EnqueueTask(task);
 }
 
@@ -199,6 +235,11 @@ int32_t GstPlayerCtrl::ChangeSeekModeToGstFlag(const PlayerSeekMode mode) const
             break;
         case SEEK_CLOSEST:
             break;
+        case SEEK_SCRUB:
+            // decode the keyframes only and skip the audio, cleared by the next seek without these flags.
+            flag = GST_SEEK_FLAG_KEY_UNIT | GST_SEEK_FLAG_TRICKMODE | GST_SEEK_FLAG_TRICKMODE_KEY_UNITS |
+                GST_SEEK_FLAG_TRICKMODE_NO_AUDIO;
+            break;
         default:
             MEDIA_LOGW("unknown seek mode");
             break;
@@ -213,13 +254,22 @@ int32_t GstPlayerCtrl::Seek(uint64_t position, const PlayerSeekMode mode)
         return MSERR_INVALID_OPERATION;
     }
     position = (position > sourceDuration_) ? sourceDuration_ : position;
+    uint64_t requestNs = LatencyHistogram::GetCurTimeNs();
+    if (mode == SEEK_SCRUB) {
+        scrubRequested_++;
+        ScrubStats::GetInstance().OnScrubRequested(seekInProgress_ && nextSeekFlag_);
+    }
     if (seekInProgress_) {
+        // only the latest target is kept, the dragging outpaces the seeks.
         nextSeekFlag_ = true;
         nextSeekPos_ = position;
         nextSeekMode_ = mode;
+        nextSeekRequestNs_ = requestNs;
     } else {
         seekInProgress_ = true;
-        auto task = std::make_shared<TaskHandler<void>>([this, position, mode] { SeekSync(position, mode); });
+        auto task = InlineTaskHandler::Create([this, position, mode, requestNs] {
+            SeekSync(position, mode, requestNs);
+        });
         (void)taskQue_.EnqueueTask(task);
     }
     return MSERR_OK;
@@ -231,14 +281,16 @@ void GstPlayerCtrl::MultipleSeek()
     if (nextSeekFlag_) {
         nextSeekFlag_ = false;
         seekInProgress_ = true;
-        auto task = std::make_shared<TaskHandler<void>>(
-            [this, position = nextSeekPos_, mode = nextSeekMode_] { SeekSync(position, mode); }
+        auto task = InlineTaskHandler::Create(
+            [this, position = nextSeekPos_, mode = nextSeekMode_, requestNs = nextSeekRequestNs_] {
+                SeekSync(position, mode, requestNs);
+            }
         );
         (void)taskQue_.EnqueueTask(task);
     }
 }
 
-void GstPlayerCtrl::SeekSync(uint64_t position, const PlayerSeekMode mode)
+void GstPlayerCtrl::SeekSync(uint64_t position, const PlayerSeekMode mode, uint64_t requestNs)
 {
     std::unique_lock<std::mutex> lock(mutex_);
 
@@ -247,6 +299,12 @@ void GstPlayerCtrl::SeekSync(uint64_t position, const PlayerSeekMode mode)
     }
 
     CHECK_AND_RETURN_LOG(gstPlayer_ != nullptr, "gstPlayer_ is nullptr");
+    if (mode == SEEK_SCRUB && !scrubbing_) {
+        MEDIA_LOGI("scrubbing start at %{public}" PRIu64 " ms", position);
+        scrubbing_ = true;
+    }
+    seekMode_ = mode;
+    seekRequestNs_ = requestNs;
     // need keep the seek and seek modes consistent.
     g_object_set(gstPlayer_, "seek-mode", static_cast<gint>(ChangeSeekModeToGstFlag(mode)), nullptr);
     GstClockTime time = static_cast<GstClockTime>(position * MICRO);
@@ -265,7 +323,7 @@ void GstPlayerCtrl::Stop(bool cancelNotExecuted)
         (void)taskQue_.EnqueueTask(task);
         (void)task->GetResult();
     } else {
-        auto task = std::make_shared<TaskHandler<void>>([this] { StopSync(); });
+        auto task = InlineTaskHandler::Create([this] { StopSync(); });
         (void)taskQue_.EnqueueTask(task);
     }
 }
@@ -297,7 +355,21 @@ void GstPlayerCtrl::StopSync()
     nextSeekFlag_ = false;
     seekInProgress_ = false;
     nextSeekPos_ = 0;
+    seekRequestNs_ = 0;
+    scrubbing_ = false;
+    scrubRequested_ = 0;
+    scrubExecuted_ = 0;
     enableLooping_ = false;
+    bool switching = false;
+    {
+        std::unique_lock<std::mutex> nextLock(nextMutex_);
+        switching = nextState_ == NEXT_SOURCE_SWITCHING && !nextStartReported_;
+        nextStartReported_ = true;
+    }
+    if (switching) {
+        // the playbin has taken the next source, it is played after restarting.
+        OnNextSourceStart(-1);
+    }
     if (audioSink_ != nullptr) {
         g_signal_handler_disconnect(audioSink_, signalIdVolume_);
         signalIdVolume_ = 0;
@@ -356,7 +428,7 @@ uint64_t GstPlayerCtrl::GetDuration()
 void GstPlayerCtrl::SetRate(double rate)
 {
     std::unique_lock<std::mutex> lock(mutex_);
-    auto task = std::make_shared<TaskHandler<void>>([this, rate] { SetRateSync(rate); });
+    auto task = InlineTaskHandler::Create([this, rate] { SetRateSync(rate); });
     (void)taskQue_.EnqueueTask(task);
 }
 
@@ -496,6 +568,160 @@ void GstPlayerCtrl::ProcessEndOfStream(const GstPlayer *cbPlayer)
     }
 }
 
+void GstPlayerCtrl::OnAboutToFinishCb(GstElement *playbin, GstPlayerCtrl *playerGst)
+{
+    CHECK_AND_RETURN_LOG(playbin != nullptr, "playbin is null");
+    CHECK_AND_RETURN_LOG(playerGst != nullptr, "playerGst is null");
+    playerGst->ProcessAboutToFinish(playbin);
+}
+
+void GstPlayerCtrl::ProcessAboutToFinish(GstElement *playbin)
+{
+    // called in the streaming thread, the next uri must be set before returning.
+    std::unique_lock<std::mutex> lock(nextMutex_);
+    if (nextState_ != NEXT_SOURCE_PENDING) {
+        return;
+    }
+
+    MEDIA_LOGI("about to finish, switch to the next source: %{public}s", nextUri_.c_str());
+    g_object_set(playbin, "uri", nextUri_.c_str(), nullptr);
+    nextUri_.clear();
+    nextState_ = NEXT_SOURCE_SWITCHING;
+    nextStartReported_ = false;
+}
+
+void GstPlayerCtrl::AddSwitchProbe(const char *sinkName)
+{
+    CHECK_AND_RETURN_LOG(playbin_ != nullptr, "playbin is nullptr");
+    GstElement *sink = nullptr;
+    g_object_get(playbin_, sinkName, &sink, nullptr);
+    if (sink == nullptr) {
+        return;
+    }
+    GstPad *pad = gst_element_get_static_pad(sink, "sink");
+    gst_object_unref(sink);
+    CHECK_AND_RETURN_LOG(pad != nullptr, "%{public}s has no sink pad", sinkName);
+
+    std::unique_lock<std::mutex> lock(nextMutex_);
+    for (auto &probe : switchProbes_) {
+        if (probe.pad == pad) {
+            gst_object_unref(pad);
+            return;
+        }
+    }
+    SwitchProbe probe;
+    probe.pad = pad;
+    gst_segment_init(&probe.segment, GST_FORMAT_UNDEFINED);
+    switchProbes_.push_back(probe);
+    // the callback takes the nextMutex_, it can not run before the probe is recorded.
+    switchProbes_.back().probeId = gst_pad_add_probe(pad,
+        static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM),
+        SwitchProbeCb, this, nullptr);
+}
+
+void GstPlayerCtrl::RemoveSwitchProbes()
+{
+    std::unique_lock<std::mutex> lock(nextMutex_);
+    for (auto &probe : switchProbes_) {
+        gst_pad_remove_probe(probe.pad, probe.probeId);
+        gst_object_unref(probe.pad);
+    }
+    switchProbes_.clear();
+}
+
+GstPadProbeReturn GstPlayerCtrl::SwitchProbeCb(GstPad *pad, GstPadProbeInfo *info, gpointer userData)
+{
+    auto playerGst = reinterpret_cast<GstPlayerCtrl *>(userData);
+    CHECK_AND_RETURN_RET(playerGst != nullptr && info != nullptr, GST_PAD_PROBE_OK);
+
+    std::unique_lock<std::mutex> lock(playerGst->nextMutex_);
+    for (auto &probe : playerGst->switchProbes_) {
+        if (probe.pad == pad) {
+            playerGst->ProcessSwitchProbe(probe, *info);
+            break;
+        }
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+void GstPlayerCtrl::ProcessSwitchProbe(SwitchProbe &probe, GstPadProbeInfo &info)
+{
+    if ((info.type & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) != 0) {
+        GstEvent *event = GST_PAD_PROBE_INFO_EVENT(&info);
+        if (GST_EVENT_TYPE(event) == GST_EVENT_SEGMENT) {
+            gst_event_copy_segment(event, &probe.segment);
+        } else if (GST_EVENT_TYPE(event) == GST_EVENT_STREAM_START && nextState_ == NEXT_SOURCE_SWITCHING) {
+            probe.waitFirstBuffer = true;
+            probe.prevEndTime = probe.lastEndTime;
+        }
+        return;
+    }
+
+    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(&info);
+    GstClockTime pts = GST_BUFFER_PTS(buffer);
+    if (!GST_CLOCK_TIME_IS_VALID(pts) || probe.segment.format != GST_FORMAT_TIME) {
+        return;
+    }
+    GstClockTime startTime = gst_segment_to_running_time(&probe.segment, GST_FORMAT_TIME, pts);
+    GstClockTime endTime = startTime;
+    if (GST_BUFFER_DURATION_IS_VALID(buffer)) {
+        endTime = gst_segment_to_running_time(&probe.segment, GST_FORMAT_TIME, pts + GST_BUFFER_DURATION(buffer));
+    }
+
+    if (probe.waitFirstBuffer) {
+        probe.waitFirstBuffer = false;
+        if (!nextStartReported_ && nextState_ == NEXT_SOURCE_SWITCHING) {
+            nextStartReported_ = true;
+            int32_t gapUs = -1;
+            if (GST_CLOCK_TIME_IS_VALID(startTime) && GST_CLOCK_TIME_IS_VALID(probe.prevEndTime)) {
+                // the first buffer arrived later than its running time is rendered when it arrives.
+                GstClockTime renderTime = startTime;
+                GstElement *sink = gst_pad_get_parent_element(probe.pad);
+                GstClock *clock = sink != nullptr ? gst_element_get_clock(sink) : nullptr;
+                if (clock != nullptr) {
+                    GstClockTime now = gst_clock_get_time(clock) - gst_element_get_base_time(sink);
+                    renderTime = std::max(renderTime, now);
+                    gst_object_unref(clock);
+                }
+                if (sink != nullptr) {
+                    gst_object_unref(sink);
+                }
+                GstClockTime gap = renderTime > probe.prevEndTime ? renderTime - probe.prevEndTime : 0;
+                gapUs = static_cast<int32_t>(std::min<GstClockTime>(gap / GST_USECOND, INT32_MAX));
+            }
+            auto task = InlineTaskHandler::Create([this, gapUs] {
+                std::unique_lock<std::mutex> lock(mutex_);
+                OnNextSourceStart(gapUs);
+            });
+            (void)taskQue_.EnqueueTask(task);
+        }
+    }
+    if (GST_CLOCK_TIME_IS_VALID(endTime)) {
+        probe.lastEndTime = endTime;
+    }
+}
+
+void GstPlayerCtrl::OnNextSourceStart(int32_t gapUs)
+{
+    gint64 duration = -1;
+    if (playbin_ != nullptr && gst_element_query_duration(playbin_, GST_FORMAT_TIME, &duration) && duration >= 0) {
+        sourceDuration_ = static_cast<uint64_t>(duration) / MICRO;
+    }
+    MEDIA_LOGI("next source started, gap: %{public}d us, duration: %{public}" PRIu64 "", gapUs, sourceDuration_);
+
+    std::shared_ptr<IPlayerEngineObs> tempObs = obs_.lock();
+    Format format;
+    if (tempObs != nullptr) {
+        tempObs->OnInfo(INFO_TYPE_NEXT_SOURCE_START, gapUs, format);
+    }
+
+    // reported before the state changes, the observer releases the previous source after it.
+    std::unique_lock<std::mutex> lock(nextMutex_);
+    if (nextState_ == NEXT_SOURCE_SWITCHING) {
+        nextState_ = NEXT_SOURCE_NONE;
+    }
+}
+
 void GstPlayerCtrl::StreamDecErrorParse(const gchar *name, int32_t &errorCode)
 {
     if (strstr(name, "aac") != nullptr) {
@@ -682,8 +908,11 @@ void GstPlayerCtrl::OnVolumeChange() const
 void GstPlayerCtrl::OnStateChanged(PlayerStates state)
 {
     if (state == PLAYER_PREPARED) {
+        RecordStartupLatency();
         InitDuration();
         GetAudioSink();
+        AddSwitchProbe("audio-sink");
+        AddSwitchProbe("video-sink");
     }
 
     MEDIA_LOGI("On State callback state: %{public}d", state);
@@ -695,6 +924,20 @@ void GstPlayerCtrl::OnStateChanged(PlayerStates state)
     }
 }
 
+void GstPlayerCtrl::RecordStartupLatency()
+{
+    if (sourceNs_ == 0) {
+        return;
+    }
+
+    // only the first prepared after the source set, not the ones after the stop.
+    uint64_t latencyUs = (LatencyHistogram::GetCurTimeNs() - sourceNs_) / NS_PER_US;
+    sourceNs_ = 0;
+    PlayerStartupStats::GetInstance().OnPrepared(warmStartup_, audioOnly_, latencyUs);
+    MEDIA_LOGI("source set to prepared: %{public}" PRIu64 " us, warm: %{public}d, audio only: %{public}d",
+        latencyUs, warmStartup_, audioOnly_);
+}
+
 void GstPlayerCtrl::HandleStopNotify()
 {
     condVarStopSync_.notify_all();
@@ -748,10 +991,34 @@ void GstPlayerCtrl::OnSeekDone()
         seekDoneNeedCb_ = false;
         condVarSeekSync_.notify_all();
 
+        RecordSeekLatency();
         MultipleSeek();
     }
 }
 
+void GstPlayerCtrl::RecordSeekLatency()
+{
+    if (seekRequestNs_ == 0) {
+        return;
+    }
+    uint64_t latencyUs = (LatencyHistogram::GetCurTimeNs() - seekRequestNs_) / NS_PER_US;
+    seekRequestNs_ = 0;
+    if (seekMode_ == SEEK_SCRUB) {
+        scrubExecuted_++;
+        ScrubStats::GetInstance().OnScrubSeekDone(latencyUs);
+        return;
+    }
+
+    if (scrubbing_) {
+        MEDIA_LOGI("scrubbing end, requested %{public}u, executed %{public}u, release latency %{public}" PRIu64
+            " us", scrubRequested_, scrubExecuted_, latencyUs);
+        ScrubStats::GetInstance().OnScrubReleased(latencyUs);
+        scrubbing_ = false;
+        scrubRequested_ = 0;
+        scrubExecuted_ = 0;
+    }
+}
+
 void GstPlayerCtrl::OnEndOfStream()
 {
     if (endOfStreamCb_) {
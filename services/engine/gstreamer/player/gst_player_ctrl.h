@@ -34,6 +34,7 @@ public:
 
     int32_t SetUri(const std::string &uri);
     int32_t SetSource(const std::shared_ptr<GstAppsrcWarp> &appsrcWarp);
+    int32_t SetNextUri(const std::string &uri);
     int32_t SetCallbacks(const std::weak_ptr<IPlayerEngineObs> &obs);
     void SetVideoTrack(bool enable);
     void Pause(bool cancelNotExecuted = false);
@@ -48,6 +49,8 @@ public:
     double GetRate();
     PlayerStates GetState() const;
     void SetRingBufferMaxSize(uint64_t size);
+    // the time when the source is set to the engine, the startup latency is recorded at the prepared.
+    void SetStartupInfo(uint64_t sourceNs, bool warm, bool audioOnly);
     static void OnStateChangedCb(const GstPlayer *player, GstPlayerState state, GstPlayerCtrl *playerGst);
     static void OnEndOfStreamCb(const GstPlayer *player, GstPlayerCtrl *playerGst);
     static void StreamDecErrorParse(const gchar *name, int32_t &errorCode);
@@ -61,8 +64,24 @@ public:
     static void OnPositionUpdatedCb(const GstPlayer *player, guint64 position, const GstPlayerCtrl *playerGst);
     static void OnVolumeChangeCb(const GObject *combiner, const GParamSpec *pspec, const GstPlayerCtrl *playerGst);
     static void OnSourceSetupCb(const GstPlayer *player, GstElement *src, const GstPlayerCtrl *playerGst);
+    static void OnAboutToFinishCb(GstElement *playbin, GstPlayerCtrl *playerGst);
+    static GstPadProbeReturn SwitchProbeCb(GstPad *pad, GstPadProbeInfo *info, gpointer userData);
 
 private:
+    enum NextSourceState : int32_t {
+        NEXT_SOURCE_NONE,
+        NEXT_SOURCE_PENDING,
+        // handed to the playbin at about-to-finish, until it is reported started.
+        NEXT_SOURCE_SWITCHING,
+    };
+    struct SwitchProbe {
+        GstPad *pad = nullptr;
+        gulong probeId = 0;
+        GstSegment segment;
+        GstClockTime lastEndTime = GST_CLOCK_TIME_NONE; // running time
+        GstClockTime prevEndTime = GST_CLOCK_TIME_NONE;
+        bool waitFirstBuffer = false;
+    };
     PlayerStates ProcessStoppedState();
     PlayerStates ProcessPausedState();
     int32_t ChangeSeekModeToGstFlag(const PlayerSeekMode mode) const;
@@ -70,14 +89,21 @@ private:
     void ProcessSeekDone(const GstPlayer *cbPlayer, uint64_t position);
     void ProcessPositionUpdated(const GstPlayer *cbPlayer, uint64_t position) const;
     void ProcessEndOfStream(const GstPlayer *cbPlayer);
+    void ProcessAboutToFinish(GstElement *playbin);
+    void ProcessSwitchProbe(SwitchProbe &probe, GstPadProbeInfo &info);
+    void AddSwitchProbe(const char *sinkName);
+    void RemoveSwitchProbes();
+    void OnNextSourceStart(int32_t gapUs);
     void OnStateChanged(PlayerStates state);
     void OnVolumeChange() const;
     void OnSeekDone();
+    void RecordSeekLatency();
+    void RecordStartupLatency();
     void OnEndOfStream();
     void OnMessage(int32_t extra) const;
     void InitDuration();
     void PlaySync();
-    void SeekSync(uint64_t position, const PlayerSeekMode mode);
+    void SeekSync(uint64_t position, const PlayerSeekMode mode, uint64_t requestNs);
     void SetRateSync(double rate);
     void MultipleSeek();
     void StopSync();
@@ -105,6 +131,17 @@ private:
     bool errorFlag_ = false;
     uint64_t nextSeekPos_ = 0;
     PlayerSeekMode nextSeekMode_ = SEEK_PREVIOUS_SYNC;
+    uint64_t nextSeekRequestNs_ = 0;
+    // the executing seek, the request time is 0 if the seek done is not for a requested seek.
+    PlayerSeekMode seekMode_ = SEEK_PREVIOUS_SYNC;
+    uint64_t seekRequestNs_ = 0;
+    // started by the first SEEK_SCRUB, and ended by the done of the next seek with another mode.
+    bool scrubbing_ = false;
+    uint32_t scrubRequested_ = 0;
+    uint32_t scrubExecuted_ = 0;
+    uint64_t sourceNs_ = 0;
+    bool warmStartup_ = false;
+    bool audioOnly_ = false;
     PlayerStates currentState_ = PLAYER_IDLE;
     uint64_t sourceDuration_ = 0;
     uint64_t seekDonePosition_ = 0;
@@ -115,6 +152,14 @@ private:
     GstElement *audioSink_ = nullptr;
     float volume_; // inited at the constructor
     std::shared_ptr<GstAppsrcWarp> appsrcWarp_ = nullptr;
+    GstElement *playbin_ = nullptr;
+    gulong signalIdAboutToFinish_ = 0;
+    // the next source is accessed in the streaming threads, guarded by the nextMutex_ instead of the mutex_.
+    std::mutex nextMutex_;
+    NextSourceState nextState_ = NEXT_SOURCE_NONE;
+    std::string nextUri_;
+    bool nextStartReported_ = false;
+    std::vector<SwitchProbe> switchProbes_;
 };
 } // Media
 } // OHOS
@@ -0,0 +1,403 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gst_player_surface_pool.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <vector>
+#include <gst/video/video.h>
+#include "display_type.h"
+#include "media_errors.h"
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "GstPlayerSurfacePool"};
+    constexpr int32_t STRIDE_ALIGNMENT = 8;
+    constexpr uint32_t RGBA_PIXEL_BYTES = 4;
+    constexpr uint32_t MAX_COPY_REQUEST_TIMES = 4;
+}
+
+namespace OHOS {
+namespace Media {
+// shared by the pool and its memories, the memories may outlive the pool.
+struct SurfacePoolState {
+    std::mutex mutex;
+    sptr<Surface> surface = nullptr;
+    GstVideoInfo info;
+    BufferRequestConfig requestConfig = {};
+    bool videoMeta = false;
+    // the addresses of the surface buffers backing the alive memories.
+    std::set<void *> aliveAddrs;
+    uint64_t surfaceAllocCount = 0;
+    uint64_t sysmemAllocCount = 0;
+};
+
+// the pools over each surface, so that the copying to the surface skips the buffers still alive in them.
+static std::mutex g_poolStatesMutex;
+static std::map<Surface *, std::vector<std::weak_ptr<SurfacePoolState>>> g_poolStates;
+
+static void RegisterPoolState(const std::shared_ptr<SurfacePoolState> &state)
+{
+    std::unique_lock<std::mutex> lock(g_poolStatesMutex);
+    for (auto it = g_poolStates.begin(); it != g_poolStates.end();) {
+        auto &states = it->second;
+        states.erase(std::remove_if(states.begin(), states.end(),
+            [](const std::weak_ptr<SurfacePoolState> &item) { return item.expired(); }), states.end());
+        it = states.empty() ? g_poolStates.erase(it) : std::next(it);
+    }
+    g_poolStates[state->surface.GetRefPtr()].push_back(state);
+}
+
+static bool IsAddrAlive(Surface *surface, void *addr)
+{
+    std::vector<std::shared_ptr<SurfacePoolState>> states;
+    {
+        std::unique_lock<std::mutex> lock(g_poolStatesMutex);
+        auto it = g_poolStates.find(surface);
+        if (it == g_poolStates.end()) {
+            return false;
+        }
+        for (auto &item : it->second) {
+            std::shared_ptr<SurfacePoolState> state = item.lock();
+            if (state != nullptr) {
+                states.push_back(state);
+            }
+        }
+    }
+
+    for (auto &state : states) {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        if (state->aliveAddrs.count(addr) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct SurfaceMemoryData {
+    std::shared_ptr<SurfacePoolState> state;
+    sptr<SurfaceBuffer> buffer;
+    void *addr;
+    bool flushed;
+};
+
+static GQuark SurfaceMemoryQuark()
+{
+    static GQuark quark = g_quark_from_static_string("GstPlayerSurfaceMemory");
+    return quark;
+}
+
+static void FreeSurfaceMemoryData(gpointer userData)
+{
+    auto data = static_cast<SurfaceMemoryData *>(userData);
+    CHECK_AND_RETURN(data != nullptr);
+    if (!data->flushed) {
+        // never rendered, such as dropped by the flushing seek.
+        (void)data->state->surface->CancelBuffer(data->buffer);
+    }
+    {
+        std::unique_lock<std::mutex> lock(data->state->mutex);
+        (void)data->state->aliveAddrs.erase(data->addr);
+    }
+    delete data;
+}
+
+static bool GetSurfaceLayout(const SurfacePoolState &state, SurfaceBuffer &surfaceBuffer,
+    gsize offset[GST_VIDEO_MAX_PLANES], gint stride[GST_VIDEO_MAX_PLANES], gsize &frameSize)
+{
+    gint width = GST_VIDEO_INFO_WIDTH(&state.info);
+    gint height = GST_VIDEO_INFO_HEIGHT(&state.info);
+    bool isRgba = GST_VIDEO_INFO_FORMAT(&state.info) == GST_VIDEO_FORMAT_RGBA;
+    gint lineSize = isRgba ? width * static_cast<gint>(RGBA_PIXEL_BYTES) : width;
+
+    BufferHandle *handle = surfaceBuffer.GetBufferHandle();
+    if (handle != nullptr && handle->stride >= lineSize) {
+        stride[0] = handle->stride;
+    } else {
+        stride[0] = (lineSize + STRIDE_ALIGNMENT - 1) / STRIDE_ALIGNMENT * STRIDE_ALIGNMENT;
+    }
+    offset[0] = 0;
+    frameSize = static_cast<gsize>(stride[0]) * static_cast<gsize>(height);
+    if (!isRgba) {
+        // the interleaved vu plane follows the y plane.
+        stride[1] = stride[0];
+        offset[1] = frameSize;
+        frameSize += static_cast<gsize>(stride[0]) * static_cast<gsize>((height + 1) / 2);
+    }
+
+    for (guint i = 0; i < GST_VIDEO_INFO_N_PLANES(&state.info); i++) {
+        if (stride[i] != GST_VIDEO_INFO_PLANE_STRIDE(&state.info, i) ||
+            offset[i] != GST_VIDEO_INFO_PLANE_OFFSET(&state.info, i)) {
+            // the writer must follow the video meta of the buffer.
+            return state.videoMeta;
+        }
+    }
+    return true;
+}
+
+static GstBuffer *AllocSurfaceBuffer(const std::shared_ptr<SurfacePoolState> &state)
+{
+    sptr<SurfaceBuffer> surfaceBuffer = nullptr;
+    int32_t releaseFence = -1;
+    SurfaceError ret = state->surface->RequestBuffer(surfaceBuffer, releaseFence, state->requestConfig);
+    if (ret != SURFACE_ERROR_OK || surfaceBuffer == nullptr) {
+        return nullptr;
+    }
+
+    void *addr = surfaceBuffer->GetVirAddr();
+    gsize offset[GST_VIDEO_MAX_PLANES] = {0};
+    gint stride[GST_VIDEO_MAX_PLANES] = {0};
+    gsize frameSize = 0;
+    bool usable = addr != nullptr && GetSurfaceLayout(*state, *surfaceBuffer, offset, stride, frameSize) &&
+        frameSize <= surfaceBuffer->GetSize();
+    if (usable) {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        // released by the consumer, but still referenced by a previous frame, such as a reference frame.
+        usable = state->aliveAddrs.insert(addr).second;
+    }
+    if (!usable) {
+        (void)state->surface->CancelBuffer(surfaceBuffer);
+        return nullptr;
+    }
+
+    auto data = new (std::nothrow) SurfaceMemoryData { state, surfaceBuffer, addr, false };
+    if (data == nullptr) {
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            (void)state->aliveAddrs.erase(addr);
+        }
+        (void)state->surface->CancelBuffer(surfaceBuffer);
+        return nullptr;
+    }
+
+    // the memory owns the data from now on, the surface buffer is cancelled if it is freed before flushing.
+    GstMemory *memory = gst_memory_new_wrapped(static_cast<GstMemoryFlags>(0), addr, surfaceBuffer->GetSize(),
+        0, frameSize, data, FreeSurfaceMemoryData);
+    if (memory == nullptr) {
+        FreeSurfaceMemoryData(data);
+        return nullptr;
+    }
+    gst_mini_object_set_qdata(GST_MINI_OBJECT_CAST(memory), SurfaceMemoryQuark(), data, nullptr);
+
+    GstBuffer *buffer = gst_buffer_new();
+    gst_buffer_append_memory(buffer, memory);
+    (void)gst_buffer_add_video_meta_full(buffer, GST_VIDEO_FRAME_FLAG_NONE, GST_VIDEO_INFO_FORMAT(&state->info),
+        GST_VIDEO_INFO_WIDTH(&state->info), GST_VIDEO_INFO_HEIGHT(&state->info),
+        GST_VIDEO_INFO_N_PLANES(&state->info), offset, stride);
+    return buffer;
+}
+} // Media
+} // OHOS
+
+using namespace OHOS;
+using namespace OHOS::Media;
+
+struct _PlayerSurfacePool {
+    GstBufferPool parent;
+    std::shared_ptr<SurfacePoolState> state;
+};
+
+#define PLAYER_TYPE_SURFACE_POOL player_surface_pool_get_type()
+    G_DECLARE_FINAL_TYPE(PlayerSurfacePool, player_surface_pool, PLAYER, SURFACE_POOL, GstBufferPool)
+
+G_DEFINE_TYPE(PlayerSurfacePool, player_surface_pool, GST_TYPE_BUFFER_POOL);
+
+static const gchar **player_surface_pool_get_options(GstBufferPool *pool)
+{
+    (void)pool;
+    static const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_META, nullptr };
+    return options;
+}
+
+static gboolean player_surface_pool_set_config(GstBufferPool *pool, GstStructure *config)
+{
+    PlayerSurfacePool *self = PLAYER_SURFACE_POOL(pool);
+    GstCaps *caps = nullptr;
+    guint size = 0;
+    guint minBuffers = 0;
+    guint maxBuffers = 0;
+    CHECK_AND_RETURN_RET_LOG(gst_buffer_pool_config_get_params(config, &caps, &size, &minBuffers, &maxBuffers),
+        FALSE, "invalid config");
+    CHECK_AND_RETURN_RET_LOG(caps != nullptr, FALSE, "no caps in config");
+
+    GstVideoInfo info;
+    CHECK_AND_RETURN_RET_LOG(gst_video_info_from_caps(&info, caps), FALSE, "invalid caps");
+
+    BufferRequestConfig requestConfig = {};
+    if (GST_VIDEO_INFO_FORMAT(&info) == GST_VIDEO_FORMAT_NV21) {
+        requestConfig.format = PIXEL_FMT_YCRCB_420_SP;
+    } else if (GST_VIDEO_INFO_FORMAT(&info) == GST_VIDEO_FORMAT_RGBA) {
+        requestConfig.format = PIXEL_FMT_RGBA_8888;
+    } else {
+        MEDIA_LOGE("unsupported format: %{public}s", GST_VIDEO_INFO_NAME(&info));
+        return FALSE;
+    }
+    requestConfig.width = GST_VIDEO_INFO_WIDTH(&info);
+    requestConfig.height = GST_VIDEO_INFO_HEIGHT(&info);
+    requestConfig.strideAlignment = STRIDE_ALIGNMENT;
+    requestConfig.usage = HBM_USE_CPU_READ | HBM_USE_CPU_WRITE | HBM_USE_MEM_DMA;
+    requestConfig.timeout = 0;
+
+    {
+        std::unique_lock<std::mutex> lock(self->state->mutex);
+        self->state->info = info;
+        self->state->requestConfig = requestConfig;
+        self->state->videoMeta = gst_buffer_pool_config_has_option(config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+    }
+    return GST_BUFFER_POOL_CLASS(player_surface_pool_parent_class)->set_config(pool, config);
+}
+
+static void AddDefaultVideoMeta(GstBuffer *buffer, const GstVideoInfo &info)
+{
+    (void)gst_buffer_add_video_meta_full(buffer, GST_VIDEO_FRAME_FLAG_NONE, GST_VIDEO_INFO_FORMAT(&info),
+        GST_VIDEO_INFO_WIDTH(&info), GST_VIDEO_INFO_HEIGHT(&info), GST_VIDEO_INFO_N_PLANES(&info),
+        const_cast<gsize *>(info.offset), const_cast<gint *>(info.stride));
+}
+
+static GstFlowReturn player_surface_pool_alloc_buffer(GstBufferPool *pool, GstBuffer **buffer,
+    GstBufferPoolAcquireParams *params)
+{
+    PlayerSurfacePool *self = PLAYER_SURFACE_POOL(pool);
+    GstBuffer *buf = AllocSurfaceBuffer(self->state);
+    if (buf != nullptr) {
+        std::unique_lock<std::mutex> lock(self->state->mutex);
+        self->state->surfaceAllocCount++;
+        *buffer = buf;
+        return GST_FLOW_OK;
+    }
+
+    // no usable surface buffer now, decode into the system memory, and it is copied when rendering.
+    GstFlowReturn ret = GST_BUFFER_POOL_CLASS(player_surface_pool_parent_class)->alloc_buffer(pool, &buf, params);
+    CHECK_AND_RETURN_RET_LOG(ret == GST_FLOW_OK && buf != nullptr, ret, "alloc system memory failed");
+    std::unique_lock<std::mutex> lock(self->state->mutex);
+    AddDefaultVideoMeta(buf, self->state->info);
+    self->state->sysmemAllocCount++;
+    *buffer = buf;
+    return GST_FLOW_OK;
+}
+
+static void player_surface_pool_release_buffer(GstBufferPool *pool, GstBuffer *buffer)
+{
+    // never recycled, a surface buffer is requested again for the next acquiring, and a flushed one
+    // must not be written anymore.
+    GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_TAG_MEMORY);
+    GST_BUFFER_POOL_CLASS(player_surface_pool_parent_class)->release_buffer(pool, buffer);
+}
+
+static void player_surface_pool_init(PlayerSurfacePool *self)
+{
+    (void)new (&self->state) std::shared_ptr<SurfacePoolState>(std::make_shared<SurfacePoolState>());
+    gst_video_info_init(&self->state->info);
+}
+
+static void player_surface_pool_finalize(GObject *object)
+{
+    PlayerSurfacePool *self = PLAYER_SURFACE_POOL(object);
+    {
+        std::unique_lock<std::mutex> lock(self->state->mutex);
+        MEDIA_LOGI("surface pool finalize, surface buffers: %{public}" PRIu64 ", system memories: %{public}" PRIu64,
+            self->state->surfaceAllocCount, self->state->sysmemAllocCount);
+    }
+    self->state.~shared_ptr<SurfacePoolState>();
+    G_OBJECT_CLASS(player_surface_pool_parent_class)->finalize(object);
+}
+
+static void player_surface_pool_class_init(PlayerSurfacePoolClass *klass)
+{
+    GObjectClass *gobjectClass = G_OBJECT_CLASS(klass);
+    GstBufferPoolClass *poolClass = GST_BUFFER_POOL_CLASS(klass);
+
+    gobjectClass->finalize = player_surface_pool_finalize;
+    poolClass->get_options = player_surface_pool_get_options;
+    poolClass->set_config = player_surface_pool_set_config;
+    poolClass->alloc_buffer = player_surface_pool_alloc_buffer;
+    poolClass->release_buffer = player_surface_pool_release_buffer;
+}
+
+namespace OHOS {
+namespace Media {
+GstBufferPool *GstPlayerSurfacePool::Create(const sptr<Surface> &surface)
+{
+    CHECK_AND_RETURN_RET_LOG(surface != nullptr, nullptr, "surface is nullptr..");
+    (void)PLAYER_IS_SURFACE_POOL(nullptr);
+    PlayerSurfacePool *self = PLAYER_SURFACE_POOL(g_object_new(PLAYER_TYPE_SURFACE_POOL, nullptr));
+    CHECK_AND_RETURN_RET_LOG(self != nullptr, nullptr, "g_object_new failed..");
+    (void)gst_object_ref_sink(self);
+
+    self->state->surface = surface;
+    RegisterPoolState(self->state);
+    return GST_BUFFER_POOL_CAST(self);
+}
+
+int32_t GstPlayerSurfacePool::RequestCopyBuffer(const sptr<Surface> &surface, sptr<SurfaceBuffer> &buffer,
+    BufferRequestConfig &requestConfig)
+{
+    CHECK_AND_RETURN_RET_LOG(surface != nullptr, MSERR_INVALID_VAL, "surface is nullptr..");
+    // the skipped buffers are held until the end, or the surface returns the same one again.
+    std::vector<sptr<SurfaceBuffer>> skipped;
+    int32_t ret = MSERR_NO_MEMORY;
+    for (uint32_t i = 0; i < MAX_COPY_REQUEST_TIMES; i++) {
+        sptr<SurfaceBuffer> surfaceBuffer = nullptr;
+        int32_t releaseFence = -1;
+        SurfaceError err = surface->RequestBuffer(surfaceBuffer, releaseFence, requestConfig);
+        if (err != SURFACE_ERROR_OK || surfaceBuffer == nullptr) {
+            MEDIA_LOGE("RequestBuffer failed(ret = %{public}d)..", err);
+            ret = MSERR_INVALID_OPERATION;
+            break;
+        }
+        if (surfaceBuffer->GetVirAddr() != nullptr && !IsAddrAlive(surface.GetRefPtr(), surfaceBuffer->GetVirAddr())) {
+            buffer = surfaceBuffer;
+            ret = MSERR_OK;
+            break;
+        }
+        // released by the consumer, but still referenced by the decoder, such as a reference frame.
+        skipped.push_back(surfaceBuffer);
+    }
+
+    for (auto &item : skipped) {
+        (void)surface->CancelBuffer(item);
+    }
+    if (ret == MSERR_NO_MEMORY) {
+        MEDIA_LOGW("no surface buffer free from the decoder to copy the frame");
+    }
+    return ret;
+}
+
+int32_t GstPlayerSurfacePool::FlushBuffer(GstBuffer &buffer, BufferFlushConfig &flushConfig)
+{
+    if (gst_buffer_n_memory(&buffer) != 1) {
+        return MSERR_INVALID_VAL;
+    }
+    GstMemory *memory = gst_buffer_peek_memory(&buffer, 0);
+    auto data = static_cast<SurfaceMemoryData *>(gst_mini_object_get_qdata(GST_MINI_OBJECT_CAST(memory),
+        SurfaceMemoryQuark()));
+    if (data == nullptr) {
+        return MSERR_INVALID_VAL;
+    }
+    // the same frame is rendered again, it has gone to the consumer.
+    CHECK_AND_RETURN_RET(!data->flushed, MSERR_INVALID_OPERATION);
+
+    SurfaceError ret = data->state->surface->FlushBuffer(data->buffer, -1, flushConfig);
+    CHECK_AND_RETURN_RET_LOG(ret == SURFACE_ERROR_OK, MSERR_INVALID_OPERATION,
+        "FlushBuffer failed(ret = %{public}d)..", ret);
+    data->flushed = true;
+    return MSERR_OK;
+}
+} // Media
+} // OHOS
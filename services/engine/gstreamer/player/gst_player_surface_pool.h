@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GST_PLAYER_SURFACE_POOL_H
+#define GST_PLAYER_SURFACE_POOL_H
+
+#include <gst/gst.h>
+#include "surface.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The buffer pool proposed to the decoders by the video sink, the buffers are backed by the buffers
+ * requested from the producer surface, so that the frames are decoded into the surface directly and
+ * the renderer only flushes them.
+ *
+ * The buffers are not recycled by the pool, a surface buffer is requested for each acquiring. If the
+ * surface has no free buffer, or the requested one is still referenced by a previous frame, such as a
+ * reference frame of the decoder, the buffer is allocated from the system memory, and it is copied to
+ * the surface when rendering.
+ */
+class GstPlayerSurfacePool {
+public:
+    GstPlayerSurfacePool() = delete;
+    ~GstPlayerSurfacePool() = delete;
+    static GstBufferPool *Create(const sptr<Surface> &surface);
+    // flush the surface buffer backing the buffer, return MSERR_INVALID_VAL if the buffer is not backed by one.
+    static int32_t FlushBuffer(GstBuffer &buffer, BufferFlushConfig &flushConfig);
+    // request a surface buffer to copy the frame into, skipping the ones still backing the memories of the pools.
+    static int32_t RequestCopyBuffer(const sptr<Surface> &surface, sptr<SurfaceBuffer> &buffer,
+        BufferRequestConfig &requestConfig);
+};
+} // Media
+} // OHOS
+#endif // GST_PLAYER_SURFACE_POOL_H
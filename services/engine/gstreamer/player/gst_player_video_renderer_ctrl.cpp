@@ -15,9 +15,11 @@
 
 #include "gst_player_video_renderer_ctrl.h"
 #include "display_type.h"
+#include "gst_player_surface_pool.h"
 #include "media_log.h"
 #include "param_wrapper.h"
 #include "media_errors.h"
+#include "media_trace.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "GstPlayerVideoRendererCtrl"};
@@ -27,7 +29,6 @@ namespace {
 
 namespace OHOS {
 namespace Media {
-const std::string SURFACE_TIME_TAG = "UpdateSurfaceBuffer";
 class GstPlayerVideoRendererCap {
 public:
     GstPlayerVideoRendererCap() = delete;
@@ -153,7 +154,6 @@ GstFlowReturn GstPlayerVideoRendererCap::VideoDataAvailableCb(const GstElement *
 GstPadProbeReturn GstPlayerVideoRendererCap::SinkPadProbeCb(GstPad *pad, GstPadProbeInfo *info, gpointer userData)
 {
     (void)pad;
-    (void)userData;
     GstQuery *query = GST_PAD_PROBE_INFO_QUERY(info);
     if (GST_QUERY_TYPE(query) == GST_QUERY_ALLOCATION) {
         GstCaps *caps = nullptr;
@@ -165,14 +165,17 @@ GstPadProbeReturn GstPlayerVideoRendererCap::SinkPadProbeCb(GstPad *pad, GstPadP
         gboolean isVideo = g_str_has_prefix(mediaType, "video/");
         if (isVideo == TRUE) {
             gst_query_add_allocation_meta(query, GST_VIDEO_META_API_TYPE, nullptr);
+            auto rendererCtrl = reinterpret_cast<GstPlayerVideoRendererCtrl *>(userData);
+            if (rendererCtrl != nullptr && caps != nullptr) {
+                rendererCtrl->ProposeSurfacePool(*query, *caps);
+            }
         }
     }
     return GST_PAD_PROBE_OK;
 }
 
 GstPlayerVideoRendererCtrl::GstPlayerVideoRendererCtrl(const sptr<Surface> &surface)
-    : producerSurface_(surface),
-      surfaceTimeMonitor_(SURFACE_TIME_TAG)
+    : producerSurface_(surface)
 {
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
     SetSurfaceTimeFromSysPara();
@@ -180,9 +183,9 @@ GstPlayerVideoRendererCtrl::GstPlayerVideoRendererCtrl(const sptr<Surface> &surf
 
 GstPlayerVideoRendererCtrl::~GstPlayerVideoRendererCtrl()
 {
-    g_signal_handler_disconnect(G_OBJECT(videoSink_), signalId_);
     producerSurface_ = nullptr;
     if (videoSink_ != nullptr) {
+        g_signal_handler_disconnect(G_OBJECT(videoSink_), signalId_);
         gst_object_unref(videoSink_);
         videoSink_ = nullptr;
     }
@@ -206,6 +209,22 @@ const GstElement *GstPlayerVideoRendererCtrl::GetVideoSink() const
     return videoSink_;
 }
 
+const sptr<Surface> &GstPlayerVideoRendererCtrl::GetSurface() const
+{
+    return producerSurface_;
+}
+
+void GstPlayerVideoRendererCtrl::ResetAudioSink() const
+{
+    if (audioSink_ == nullptr) {
+        return;
+    }
+
+    GParamSpec *spec = g_object_class_find_property(G_OBJECT_GET_CLASS(audioSink_), "volume");
+    CHECK_AND_RETURN_LOG(spec != nullptr, "the audio sink has no volume property");
+    g_object_set_property(G_OBJECT(audioSink_), "volume", g_param_spec_get_default_value(spec));
+}
+
 int32_t GstPlayerVideoRendererCtrl::InitVideoSink(const GstElement *playbin)
 {
     if (videoCaps_ == nullptr) {
@@ -287,17 +306,44 @@ void GstPlayerVideoRendererCtrl::SetSurfaceTimeFromSysPara()
     std::string timeEnable;
     int32_t res = OHOS::system::GetStringParameter("sys.media.time.surface", timeEnable, "");
     if (res != 0 || timeEnable.empty()) {
-        surfaceTimeEnable = false;
         MEDIA_LOGD("sys.media.time.surface=false");
         return;
     }
     MEDIA_LOGD("sys.media.time.surface=%{public}s", timeEnable.c_str());
 
     if (timeEnable == "true") {
-        surfaceTimeEnable = true;
+        // the surface buffer updating is traced by the render category.
+        MediaTrace::EnableCategories(MEDIA_TRACE_RENDER);
     }
 }
 
+void GstPlayerVideoRendererCtrl::ProposeSurfacePool(GstQuery &query, GstCaps &caps) const
+{
+    if (producerSurface_ == nullptr || gst_query_get_n_allocation_pools(&query) > 0) {
+        return;
+    }
+    GstVideoInfo info;
+    CHECK_AND_RETURN_LOG(gst_video_info_from_caps(&info, &caps), "invalid video caps");
+
+    GstBufferPool *pool = GstPlayerSurfacePool::Create(producerSurface_);
+    CHECK_AND_RETURN_LOG(pool != nullptr, "create surface pool failed");
+    GstStructure *config = gst_buffer_pool_get_config(pool);
+    // no limit of the buffer count, the decoder may keep many reference frames.
+    gst_buffer_pool_config_set_params(config, &caps, static_cast<guint>(GST_VIDEO_INFO_SIZE(&info)), 0, 0);
+    gst_buffer_pool_config_add_option(config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+    if (!gst_buffer_pool_set_config(pool, config)) {
+        // the frames are copied to the surface buffers when rendering.
+        MEDIA_LOGW("surface pool does not support the caps, copy the frames instead");
+        gst_object_unref(pool);
+        return;
+    }
+
+    gst_query_add_allocation_pool(&query, pool, static_cast<guint>(GST_VIDEO_INFO_SIZE(&info)), 0, 0);
+    gst_object_unref(pool);
+    MEDIA_LOGI("surface pool proposed, %{public}dx%{public}d", GST_VIDEO_INFO_WIDTH(&info),
+        GST_VIDEO_INFO_HEIGHT(&info));
+}
+
 void GstPlayerVideoRendererCtrl::UpdateResquestConfig(BufferRequestConfig &requestConfig,
     const GstVideoMeta *videoMeta) const
 {
@@ -320,9 +366,7 @@ int32_t GstPlayerVideoRendererCtrl::UpdateSurfaceBuffer(const GstBuffer &buffer)
 {
     CHECK_AND_RETURN_RET_LOG(producerSurface_ != nullptr, MSERR_INVALID_OPERATION,
         "Surface is nullptr.Video cannot be played.");
-    if (surfaceTimeEnable) {
-        surfaceTimeMonitor_.StartTime();
-    }
+    MediaTraceScope trace("GstPlayerVideoRendererCtrl::UpdateSurfaceBuffer", MEDIA_TRACE_RENDER);
     auto buf = const_cast<GstBuffer *>(&buffer);
 
     GstVideoMeta *videoMeta = gst_buffer_get_video_meta(buf);
@@ -332,35 +376,34 @@ int32_t GstPlayerVideoRendererCtrl::UpdateSurfaceBuffer(const GstBuffer &buffer)
 
     gsize size = gst_buffer_get_size(buf);
     CHECK_AND_RETURN_RET_LOG(size > 0, MSERR_INVALID_VAL, "gst_buffer_get_size failed..");
+    trace.SetArg(static_cast<int64_t>(size));
+
+    BufferFlushConfig flushConfig = {};
+    flushConfig.damage.x = 0;
+    flushConfig.damage.y = 0;
+    flushConfig.damage.w = static_cast<int32_t>(videoMeta->width);
+    flushConfig.damage.h = static_cast<int32_t>(videoMeta->height);
+    if (GstPlayerSurfacePool::FlushBuffer(*buf, flushConfig) == MSERR_OK) {
+        // decoded into the surface buffer from the surface pool, nothing to copy.
+        trace.SetArg(0);
+        return MSERR_OK;
+    }
 
     BufferRequestConfig requestConfig;
     UpdateResquestConfig(requestConfig, videoMeta);
-    int32_t releaseFence;
     sptr<SurfaceBuffer> surfaceBuffer;
 
-    SurfaceError ret = producerSurface_->RequestBuffer(surfaceBuffer, releaseFence, requestConfig);
-    CHECK_AND_RETURN_RET_LOG(ret == SURFACE_ERROR_OK, MSERR_INVALID_OPERATION,
-        "RequestBuffer failed(ret = %{public}d)..", ret);
-
-    CHECK_AND_RETURN_RET_LOG(surfaceBuffer != nullptr, MSERR_INVALID_OPERATION, "surfaceBuffer is nullptr..");
-    CHECK_AND_RETURN_RET_LOG(surfaceBuffer->GetVirAddr() != nullptr,
-        MSERR_INVALID_OPERATION, "Buffer addr is nullptr..");
+    // the surface buffers decoded into by the surface pool may still be referenced by the decoder.
+    int32_t requestRet = GstPlayerSurfacePool::RequestCopyBuffer(producerSurface_, surfaceBuffer, requestConfig);
+    CHECK_AND_RETURN_RET(requestRet == MSERR_OK, requestRet);
     gsize sizeCopy = gst_buffer_extract(buf, 0, surfaceBuffer->GetVirAddr(), size);
     if (sizeCopy != size) {
         MEDIA_LOGW("extract buffer from size : %" G_GSIZE_FORMAT " to size %" G_GSIZE_FORMAT, size, sizeCopy);
     }
 
-    BufferFlushConfig flushConfig = {};
-    flushConfig.damage.x = 0;
-    flushConfig.damage.y = 0;
-    flushConfig.damage.w = static_cast<int32_t>(videoMeta->width);
-    flushConfig.damage.h = static_cast<int32_t>(videoMeta->height);
-    ret = producerSurface_->FlushBuffer(surfaceBuffer, -1, flushConfig);
+    SurfaceError ret = producerSurface_->FlushBuffer(surfaceBuffer, -1, flushConfig);
     CHECK_AND_RETURN_RET_LOG(ret == SURFACE_ERROR_OK, MSERR_INVALID_OPERATION,
         "FlushBuffer failed(ret = %{public}d)..", ret);
-    if (surfaceTimeEnable) {
-        surfaceTimeMonitor_.FinishTime();
-    }
     return MSERR_OK;
 }
 
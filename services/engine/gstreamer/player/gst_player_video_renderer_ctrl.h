@@ -21,7 +21,6 @@
 #include <gst/gst.h>
 #include <gst/player/player.h>
 #include "i_player_engine.h"
-#include "time_monitor.h"
 
 namespace OHOS {
 namespace Media {
@@ -32,8 +31,13 @@ public:
     int32_t InitVideoSink(const GstElement *playbin);
     int32_t InitAudioSink(const GstElement *playbin);
     const GstElement *GetVideoSink() const;
+    const sptr<Surface> &GetSurface() const;
+    // restore the sink settings changed by the last source, when the renderer is reused by the next one.
+    void ResetAudioSink() const;
     int32_t PullVideoBuffer();
     int32_t UpdateSurfaceBuffer(const GstBuffer &buffer);
+    // answer the allocation query of the video sink with a pool backed by the surface buffers.
+    void ProposeSurfacePool(GstQuery &query, GstCaps &caps) const;
 
 private:
     void UpdateResquestConfig(BufferRequestConfig &requestConfig, const GstVideoMeta *videoMeta) const;
@@ -45,8 +49,6 @@ private:
     GstElement *audioSink_ = nullptr;
     GstCaps *videoCaps_ = nullptr;
     GstCaps *audioCaps_ = nullptr;
-    bool surfaceTimeEnable = false;
-    TimeMonitor surfaceTimeMonitor_;
     gulong signalId_ = 0;
 };
 
@@ -19,9 +19,12 @@
 #include "media_log.h"
 #include "media_errors.h"
 #include "directory_ex.h"
+#include "uri_helper.h"
+#include "latency_histogram.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "PlayerEngineGstImpl"};
+    constexpr uint64_t NS_PER_US = 1000;
 }
 
 namespace OHOS {
@@ -34,6 +37,7 @@ constexpr float SPEED_1_75_X = 1.75;
 constexpr float SPEED_2_00_X = 2.00;
 constexpr size_t MAX_URI_SIZE = 4096;
 constexpr uint64_t RING_BUFFER_MAX_SIZE = 5242880; // 5 * 1024 * 1024
+constexpr uint64_t AUDIO_RING_BUFFER_MAX_SIZE = 1048576; // 1 * 1024 * 1024
 
 PlayerEngineGstImpl::PlayerEngineGstImpl()
 {
@@ -42,7 +46,11 @@ PlayerEngineGstImpl::PlayerEngineGstImpl()
 
 PlayerEngineGstImpl::~PlayerEngineGstImpl()
 {
-    (void)Reset();
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (playerCtrl_ != nullptr) {
+        playerCtrl_->Stop(true);
+    }
+    GstPlayerDeInit();
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
 }
 
@@ -76,36 +84,71 @@ int32_t PlayerEngineGstImpl::GetRealPath(const std::string &uri, std::string &re
     return MSERR_OK;
 }
 
-int32_t PlayerEngineGstImpl::SetSource(const std::string &uri)
+int32_t PlayerEngineGstImpl::FormatUri(const std::string &uri, std::string &formattedUri) const
 {
-    std::unique_lock<std::mutex> lock(mutex_);
     CHECK_AND_RETURN_RET_LOG(!uri.empty(), MSERR_INVALID_VAL, "input uri is empty!");
     CHECK_AND_RETURN_RET_LOG(uri.length() <= MAX_URI_SIZE, MSERR_INVALID_VAL, "input uri length is invalid!");
 
-    std::string realUriPath;
-    int32_t ret = MSERR_UNKNOWN;
-
     if (IsFileUri(uri)) {
-        ret = GetRealPath(uri, realUriPath);
+        std::string realUriPath;
+        int32_t ret = GetRealPath(uri, realUriPath);
         if (ret != MSERR_OK) {
             return ret;
         }
-        uri_ = "file://" + realUriPath;
-    } else {
-        uri_ = uri;
-        ret = MSERR_OK;
+        formattedUri = "file://" + realUriPath;
+        return MSERR_OK;
     }
 
+    UriHelper uriHelper = UriHelper(uri).FormatMe();
+    if (uriHelper.IsFdScheme()) {
+        CHECK_AND_RETURN_RET_LOG(uriHelper.UriType() == UriHelper::URI_TYPE_FD &&
+            uriHelper.AccessCheck(UriHelper::URI_READ), MSERR_INVALID_VAL, "invalid fd uri: %{public}s", uri.c_str());
+        formattedUri = uriHelper.FormattedUri();
+        return MSERR_OK;
+    }
+
+    // the other schemes are not passed to the playbin, it would pick any source element for them.
+    CHECK_AND_RETURN_RET_LOG(uriHelper.UriType() == UriHelper::URI_TYPE_HTTP, MSERR_UNSUPPORT,
+        "unsupported uri: %{public}s", uri.c_str());
+    formattedUri = uri;
+    return MSERR_OK;
+}
+
+int32_t PlayerEngineGstImpl::SetSource(const std::string &uri)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    int32_t ret = FormatUri(uri, uri_);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+    sourceNs_ = LatencyHistogram::GetCurTimeNs();
+
     MEDIA_LOGI("set player source: %{public}s", uri_.c_str());
     return ret;
 }
 
+int32_t PlayerEngineGstImpl::SetNextSource(const std::string &uri)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(playerCtrl_ != nullptr, MSERR_INVALID_OPERATION, "playerCtrl_ is nullptr");
+    // the appsrc is bound to the data source of the pipeline.
+    CHECK_AND_RETURN_RET_LOG(appsrcWarp_ == nullptr, MSERR_INVALID_OPERATION,
+        "the data source can not be followed by a next source");
+
+    // resolved and checked now, the playbin takes it at the end of the current source.
+    std::string nextUri;
+    int32_t ret = FormatUri(uri, nextUri);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    MEDIA_LOGI("set player next source: %{public}s", nextUri.c_str());
+    return playerCtrl_->SetNextUri(nextUri);
+}
+
 int32_t PlayerEngineGstImpl::SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc)
 {
     std::unique_lock<std::mutex> lock(mutex_);
     CHECK_AND_RETURN_RET_LOG(dataSrc != nullptr, MSERR_INVALID_VAL, "input dataSrc is empty!");
     appsrcWarp_ = GstAppsrcWarp::Create(dataSrc);
     CHECK_AND_RETURN_RET_LOG(appsrcWarp_ != nullptr, MSERR_NO_MEMORY, "new appsrcwarp failed!");
+    sourceNs_ = LatencyHistogram::GetCurTimeNs();
     return MSERR_OK;
 }
 
@@ -125,6 +168,13 @@ int32_t PlayerEngineGstImpl::SetVideoSurface(sptr<Surface> surface)
     return MSERR_OK;
 }
 
+int32_t PlayerEngineGstImpl::SetAudioOnly(bool audioOnly)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    audioOnly_ = audioOnly;
+    return MSERR_OK;
+}
+
 int32_t PlayerEngineGstImpl::Prepare()
 {
     std::unique_lock<std::mutex> lock(mutex_);
@@ -169,7 +219,7 @@ void PlayerEngineGstImpl::PlayerLoop()
     playerBuild_ = std::make_unique<GstPlayerBuild>();
     CHECK_AND_RETURN_LOG(playerBuild_ != nullptr, "playerBuild_ is nullptr");
 
-    playerCtrl_ = playerBuild_->Build(producerSurface_);
+    playerCtrl_ = playerBuild_->Build(producerSurface_, audioOnly_);
     CHECK_AND_RETURN_LOG(playerCtrl_ != nullptr, "playerCtrl_ is nullptr");
 
     condVarSync_.notify_all();
@@ -186,8 +236,24 @@ int32_t PlayerEngineGstImpl::GstPlayerInit()
     }
 
     MEDIA_LOGD("GstPlayerInit in");
-    playerThread_.reset(new(std::nothrow) std::thread(&PlayerEngineGstImpl::PlayerLoop, this));
-    CHECK_AND_RETURN_RET_LOG(playerThread_ != nullptr, MSERR_INVALID_VAL, "std::thread failed..");
+    uint64_t startNs = LatencyHistogram::GetCurTimeNs();
+    bool warm = false;
+    if (gstPlayerRecycled_) {
+        gstPlayerRecycled_ = false;
+        if (playerBuild_ != nullptr && playerBuild_->CanRebuild(producerSurface_, audioOnly_)) {
+            playerCtrl_ = playerBuild_->Rebuild();
+            warm = playerCtrl_ != nullptr;
+        }
+        if (!warm) {
+            MEDIA_LOGI("the kept gstplayer can not be reused, build a new one");
+            GstPlayerRelease();
+        }
+    }
+
+    if (!warm) {
+        playerThread_.reset(new(std::nothrow) std::thread(&PlayerEngineGstImpl::PlayerLoop, this));
+        CHECK_AND_RETURN_RET_LOG(playerThread_ != nullptr, MSERR_INVALID_VAL, "std::thread failed..");
+    }
 
     if (!playerCtrl_) {
         MEDIA_LOGI("Player not yet initialized, wait for 1 second");
@@ -200,6 +266,7 @@ int32_t PlayerEngineGstImpl::GstPlayerInit()
         }
     }
 
+    playerCtrl_->SetStartupInfo(sourceNs_, warm, audioOnly_);
     int ret = GstPlayerPrepare();
     if (ret != MSERR_OK) {
         MEDIA_LOGE("GstPlayerPrepare failed");
@@ -207,12 +274,13 @@ int32_t PlayerEngineGstImpl::GstPlayerInit()
         return MSERR_INVALID_VAL;
     }
 
-    MEDIA_LOGI("GstPlayerInit out");
+    MEDIA_LOGI("GstPlayerInit out, warm: %{public}d, cost: %{public}" PRIu64 " us",
+        warm, (LatencyHistogram::GetCurTimeNs() - startNs) / NS_PER_US);
     gstPlayerInit_ = true;
     return MSERR_OK;
 }
 
-void PlayerEngineGstImpl::GstPlayerDeInit()
+void PlayerEngineGstImpl::GstPlayerRelease()
 {
     if (playerBuild_ != nullptr) {
         playerBuild_->DestroyLoop();
@@ -225,9 +293,41 @@ void PlayerEngineGstImpl::GstPlayerDeInit()
     playerCtrl_ = nullptr;
     playerBuild_ = nullptr;
     gstPlayerInit_ = false;
+    gstPlayerRecycled_ = false;
+}
+
+void PlayerEngineGstImpl::GstPlayerDeInit()
+{
+    GstPlayerRelease();
     appsrcWarp_ = nullptr;
 }
 
+void PlayerEngineGstImpl::GstPlayerRecycle()
+{
+    if (gstPlayerRecycled_ && !gstPlayerInit_) {
+        // reset again before the kept gstplayer is reused.
+        appsrcWarp_ = nullptr;
+        producerSurface_ = nullptr;
+        return;
+    }
+
+    // only the stopped gstplayer is kept, the one in error or not built is released.
+    bool recyclable = gstPlayerInit_ && playerBuild_ != nullptr && playerCtrl_ != nullptr &&
+        playerCtrl_->GetState() == PLAYER_STOPPED;
+    playerCtrl_ = nullptr;
+    if (!recyclable || !playerBuild_->ReleaseCtrl()) {
+        GstPlayerDeInit();
+        return;
+    }
+
+    gstPlayerInit_ = false;
+    gstPlayerRecycled_ = true;
+    appsrcWarp_ = nullptr;
+    // the surface must be set again by the next source.
+    producerSurface_ = nullptr;
+    MEDIA_LOGI("the gstplayer is kept for the next source");
+}
+
 int32_t PlayerEngineGstImpl::GstPlayerPrepare() const
 {
     MEDIA_LOGI("GstPlayerPrepare In");
@@ -235,7 +335,7 @@ int32_t PlayerEngineGstImpl::GstPlayerPrepare() const
     int32_t ret = MSERR_OK;
     if (appsrcWarp_ == nullptr) {
         ret = playerCtrl_->SetUri(uri_);
-        playerCtrl_->SetRingBufferMaxSize(RING_BUFFER_MAX_SIZE);
+        playerCtrl_->SetRingBufferMaxSize(audioOnly_ ? AUDIO_RING_BUFFER_MAX_SIZE : RING_BUFFER_MAX_SIZE);
     } else {
         ret = playerCtrl_->SetSource(appsrcWarp_);
     }
@@ -381,7 +481,7 @@ int32_t PlayerEngineGstImpl::Reset()
     if (playerCtrl_ != nullptr) {
         playerCtrl_->Stop(true);
     }
-    GstPlayerDeInit();
+    GstPlayerRecycle();
     return MSERR_OK;
 }
 
@@ -39,6 +39,7 @@ public:
 
     int32_t SetSource(const std::string &uri) override;
     int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc) override;
+    int32_t SetNextSource(const std::string &uri) override;
     int32_t SetObs(const std::weak_ptr<IPlayerEngineObs> &obs) override;
     int32_t SetVideoSurface(sptr<Surface> surface) override;
     int32_t Prepare() override;
@@ -54,6 +55,7 @@ public:
     int32_t SetPlaybackSpeed(PlaybackRateMode mode) override;
     int32_t GetPlaybackSpeed(PlaybackRateMode &mode) override;
     int32_t SetLooping(bool loop) override;
+    int32_t SetAudioOnly(bool audioOnly) override;
 
 private:
     double ChangeModeToSpeed(const PlaybackRateMode &mode) const;
@@ -62,7 +64,10 @@ private:
     int32_t GstPlayerPrepare() const;
     void PlayerLoop();
     void GstPlayerDeInit();
+    void GstPlayerRelease();
+    void GstPlayerRecycle();
     int32_t GetRealPath(const std::string &uri, std::string &realUriPath) const;
+    int32_t FormatUri(const std::string &uri, std::string &formattedUri) const;
     bool IsFileUri(const std::string &uri) const;
     std::mutex mutex_;
     std::mutex mutexSync_;
@@ -70,9 +75,13 @@ private:
     std::shared_ptr<GstPlayerCtrl> playerCtrl_ = nullptr;
     std::weak_ptr<IPlayerEngineObs> obs_;
     sptr<Surface> producerSurface_ = nullptr;
+    bool audioOnly_ = false;
     std::string uri_ = "";
     std::condition_variable condVarSync_;
     bool gstPlayerInit_ = false;
+    // the gstplayer and its loop thread are kept by the reset, and reused by the next source.
+    bool gstPlayerRecycled_ = false;
+    uint64_t sourceNs_ = 0;
     std::unique_ptr<std::thread> playerThread_;
     std::shared_ptr<GstAppsrcWarp> appsrcWarp_ = nullptr;
 };
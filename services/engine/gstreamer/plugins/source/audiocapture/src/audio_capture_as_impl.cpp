@@ -16,6 +16,7 @@
 #include "audio_capture_as_impl.h"
 #include <vector>
 #include "media_log.h"
+#include "media_trace.h"
 #include "audio_errors.h"
 #include "media_errors.h"
 
@@ -135,6 +136,7 @@ int32_t AudioCaptureAsImpl::StartAudioCapture()
 
 std::shared_ptr<AudioBuffer> AudioCaptureAsImpl::GetBuffer()
 {
+    MediaTraceScope trace("AudioCaptureAsImpl::GetBuffer", MEDIA_TRACE_RECORDER);
     CHECK_AND_RETURN_RET(audioCapturer_ != nullptr, nullptr);
     std::shared_ptr<AudioBuffer> buffer = std::make_shared<AudioBuffer>();
     CHECK_AND_RETURN_RET(buffer != nullptr, nullptr);
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GST_FD_RANGE_SRC_H__
+#define __GST_FD_RANGE_SRC_H__
+
+#include <gst/base/gstbasesrc.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_FD_RANGE_SRC \
+    (gst_fd_range_src_get_type())
+#define GST_FD_RANGE_SRC(obj) \
+    (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_FD_RANGE_SRC, GstFdRangeSrc))
+#define GST_FD_RANGE_SRC_CLASS(klass) \
+    (G_TYPE_CHECK_CLASS_CAST((klass), GST_TYPE_FD_RANGE_SRC, GstFdRangeSrcClass))
+#define GST_IS_FD_RANGE_SRC(obj) \
+    (G_TYPE_CHECK_INSTANCE_TYPE((obj), GST_TYPE_FD_RANGE_SRC))
+#define GST_IS_FD_RANGE_SRC_CLASS(klass) \
+    (G_TYPE_CHECK_CLASS_TYPE((klass), GST_TYPE_FD_RANGE_SRC))
+#define GST_FD_RANGE_SRC_CAST(obj) ((GstFdRangeSrc *)obj)
+
+/**
+ * GstFdRangeSrc:
+ *
+ * Read the [offset, offset + size) range of a regular file fd by pread. The fd is not
+ * owned by the element, it must be kept open until the element is disposed.
+ */
+struct _GstFdRangeSrc {
+    GstBaseSrc parent_element;
+
+    /* private */
+    gint fd;
+    gint64 offset;
+    gint64 size; /* -1 means to the file end */
+    guint64 read_size; /* the size of the range, computed at start */
+    gchar *uri;
+};
+
+struct _GstFdRangeSrcClass {
+    GstBaseSrcClass parent_class;
+};
+
+using GstFdRangeSrc = struct _GstFdRangeSrc;
+using GstFdRangeSrcClass = struct _GstFdRangeSrcClass;
+
+GType gst_fd_range_src_get_type(void);
+
+G_END_DECLS
+#endif /* __GST_FD_RANGE_SRC_H__ */
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "config.h"
+#include "gst_fd_range_src.h"
+#include <cerrno>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <gst/gst.h>
+#include "uri_helper.h"
+
+static GstStaticPadTemplate gst_fd_range_src_template =
+GST_STATIC_PAD_TEMPLATE("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+enum {
+    PROP_0,
+    PROP_FD,
+    PROP_OFFSET,
+    PROP_SIZE,
+};
+
+using namespace OHOS::Media;
+
+static void gst_fd_range_src_uri_handler_init(gpointer g_iface, gpointer iface_data);
+
+#define gst_fd_range_src_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE(GstFdRangeSrc, gst_fd_range_src, GST_TYPE_BASE_SRC,
+    G_IMPLEMENT_INTERFACE(GST_TYPE_URI_HANDLER, gst_fd_range_src_uri_handler_init));
+
+static void gst_fd_range_src_finalize(GObject *object);
+static void gst_fd_range_src_set_property(GObject *object, guint prop_id,
+    const GValue *value, GParamSpec *pspec);
+static void gst_fd_range_src_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec);
+static gboolean gst_fd_range_src_start(GstBaseSrc *basesrc);
+static gboolean gst_fd_range_src_stop(GstBaseSrc *basesrc);
+static gboolean gst_fd_range_src_is_seekable(GstBaseSrc *basesrc);
+static gboolean gst_fd_range_src_get_size(GstBaseSrc *basesrc, guint64 *size);
+static GstFlowReturn gst_fd_range_src_fill(GstBaseSrc *basesrc, guint64 offset, guint length, GstBuffer *buf);
+
+static void gst_fd_range_src_class_init(GstFdRangeSrcClass *klass)
+{
+    GObjectClass *gobject_class = reinterpret_cast<GObjectClass *>(klass);
+    GstElementClass *gstelement_class = reinterpret_cast<GstElementClass *>(klass);
+    GstBaseSrcClass *gstbasesrc_class = reinterpret_cast<GstBaseSrcClass *>(klass);
+
+    gobject_class->finalize = gst_fd_range_src_finalize;
+    gobject_class->set_property = gst_fd_range_src_set_property;
+    gobject_class->get_property = gst_fd_range_src_get_property;
+
+    g_object_class_install_property(gobject_class, PROP_FD,
+        g_param_spec_int("fd", "Fd",
+            "The regular file fd to read, not owned by the element", -1, G_MAXINT32, -1,
+            (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(gobject_class, PROP_OFFSET,
+        g_param_spec_int64("offset", "Offset",
+            "The start offset of the range in the file", 0, G_MAXINT64, 0,
+            (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(gobject_class, PROP_SIZE,
+        g_param_spec_int64("size", "Size",
+            "The size of the range, -1 means to the file end", -1, G_MAXINT64, -1,
+            (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    gst_element_class_set_static_metadata(gstelement_class,
+        "Fd range source", "Source/File",
+        "Read a range of the file fd by pread", "Harmony OS");
+
+    gst_element_class_add_static_pad_template(gstelement_class, &gst_fd_range_src_template);
+
+    gstbasesrc_class->start = gst_fd_range_src_start;
+    gstbasesrc_class->stop = gst_fd_range_src_stop;
+    gstbasesrc_class->is_seekable = gst_fd_range_src_is_seekable;
+    gstbasesrc_class->get_size = gst_fd_range_src_get_size;
+    gstbasesrc_class->fill = gst_fd_range_src_fill;
+}
+
+static void gst_fd_range_src_init(GstFdRangeSrc *src)
+{
+    src->fd = -1;
+    src->offset = 0;
+    src->size = -1;
+    src->read_size = 0;
+    src->uri = nullptr;
+}
+
+static void gst_fd_range_src_finalize(GObject *object)
+{
+    GstFdRangeSrc *src = GST_FD_RANGE_SRC(object);
+    g_free(src->uri);
+    src->uri = nullptr;
+    G_OBJECT_CLASS(parent_class)->finalize(object);
+}
+
+static void gst_fd_range_src_update_uri(GstFdRangeSrc *src)
+{
+    g_free(src->uri);
+    std::string uri = UriHelper::MakeFdUri(src->fd, src->offset, src->size);
+    src->uri = g_strdup(uri.c_str());
+}
+
+static void gst_fd_range_src_set_property(GObject *object, guint prop_id,
+    const GValue *value, GParamSpec *pspec)
+{
+    (void)pspec;
+    GstFdRangeSrc *src = GST_FD_RANGE_SRC(object);
+    GST_OBJECT_LOCK(src);
+    switch (prop_id) {
+        case PROP_FD:
+            src->fd = g_value_get_int(value);
+            break;
+        case PROP_OFFSET:
+            src->offset = g_value_get_int64(value);
+            break;
+        case PROP_SIZE:
+            src->size = g_value_get_int64(value);
+            break;
+        default:
+            break;
+    }
+    gst_fd_range_src_update_uri(src);
+    GST_OBJECT_UNLOCK(src);
+}
+
+static void gst_fd_range_src_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+    (void)pspec;
+    GstFdRangeSrc *src = GST_FD_RANGE_SRC(object);
+    GST_OBJECT_LOCK(src);
+    switch (prop_id) {
+        case PROP_FD:
+            g_value_set_int(value, src->fd);
+            break;
+        case PROP_OFFSET:
+            g_value_set_int64(value, src->offset);
+            break;
+        case PROP_SIZE:
+            g_value_set_int64(value, src->size);
+            break;
+        default:
+            break;
+    }
+    GST_OBJECT_UNLOCK(src);
+}
+
+static gboolean gst_fd_range_src_start(GstBaseSrc *basesrc)
+{
+    GstFdRangeSrc *src = GST_FD_RANGE_SRC(basesrc);
+    struct stat64 st = {};
+    if (src->fd < 0 || fstat64(src->fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        GST_ELEMENT_ERROR(src, RESOURCE, OPEN_READ, (nullptr), ("invalid fd %d, errno: %d", src->fd, errno));
+        return FALSE;
+    }
+
+    gint64 file_size = static_cast<gint64>(st.st_size);
+    if (src->offset >= file_size) {
+        GST_ELEMENT_ERROR(src, RESOURCE, OPEN_READ, (nullptr),
+            ("offset %" G_GINT64_FORMAT " exceeds file size %" G_GINT64_FORMAT, src->offset, file_size));
+        return FALSE;
+    }
+
+    gint64 read_size = file_size - src->offset;
+    if (src->size >= 0 && src->size < read_size) {
+        read_size = src->size;
+    }
+    src->read_size = static_cast<guint64>(read_size);
+    GST_INFO_OBJECT(src, "read fd %d, offset %" G_GINT64_FORMAT ", size %" G_GUINT64_FORMAT,
+        src->fd, src->offset, src->read_size);
+    return TRUE;
+}
+
+static gboolean gst_fd_range_src_stop(GstBaseSrc *basesrc)
+{
+    GstFdRangeSrc *src = GST_FD_RANGE_SRC(basesrc);
+    src->read_size = 0;
+    return TRUE;
+}
+
+static gboolean gst_fd_range_src_is_seekable(GstBaseSrc *basesrc)
+{
+    (void)basesrc;
+    return TRUE;
+}
+
+static gboolean gst_fd_range_src_get_size(GstBaseSrc *basesrc, guint64 *size)
+{
+    GstFdRangeSrc *src = GST_FD_RANGE_SRC(basesrc);
+    if (src->read_size == 0) {
+        return FALSE;
+    }
+    *size = src->read_size;
+    return TRUE;
+}
+
+static GstFlowReturn gst_fd_range_src_fill(GstBaseSrc *basesrc, guint64 offset, guint length, GstBuffer *buf)
+{
+    GstFdRangeSrc *src = GST_FD_RANGE_SRC(basesrc);
+    if (offset >= src->read_size) {
+        return GST_FLOW_EOS;
+    }
+    if (length > src->read_size - offset) {
+        length = static_cast<guint>(src->read_size - offset);
+    }
+
+    GstMapInfo info = GST_MAP_INFO_INIT;
+    if (!gst_buffer_map(buf, &info, GST_MAP_WRITE)) {
+        GST_ELEMENT_ERROR(src, RESOURCE, READ, (nullptr), ("map buffer failed"));
+        return GST_FLOW_ERROR;
+    }
+
+    // pread does not move the file offset, so the fd can be shared with others.
+    guint done = 0;
+    while (done < length) {
+        ssize_t ret = pread64(src->fd, info.data + done, length - done,
+            static_cast<off64_t>(src->offset + offset + done));
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            gst_buffer_unmap(buf, &info);
+            GST_ELEMENT_ERROR(src, RESOURCE, READ, (nullptr), ("pread failed, errno: %d", errno));
+            return GST_FLOW_ERROR;
+        }
+        if (ret == 0) {
+            break; // the file is truncated.
+        }
+        done += static_cast<guint>(ret);
+    }
+    gst_buffer_unmap(buf, &info);
+
+    if (done == 0) {
+        return GST_FLOW_EOS;
+    }
+    gst_buffer_resize(buf, 0, done);
+    GST_BUFFER_OFFSET(buf) = offset;
+    GST_BUFFER_OFFSET_END(buf) = offset + done;
+    return GST_FLOW_OK;
+}
+
+static GstURIType gst_fd_range_src_uri_get_type(GType type)
+{
+    (void)type;
+    return GST_URI_SRC;
+}
+
+static const gchar *const *gst_fd_range_src_uri_get_protocols(GType type)
+{
+    (void)type;
+    static const gchar *protocols[] = { "fd", nullptr };
+    return protocols;
+}
+
+static gchar *gst_fd_range_src_uri_get_uri(GstURIHandler *handler)
+{
+    GstFdRangeSrc *src = GST_FD_RANGE_SRC(handler);
+    GST_OBJECT_LOCK(src);
+    gchar *uri = g_strdup(src->uri);
+    GST_OBJECT_UNLOCK(src);
+    return uri;
+}
+
+static gboolean gst_fd_range_src_uri_set_uri(GstURIHandler *handler, const gchar *uri, GError **error)
+{
+    GstFdRangeSrc *src = GST_FD_RANGE_SRC(handler);
+    if (GST_STATE(src) != GST_STATE_NULL && GST_STATE(src) != GST_STATE_READY) {
+        g_set_error(error, GST_URI_ERROR, GST_URI_ERROR_BAD_STATE,
+            "Changing the uri on fdrangesrc when it is running is not supported");
+        return FALSE;
+    }
+
+    UriHelper uriHelper = UriHelper(uri).FormatMe();
+    if (uriHelper.UriType() != UriHelper::URI_TYPE_FD) {
+        g_set_error(error, GST_URI_ERROR, GST_URI_ERROR_BAD_URI, "Invalid fd uri: %s", uri);
+        return FALSE;
+    }
+
+    GST_OBJECT_LOCK(src);
+    src->fd = uriHelper.GetFd();
+    src->offset = uriHelper.GetOffset();
+    src->size = uriHelper.GetSize();
+    gst_fd_range_src_update_uri(src);
+    GST_OBJECT_UNLOCK(src);
+    return TRUE;
+}
+
+static void gst_fd_range_src_uri_handler_init(gpointer g_iface, gpointer iface_data)
+{
+    (void)iface_data;
+    GstURIHandlerInterface *iface = reinterpret_cast<GstURIHandlerInterface *>(g_iface);
+    iface->get_type = gst_fd_range_src_uri_get_type;
+    iface->get_protocols = gst_fd_range_src_uri_get_protocols;
+    iface->get_uri = gst_fd_range_src_uri_get_uri;
+    iface->set_uri = gst_fd_range_src_uri_set_uri;
+}
+
+static gboolean plugin_init(GstPlugin *plugin)
+{
+    // ranked above the fdsrc of the core elements, which can not read a sub-range.
+    return gst_element_register(plugin, "fdrangesrc", GST_RANK_PRIMARY, GST_TYPE_FD_RANGE_SRC);
+}
+
+GST_PLUGIN_DEFINE(GST_VERSION_MAJOR,
+    GST_VERSION_MINOR,
+    _fd_range_src,
+    "GStreamer Fd Range Source",
+    plugin_init,
+    PACKAGE_VERSION, GST_LICENSE, GST_PACKAGE_NAME, GST_PACKAGE_ORIGIN)
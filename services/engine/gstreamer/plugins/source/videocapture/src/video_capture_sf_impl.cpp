@@ -16,6 +16,7 @@
 #include "video_capture_sf_impl.h"
 #include <map>
 #include "media_log.h"
+#include "media_trace.h"
 #include "media_errors.h"
 
 namespace {
@@ -153,6 +154,7 @@ std::shared_ptr<VideoFrameBuffer> VideoCaptureSfImpl::GetFrameBufferInner()
 
 std::shared_ptr<VideoFrameBuffer> VideoCaptureSfImpl::GetFrameBuffer()
 {
+    MediaTraceScope trace("VideoCaptureSfImpl::GetFrameBuffer", MEDIA_TRACE_RECORDER);
     if (bufferNumber_  == 0) {
         return GetFrameBufferInner();
     } else {
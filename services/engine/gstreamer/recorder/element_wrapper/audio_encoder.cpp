@@ -35,6 +35,8 @@ int32_t AudioEncoder::Init()
     }
 
     MEDIA_LOGI("use avenc_aac");
+    AddTraceProbe(gstElem_, "sink", "AudioEncoder::Input");
+    AddTraceProbe(gstElem_, "src", "AudioEncoder::Output");
 
     return MSERR_OK;
 }
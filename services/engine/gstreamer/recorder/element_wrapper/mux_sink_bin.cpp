@@ -68,6 +68,7 @@ int32_t MuxSinkBin::Init()
     }
 
     CANCEL_SCOPE_EXIT_GUARD(0);
+    AddTraceProbe(gstSink_, "sink", "MuxSinkBin::Write");
     g_object_set(gstElem_, "sink", gstSink_, nullptr);
     return MSERR_OK;
 }
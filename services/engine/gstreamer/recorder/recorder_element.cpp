@@ -19,6 +19,7 @@
 #include <unordered_map>
 #include "media_errors.h"
 #include "media_log.h"
+#include "media_trace.h"
 #include "recorder_private_param.h"
 
 namespace {
@@ -114,6 +115,25 @@ RecorderMsgProcResult RecorderElement::OnMessageReceived(GstMessage &rawMsg, Rec
     return ret;
 }
 
+void RecorderElement::AddTraceProbe(GstElement *element, const char *padName, const char *eventName)
+{
+    CHECK_AND_RETURN(element != nullptr);
+    GstPad *pad = gst_element_get_static_pad(element, padName);
+    CHECK_AND_RETURN_LOG(pad != nullptr, "no pad %{public}s", padName);
+
+    auto probe = [](GstPad *probePad, GstPadProbeInfo *info, gpointer userData) -> GstPadProbeReturn {
+        (void)probePad;
+        if (MediaTrace::IsEnabled(MEDIA_TRACE_RECORDER)) {
+            GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+            int64_t size = (buffer != nullptr) ? static_cast<int64_t>(gst_buffer_get_size(buffer)) : 0;
+            MediaTrace::RecordInstant(static_cast<const char *>(userData), MEDIA_TRACE_RECORDER, size);
+        }
+        return GST_PAD_PROBE_OK;
+    };
+    (void)gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, probe, const_cast<char *>(eventName), nullptr);
+    gst_object_unref(pad);
+}
+
 bool RecorderElement::CheckAllParamsConfiged(const std::set<int32_t>& expectedParams) const
 {
     std::set<int32_t> intersection;
@@ -217,6 +217,15 @@ protected:
         return configedParams_.find(paramType) != configedParams_.end();
     }
 
+    /**
+     * @brief Record a trace instant event with the buffer size for each buffer passing the pad.
+     * @param element: the element owns the pad
+     * @param padName: the static pad name
+     * @param eventName: string literal, the name of the trace event
+     * @return None.
+     */
+    static void AddTraceProbe(GstElement *element, const char *padName, const char *eventName);
+
     /**
      * @brief Check whether the all specified type's parameters is configured.
      * @param expectedParams: the enum value set of RecorderParamType
@@ -16,6 +16,7 @@
 #include "recorder_pipeline_ctrler.h"
 #include "media_log.h"
 #include "media_errors.h"
+#include "inline_task_handler.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "RecorderPipelineCtrler"};
@@ -71,7 +72,7 @@ int32_t RecorderPipelineCtrler::Init()
     int32_t ret = cmdQ_->Start();
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
-    msgQ_ = std::make_unique<TaskQueue>("rec-pipe-ctrler-msg");
+    msgQ_ = std::make_unique<TaskQueue>("rec-pipe-ctrler-msg", TaskQueue::SHARED_POOL);
     ret = msgQ_->Start();
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
@@ -184,7 +185,7 @@ int32_t RecorderPipelineCtrler::Reset()
 
 void RecorderPipelineCtrler::Notify(const RecorderMessage &msg)
 {
-    auto notifyTask = std::make_shared<TaskHandler<void>>([this, msg] {
+    auto notifyTask = InlineTaskHandler::Create([this, msg] {
         std::shared_ptr<IRecorderEngineObs> obs = obs_.lock();
         CHECK_AND_RETURN_LOG(obs != nullptr, "obs is nullptr");
         MEDIA_LOGI("Receive message, type: %{public}d, code: %{public}d, detail: %{public}d",
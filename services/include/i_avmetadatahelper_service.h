@@ -45,6 +45,41 @@ public:
     int32_t size_;
 };
 
+/**
+ * The layout of the shared memory returned by FetchFramesAtTimes: the OutputFrameSlab header,
+ * one Entry for each requested time in the request order, and then the OutputFrames. Several
+ * entries may refer to the same frame if the same frame is fetched for them.
+ */
+struct OutputFrameSlab {
+public:
+    static constexpr int32_t MAX_FRAME_COUNT = 64;
+    static constexpr int64_t MAX_SLAB_SIZE = 128 * 1024 * 1024; // 128MB
+
+    struct Entry {
+        int64_t timeUs; // the requested time.
+        int64_t ptsUs; // the time of the fetched frame, -1 if failed.
+        int32_t offset; // the offset of the OutputFrame from the slab base, 0 if failed.
+        int32_t reserved;
+    };
+
+    explicit OutputFrameSlab(int32_t entryCount) : entryCount_(entryCount) {}
+
+    static int32_t GetHeaderSize(int32_t entryCount)
+    {
+        return static_cast<int32_t>(sizeof(OutputFrameSlab) + sizeof(Entry) * entryCount);
+    }
+
+    Entry *GetEntries()
+    {
+        return reinterpret_cast<Entry *>(reinterpret_cast<uint8_t *>(this) + sizeof(OutputFrameSlab));
+    }
+
+    int32_t entryCount_;
+    int32_t frameCount_ = 0; // the number of the distinct frames.
+    int32_t frameSize_ = 0; // the flattened size of each OutputFrame.
+    int32_t reserved_ = 0;
+};
+
 struct OutputConfiguration {
     int32_t dstWidth = -1;
     int32_t dstHeight = -1;
@@ -53,12 +88,20 @@ struct OutputConfiguration {
 
 class IAVMetadataHelperService {
 public:
+    static constexpr int32_t MAX_SCAN_SOURCE_COUNT = 512;
+
     virtual ~IAVMetadataHelperService() = default;
     virtual int32_t SetSource(const std::string &uri, int32_t usage) = 0;
+    virtual int32_t SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage) = 0;
     virtual std::string ResolveMetadata(int32_t key) = 0;
     virtual std::unordered_map<int32_t, std::string> ResolveMetadata() = 0;
     virtual std::shared_ptr<AVSharedMemory> FetchFrameAtTime(
         int64_t timeUs, int32_t option, OutputConfiguration param) = 0;
+    virtual std::shared_ptr<AVSharedMemory> FetchFramesAtTimes(
+        const std::vector<int64_t> &timesUs, int32_t option, OutputConfiguration param) = 0;
+    virtual int32_t ScanMetadata(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+        const std::shared_ptr<AVMetadataScanCallback> &callback) = 0;
+    virtual int32_t CancelScan() = 0;
     virtual void Release() = 0;
 };
 }
@@ -46,6 +46,41 @@ public:
      * @version 1.0
      */
     virtual int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc) = 0;
+    /**
+     * @brief Sets the playback source for the player by a sub-range of a file descriptor.
+     *
+     * @param fd Indicates the file descriptor of a regular file, not owned by the player.
+     * @param offset Indicates the start offset of the media in the file.
+     * @param size Indicates the size of the media, -1 means to the end of the file.
+     * @return Returns {@link MSERR_OK} if the fd is set successfully; returns an error code defined
+     * in {@link media_errors.h} otherwise.
+     * @since 1.0
+     * @version 1.0
+     */
+    virtual int32_t SetSource(int32_t fd, int64_t offset, int64_t size) = 0;
+    /**
+     * @brief Sets the source played right after the current one without a gap.
+     *
+     * @param uri Indicates the next playback source.
+     * @return Returns {@link MSERR_OK} if the next source is set successfully; returns an error code defined
+     * in {@link media_errors.h} otherwise.
+     * @since 1.0
+     * @version 1.0
+     */
+    virtual int32_t SetNextSource(const std::string &uri) = 0;
+    /**
+     * @brief Sets the source played right after the current one without a gap by a sub-range of a file
+     * descriptor.
+     *
+     * @param fd Indicates the file descriptor of a regular file, not owned by the player.
+     * @param offset Indicates the start offset of the media in the file.
+     * @param size Indicates the size of the media, -1 means to the end of the file.
+     * @return Returns {@link MSERR_OK} if the next source is set successfully; returns an error code defined
+     * in {@link media_errors.h} otherwise.
+     * @since 1.0
+     * @version 1.0
+     */
+    virtual int32_t SetNextSource(int32_t fd, int64_t offset, int64_t size) = 0;
     /**
      * @brief Start playback.
      *
@@ -241,6 +276,20 @@ public:
      */
     virtual int32_t SetLooping(bool loop) = 0;
 
+    /**
+     * @brief Sets the player to render the audio only, such as the player of an audio app.
+     *
+     * No video, subtitle and visualization chain is built, and the network buffering is smaller. This method
+     * must be called before {@link Prepare} or {@link PrepareAsync}, and it is kept by {@link Reset}.
+     *
+     * @param audioOnly whether the player renders the audio only.
+     * @return Returns {@link MSERR_OK} if the mode is set; returns an error code defined
+     * in {@link media_errors.h} otherwise.
+     * @since 1.0
+     * @version 1.0
+     */
+    virtual int32_t SetAudioOnly(bool audioOnly) = 0;
+
     /**
      * @brief Method to set player callback.
      *
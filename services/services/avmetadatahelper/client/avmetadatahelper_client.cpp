@@ -59,6 +59,14 @@ int32_t AVMetadataHelperClient::SetSource(const std::string &uri, int32_t usage)
     return avMetadataHelperProxy_->SetSource(uri, usage);
 }
 
+int32_t AVMetadataHelperClient::SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperProxy_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+    return avMetadataHelperProxy_->SetSource(fd, offset, size, usage);
+}
+
 std::string AVMetadataHelperClient::ResolveMetadata(int32_t key)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -81,6 +89,47 @@ std::shared_ptr<AVSharedMemory> AVMetadataHelperClient::FetchFrameAtTime(int64_t
     return avMetadataHelperProxy_->FetchFrameAtTime(timeUs, option, param);
 }
 
+std::shared_ptr<AVSharedMemory> AVMetadataHelperClient::FetchFramesAtTimes(const std::vector<int64_t> &timesUs,
+    int32_t option, OutputConfiguration param)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperProxy_ != nullptr, nullptr, "avmetadatahelper service does not exist.");
+    return avMetadataHelperProxy_->FetchFramesAtTimes(timesUs, option, param);
+}
+
+int32_t AVMetadataHelperClient::ScanMetadata(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+    const std::shared_ptr<AVMetadataScanCallback> &callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperProxy_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+    if (listenerStub_ == nullptr) {
+        listenerStub_ = new(std::nothrow) AVMetadataHelperListenerStub();
+        CHECK_AND_RETURN_RET_LOG(listenerStub_ != nullptr, MSERR_NO_MEMORY,
+            "failed to new AVMetadataHelperListenerStub object");
+    }
+    sptr<IRemoteObject> object = listenerStub_->AsObject();
+    CHECK_AND_RETURN_RET_LOG(object != nullptr, MSERR_NO_MEMORY, "listener object is nullptr..");
+
+    // the results may arrive before the request returns, set the callback first, and restore it if
+    // rejected, the previous scanning may be still running.
+    std::shared_ptr<AVMetadataScanCallback> lastCallback = listenerStub_->GetScanCallback();
+    listenerStub_->SetScanCallback(callback);
+    int32_t ret = avMetadataHelperProxy_->ScanMetadata(sources, priority, object);
+    if (ret != MSERR_OK) {
+        listenerStub_->SetScanCallback(lastCallback);
+    }
+    return ret;
+}
+
+int32_t AVMetadataHelperClient::CancelScan()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperProxy_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+    return avMetadataHelperProxy_->CancelScan();
+}
+
 void AVMetadataHelperClient::Release()
 {
     std::lock_guard<std::mutex> lock(mutex_);
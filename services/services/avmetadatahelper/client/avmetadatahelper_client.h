@@ -18,6 +18,7 @@
 
 #include "i_avmetadatahelper_service.h"
 #include "i_standard_avmetadatahelper_service.h"
+#include "avmetadatahelper_listener_stub.h"
 
 namespace OHOS {
 namespace Media {
@@ -30,16 +31,23 @@ public:
 
     // IAVMetadataHelperService override
     int32_t SetSource(const std::string &uri, int32_t usage) override;
+    int32_t SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage) override;
     std::string ResolveMetadata(int32_t key) override;
     std::unordered_map<int32_t, std::string> ResolveMetadata() override;
     std::shared_ptr<AVSharedMemory> FetchFrameAtTime(int64_t timeUs,
         int32_t option, OutputConfiguration param) override;
+    std::shared_ptr<AVSharedMemory> FetchFramesAtTimes(const std::vector<int64_t> &timesUs,
+        int32_t option, OutputConfiguration param) override;
+    int32_t ScanMetadata(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+        const std::shared_ptr<AVMetadataScanCallback> &callback) override;
+    int32_t CancelScan() override;
     void Release() override;
 
     // AVMetadataHelperClient
     void MediaServerDied();
 private:
     sptr<IStandardAVMetadataHelperService> avMetadataHelperProxy_ = nullptr;
+    sptr<AVMetadataHelperListenerStub> listenerStub_ = nullptr;
     std::mutex mutex_;
 };
 } // namespace Media
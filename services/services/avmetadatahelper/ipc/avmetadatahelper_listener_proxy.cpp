@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmetadatahelper_listener_proxy.h"
+#include "media_log.h"
+#include "media_errors.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataHelperListenerProxy"};
+}
+
+namespace OHOS {
+namespace Media {
+AVMetadataHelperListenerProxy::AVMetadataHelperListenerProxy(const sptr<IRemoteObject> &impl)
+    : IRemoteProxy<IStandardAVMetadataHelperListener>(impl)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVMetadataHelperListenerProxy::~AVMetadataHelperListenerProxy()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+void AVMetadataHelperListenerProxy::OnScanResult(int32_t index, int32_t errorCode,
+    const std::unordered_map<int32_t, std::string> &metadata)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_ASYNC);
+    std::vector<int32_t> keys;
+    std::vector<std::string> values;
+    for (auto &[key, value] : metadata) {
+        keys.push_back(key);
+        values.push_back(value);
+    }
+    (void)data.WriteInt32(index);
+    (void)data.WriteInt32(errorCode);
+    (void)data.WriteInt32Vector(keys);
+    (void)data.WriteStringVector(values);
+    int error = Remote()->SendRequest(AVMetadataHelperListenerMsg::ON_SCAN_RESULT, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("on scan result failed, error: %{public}d", error);
+    }
+}
+
+void AVMetadataHelperListenerProxy::OnScanFinished(int32_t scannedCount, bool canceled)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_ASYNC);
+    (void)data.WriteInt32(scannedCount);
+    (void)data.WriteBool(canceled);
+    int error = Remote()->SendRequest(AVMetadataHelperListenerMsg::ON_SCAN_FINISHED, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("on scan finished failed, error: %{public}d", error);
+    }
+}
+
+AVMetadataScanListenerCallback::AVMetadataScanListenerCallback(const sptr<IStandardAVMetadataHelperListener> &listener)
+    : listener_(listener)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVMetadataScanListenerCallback::~AVMetadataScanListenerCallback()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+void AVMetadataScanListenerCallback::OnScanResult(int32_t index, int32_t errorCode,
+    const std::unordered_map<int32_t, std::string> &metadata)
+{
+    if (listener_ != nullptr) {
+        listener_->OnScanResult(index, errorCode, metadata);
+    }
+}
+
+void AVMetadataScanListenerCallback::OnScanFinished(int32_t scannedCount, bool canceled)
+{
+    MEDIA_LOGI("scan finished, scanned: %{public}d, canceled: %{public}d", scannedCount, canceled);
+    if (listener_ != nullptr) {
+        listener_->OnScanFinished(scannedCount, canceled);
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETADATAHELPER_LISTENER_PROXY_H
+#define AVMETADATAHELPER_LISTENER_PROXY_H
+
+#include "i_standard_avmetadatahelper_listener.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+class AVMetadataScanListenerCallback : public AVMetadataScanCallback {
+public:
+    explicit AVMetadataScanListenerCallback(const sptr<IStandardAVMetadataHelperListener> &listener);
+    virtual ~AVMetadataScanListenerCallback();
+
+    DISALLOW_COPY_AND_MOVE(AVMetadataScanListenerCallback);
+    void OnScanResult(int32_t index, int32_t errorCode,
+        const std::unordered_map<int32_t, std::string> &metadata) override;
+    void OnScanFinished(int32_t scannedCount, bool canceled) override;
+
+private:
+    sptr<IStandardAVMetadataHelperListener> listener_ = nullptr;
+};
+
+class AVMetadataHelperListenerProxy : public IRemoteProxy<IStandardAVMetadataHelperListener> {
+public:
+    explicit AVMetadataHelperListenerProxy(const sptr<IRemoteObject> &impl);
+    virtual ~AVMetadataHelperListenerProxy();
+    DISALLOW_COPY_AND_MOVE(AVMetadataHelperListenerProxy);
+    void OnScanResult(int32_t index, int32_t errorCode,
+        const std::unordered_map<int32_t, std::string> &metadata) override;
+    void OnScanFinished(int32_t scannedCount, bool canceled) override;
+
+private:
+    static inline BrokerDelegator<AVMetadataHelperListenerProxy> delegator_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETADATAHELPER_LISTENER_PROXY_H
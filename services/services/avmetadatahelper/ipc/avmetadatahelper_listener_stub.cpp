@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmetadatahelper_listener_stub.h"
+#include "media_log.h"
+#include "media_errors.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataHelperListenerStub"};
+}
+
+namespace OHOS {
+namespace Media {
+AVMetadataHelperListenerStub::AVMetadataHelperListenerStub()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVMetadataHelperListenerStub::~AVMetadataHelperListenerStub()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+int AVMetadataHelperListenerStub::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply,
+    MessageOption &option)
+{
+    switch (code) {
+        case AVMetadataHelperListenerMsg::ON_SCAN_RESULT: {
+            int32_t index = data.ReadInt32();
+            int32_t errorCode = data.ReadInt32();
+            std::vector<int32_t> keys;
+            std::vector<std::string> values;
+            (void)data.ReadInt32Vector(&keys);
+            (void)data.ReadStringVector(&values);
+            std::unordered_map<int32_t, std::string> metadata;
+            for (size_t i = 0; i < keys.size() && i < values.size(); i++) {
+                metadata[keys[i]] = values[i];
+            }
+            OnScanResult(index, errorCode, metadata);
+            return MSERR_OK;
+        }
+        case AVMetadataHelperListenerMsg::ON_SCAN_FINISHED: {
+            int32_t scannedCount = data.ReadInt32();
+            bool canceled = data.ReadBool();
+            OnScanFinished(scannedCount, canceled);
+            return MSERR_OK;
+        }
+        default: {
+            MEDIA_LOGE("default case, need check AVMetadataHelperListenerStub");
+            return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
+        }
+    }
+}
+
+void AVMetadataHelperListenerStub::OnScanResult(int32_t index, int32_t errorCode,
+    const std::unordered_map<int32_t, std::string> &metadata)
+{
+    std::shared_ptr<AVMetadataScanCallback> cb = GetScanCallback();
+    if (cb != nullptr) {
+        cb->OnScanResult(index, errorCode, metadata);
+    }
+}
+
+void AVMetadataHelperListenerStub::OnScanFinished(int32_t scannedCount, bool canceled)
+{
+    std::shared_ptr<AVMetadataScanCallback> cb = GetScanCallback();
+    if (cb != nullptr) {
+        cb->OnScanFinished(scannedCount, canceled);
+    }
+}
+
+void AVMetadataHelperListenerStub::SetScanCallback(const std::shared_ptr<AVMetadataScanCallback> &callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    callback_ = callback;
+}
+
+std::shared_ptr<AVMetadataScanCallback> AVMetadataHelperListenerStub::GetScanCallback()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return callback_;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETADATAHELPER_LISTENER_STUB_H
+#define AVMETADATAHELPER_LISTENER_STUB_H
+
+#include <mutex>
+#include "i_standard_avmetadatahelper_listener.h"
+
+namespace OHOS {
+namespace Media {
+class AVMetadataHelperListenerStub : public IRemoteStub<IStandardAVMetadataHelperListener> {
+public:
+    AVMetadataHelperListenerStub();
+    virtual ~AVMetadataHelperListenerStub();
+    DISALLOW_COPY_AND_MOVE(AVMetadataHelperListenerStub);
+
+    // IStandardAVMetadataHelperListener override
+    int OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option) override;
+    void OnScanResult(int32_t index, int32_t errorCode,
+        const std::unordered_map<int32_t, std::string> &metadata) override;
+    void OnScanFinished(int32_t scannedCount, bool canceled) override;
+
+    // AVMetadataHelperListenerStub
+    void SetScanCallback(const std::shared_ptr<AVMetadataScanCallback> &callback);
+    std::shared_ptr<AVMetadataScanCallback> GetScanCallback();
+
+private:
+    std::shared_ptr<AVMetadataScanCallback> callback_;
+    std::mutex mutex_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETADATAHELPER_LISTENER_STUB_H
@@ -64,6 +64,24 @@ int32_t AVMetadataHelperServiceProxy::SetSource(const std::string &uri, int32_t
     return reply.ReadInt32();
 }
 
+int32_t AVMetadataHelperServiceProxy::SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    (void)data.WriteFileDescriptor(fd);
+    (void)data.WriteInt64(offset);
+    (void)data.WriteInt64(size);
+    (void)data.WriteInt32(usage);
+
+    int error = Remote()->SendRequest(SET_FD_SOURCE, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("Set fd source failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
 std::string AVMetadataHelperServiceProxy::ResolveMetadata(int32_t key)
 {
     MessageParcel data;
@@ -134,6 +152,68 @@ std::shared_ptr<AVSharedMemory> AVMetadataHelperServiceProxy::FetchFrameAtTime(i
     return ReadAVSharedMemoryFromParcel(reply);
 }
 
+std::shared_ptr<AVSharedMemory> AVMetadataHelperServiceProxy::FetchFramesAtTimes(const std::vector<int64_t> &timesUs,
+    int32_t option, OutputConfiguration param)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption opt;
+    (void)data.WriteInt64Vector(timesUs);
+    (void)data.WriteInt32(option);
+    (void)data.WriteInt32(param.dstWidth);
+    (void)data.WriteInt32(param.dstHeight);
+    (void)data.WriteInt32(param.colorFormat);
+
+    int error = Remote()->SendRequest(FETCH_FRAMES_AT_TIMES, data, reply, opt);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("FetchFramesAtTimes failed, error: %{public}d", error);
+        return nullptr;
+    }
+    return ReadAVSharedMemoryFromParcel(reply);
+}
+
+int32_t AVMetadataHelperServiceProxy::ScanMetadata(const std::vector<AVMetadataScanSource> &sources,
+    int32_t priority, const sptr<IRemoteObject> &listener)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    (void)data.WriteInt32(static_cast<int32_t>(sources.size()));
+    for (auto &source : sources) {
+        bool isFd = source.fd >= 0;
+        (void)data.WriteBool(isFd);
+        if (isFd) {
+            (void)data.WriteFileDescriptor(source.fd);
+            (void)data.WriteInt64(source.offset);
+            (void)data.WriteInt64(source.size);
+        } else {
+            (void)data.WriteString(source.uri);
+        }
+    }
+    (void)data.WriteInt32(priority);
+    (void)data.WriteRemoteObject(listener);
+
+    int error = Remote()->SendRequest(SCAN_METADATA, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("ScanMetadata failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
+int32_t AVMetadataHelperServiceProxy::CancelScan()
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    int error = Remote()->SendRequest(CANCEL_SCAN, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("CancelScan failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
 void AVMetadataHelperServiceProxy::Release()
 {
     MessageParcel data;
@@ -27,10 +27,16 @@ public:
     DISALLOW_COPY_AND_MOVE(AVMetadataHelperServiceProxy);
 
     int32_t SetSource(const std::string &uri, int32_t usage) override;
+    int32_t SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage) override;
     std::string ResolveMetadata(int32_t key) override;
     std::unordered_map<int32_t, std::string> ResolveMetadataMap() override;
     std::shared_ptr<AVSharedMemory> FetchFrameAtTime(int64_t timeUs,
         int32_t option, OutputConfiguration param) override;
+    std::shared_ptr<AVSharedMemory> FetchFramesAtTimes(const std::vector<int64_t> &timesUs,
+        int32_t option, OutputConfiguration param) override;
+    int32_t ScanMetadata(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+        const sptr<IRemoteObject> &listener) override;
+    int32_t CancelScan() override;
     void Release() override;
     int32_t DestroyStub() override;
 private:
@@ -14,10 +14,13 @@
  */
 
 #include "avmetadatahelper_service_stub.h"
+#include <unistd.h>
 #include "media_server_manager.h"
 #include "media_log.h"
+#include "media_trace.h"
 #include "media_errors.h"
 #include "avsharedmemory_ipc.h"
+#include "avmetadatahelper_listener_proxy.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataHelperServiceStub"};
@@ -57,6 +60,10 @@ int32_t AVMetadataHelperServiceStub::Init()
     avMetadataHelperFuncs_[FETCH_FRAME_AT_TIME] = &AVMetadataHelperServiceStub::FetchFrameAtTime;
     avMetadataHelperFuncs_[RELEASE] = &AVMetadataHelperServiceStub::Release;
     avMetadataHelperFuncs_[DESTROY] = &AVMetadataHelperServiceStub::DestroyStub;
+    avMetadataHelperFuncs_[SET_FD_SOURCE] = &AVMetadataHelperServiceStub::SetFdSource;
+    avMetadataHelperFuncs_[FETCH_FRAMES_AT_TIMES] = &AVMetadataHelperServiceStub::FetchFramesAtTimes;
+    avMetadataHelperFuncs_[SCAN_METADATA] = &AVMetadataHelperServiceStub::ScanMetadata;
+    avMetadataHelperFuncs_[CANCEL_SCAN] = &AVMetadataHelperServiceStub::CancelScan;
     return MSERR_OK;
 }
 
@@ -71,6 +78,7 @@ int AVMetadataHelperServiceStub::OnRemoteRequest(uint32_t code, MessageParcel &d
     MessageOption &option)
 {
     MEDIA_LOGI("Stub: OnRemoteRequest of code: %{public}u is received", code);
+    MediaTraceScope trace("AVMetadataHelperServiceStub::OnRemoteRequest", MEDIA_TRACE_IPC, code);
 
     auto itFunc = avMetadataHelperFuncs_.find(code);
     if (itFunc != avMetadataHelperFuncs_.end()) {
@@ -95,6 +103,13 @@ int32_t AVMetadataHelperServiceStub::SetSource(const std::string &uri, int32_t u
     return avMetadateHelperServer_->SetSource(uri, usage);
 }
 
+int32_t AVMetadataHelperServiceStub::SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage)
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadateHelperServer_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper server is nullptr");
+    return avMetadateHelperServer_->SetSource(fd, offset, size, usage);
+}
+
 std::string AVMetadataHelperServiceStub::ResolveMetadata(int32_t key)
 {
     CHECK_AND_RETURN_RET_LOG(avMetadateHelperServer_ != nullptr, "",
@@ -117,6 +132,37 @@ std::shared_ptr<AVSharedMemory> AVMetadataHelperServiceStub::FetchFrameAtTime(in
     return avMetadateHelperServer_->FetchFrameAtTime(timeUs, option, param);
 }
 
+std::shared_ptr<AVSharedMemory> AVMetadataHelperServiceStub::FetchFramesAtTimes(const std::vector<int64_t> &timesUs,
+    int32_t option, OutputConfiguration param)
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadateHelperServer_ != nullptr, nullptr,
+        "avmetadatahelper server is nullptr");
+    return avMetadateHelperServer_->FetchFramesAtTimes(timesUs, option, param);
+}
+
+int32_t AVMetadataHelperServiceStub::ScanMetadata(const std::vector<AVMetadataScanSource> &sources,
+    int32_t priority, const sptr<IRemoteObject> &listener)
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadateHelperServer_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper server is nullptr");
+    CHECK_AND_RETURN_RET_LOG(listener != nullptr, MSERR_INVALID_VAL, "scan listener object is nullptr");
+
+    sptr<IStandardAVMetadataHelperListener> scanListener = iface_cast<IStandardAVMetadataHelperListener>(listener);
+    CHECK_AND_RETURN_RET_LOG(scanListener != nullptr, MSERR_NO_MEMORY,
+        "failed to convert IStandardAVMetadataHelperListener");
+
+    std::shared_ptr<AVMetadataScanCallback> callback = std::make_shared<AVMetadataScanListenerCallback>(scanListener);
+    CHECK_AND_RETURN_RET_LOG(callback != nullptr, MSERR_NO_MEMORY, "failed to new AVMetadataScanListenerCallback");
+    return avMetadateHelperServer_->ScanMetadata(sources, priority, callback);
+}
+
+int32_t AVMetadataHelperServiceStub::CancelScan()
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadateHelperServer_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper server is nullptr");
+    return avMetadateHelperServer_->CancelScan();
+}
+
 void AVMetadataHelperServiceStub::Release()
 {
     CHECK_AND_RETURN_LOG(avMetadateHelperServer_ != nullptr, "avmetadatahelper server is nullptr");
@@ -131,6 +177,19 @@ int32_t AVMetadataHelperServiceStub::SetSource(MessageParcel &data, MessageParce
     return MSERR_OK;
 }
 
+int32_t AVMetadataHelperServiceStub::SetFdSource(MessageParcel &data, MessageParcel &reply)
+{
+    int32_t fd = data.ReadFileDescriptor();
+    int64_t offset = data.ReadInt64();
+    int64_t size = data.ReadInt64();
+    int32_t usage = data.ReadInt32();
+    reply.WriteInt32(SetSource(fd, offset, size, usage));
+    if (fd >= 0) {
+        (void)::close(fd);
+    }
+    return MSERR_OK;
+}
+
 int32_t AVMetadataHelperServiceStub::ResolveMetadata(MessageParcel &data, MessageParcel &reply)
 {
     int32_t key = data.ReadInt32();
@@ -165,6 +224,55 @@ int32_t AVMetadataHelperServiceStub::FetchFrameAtTime(MessageParcel &data, Messa
     return WriteAVSharedMemoryToParcel(ashMem, reply);
 }
 
+int32_t AVMetadataHelperServiceStub::FetchFramesAtTimes(MessageParcel &data, MessageParcel &reply)
+{
+    std::vector<int64_t> timesUs;
+    CHECK_AND_RETURN_RET_LOG(data.ReadInt64Vector(&timesUs), MSERR_INVALID_VAL, "read timestamps failed");
+    int32_t option = data.ReadInt32();
+    OutputConfiguration param = {data.ReadInt32(), data.ReadInt32(), data.ReadInt32()};
+    std::shared_ptr<AVSharedMemory> ashMem = FetchFramesAtTimes(timesUs, option, param);
+
+    return WriteAVSharedMemoryToParcel(ashMem, reply);
+}
+
+int32_t AVMetadataHelperServiceStub::ScanMetadata(MessageParcel &data, MessageParcel &reply)
+{
+    int32_t count = data.ReadInt32();
+    if (count <= 0 || count > IAVMetadataHelperService::MAX_SCAN_SOURCE_COUNT) {
+        MEDIA_LOGE("invalid scan source count: %{public}d", count);
+        reply.WriteInt32(MSERR_INVALID_VAL);
+        return MSERR_INVALID_VAL;
+    }
+
+    std::vector<AVMetadataScanSource> sources(static_cast<size_t>(count));
+    for (auto &source : sources) {
+        if (data.ReadBool()) {
+            // the fd read from the parcel is a new one owned by this process, the server dups it again.
+            source.fd = data.ReadFileDescriptor();
+            source.offset = data.ReadInt64();
+            source.size = data.ReadInt64();
+        } else {
+            source.uri = data.ReadString();
+        }
+    }
+    int32_t priority = data.ReadInt32();
+    sptr<IRemoteObject> listener = data.ReadRemoteObject();
+
+    reply.WriteInt32(ScanMetadata(sources, priority, listener));
+    for (auto &source : sources) {
+        if (source.fd >= 0) {
+            (void)::close(source.fd);
+        }
+    }
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperServiceStub::CancelScan(MessageParcel &data, MessageParcel &reply)
+{
+    reply.WriteInt32(CancelScan());
+    return MSERR_OK;
+}
+
 int32_t AVMetadataHelperServiceStub::Release(MessageParcel &data, MessageParcel &reply)
 {
     Release();
@@ -44,10 +44,16 @@ class IStandardAVMetadataHelperService : public IRemoteBroker {
 public:
     virtual ~IStandardAVMetadataHelperService() = default;
     virtual int32_t SetSource(const std::string &uri, int32_t usage) = 0;
+    virtual int32_t SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage) = 0;
     virtual std::string ResolveMetadata(int32_t key) = 0;
     virtual std::unordered_map<int32_t, std::string> ResolveMetadataMap() = 0;
     virtual std::shared_ptr<AVSharedMemory> FetchFrameAtTime(
         int64_t timeUs, int32_t option, OutputConfiguration param) = 0;
+    virtual std::shared_ptr<AVSharedMemory> FetchFramesAtTimes(
+        const std::vector<int64_t> &timesUs, int32_t option, OutputConfiguration param) = 0;
+    virtual int32_t ScanMetadata(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+        const sptr<IRemoteObject> &listener) = 0;
+    virtual int32_t CancelScan() = 0;
     virtual void Release() = 0;
     virtual int32_t DestroyStub() = 0;
 
@@ -61,6 +67,10 @@ public:
         FETCH_FRAME_AT_TIME,
         RELEASE,
         DESTROY,
+        SET_FD_SOURCE,
+        FETCH_FRAMES_AT_TIMES,
+        SCAN_METADATA,
+        CANCEL_SCAN,
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"IStandardAVMetadataHelperService");
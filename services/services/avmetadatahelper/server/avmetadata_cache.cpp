@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmetadata_cache.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <securec.h>
+#include "media_errors.h"
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataCache"};
+    constexpr const char *CACHE_DIR = "/data/media/avmetadata";
+    constexpr const char *CACHE_PATH = "/data/media/avmetadata/metadata.cache";
+    constexpr const char *CACHE_TMP_PATH = "/data/media/avmetadata/metadata.cache.tmp";
+    constexpr uint32_t FILE_MAGIC = 0x434D5641; // "AVMC"
+    constexpr uint32_t FILE_VERSION = 1;
+    constexpr uint32_t RECORD_MAGIC = 0x4D544552; // "RETM"
+    constexpr size_t MAX_LIVE_BYTES = 4 * 1024 * 1024; // 4MB
+    constexpr size_t MAX_RECORD_SIZE = 64 * 1024; // 64KB
+    constexpr size_t MIN_COMPACT_DEAD_BYTES = 256 * 1024; // 256KB
+    constexpr size_t RECORD_ALIGN = 8;
+    constexpr uint32_t FNV32_OFFSET = 2166136261U;
+    constexpr uint32_t FNV32_PRIME = 16777619U;
+    constexpr double PERCENT = 100.0;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+    };
+
+    struct RecordHeader {
+        uint32_t magic;
+        uint32_t payloadSize; // the items, padded to RECORD_ALIGN.
+        uint32_t checksum; // the fnv1a of the key and the payload.
+        uint32_t itemCount;
+        OHOS::Media::AVMetadataCacheKey key;
+    };
+
+    // each item of the payload is the metadata key, the value length and the value bytes.
+    struct ItemHeader {
+        int32_t key;
+        uint32_t length;
+    };
+
+    static_assert(sizeof(OHOS::Media::AVMetadataCacheKey) == 56, "the key is written as is, no padding");
+    static_assert(sizeof(RecordHeader) % RECORD_ALIGN == 0, "the record header must be aligned");
+
+    uint32_t Fnv1a32(const uint8_t *data, size_t size, uint32_t hash = FNV32_OFFSET)
+    {
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ data[i]) * FNV32_PRIME;
+        }
+        return hash;
+    }
+
+    uint32_t RecordChecksum(const OHOS::Media::AVMetadataCacheKey &key, const uint8_t *payload, size_t size)
+    {
+        uint32_t hash = Fnv1a32(reinterpret_cast<const uint8_t *>(&key), sizeof(key));
+        return Fnv1a32(payload, size, hash);
+    }
+
+    bool WriteAll(int32_t fd, const uint8_t *data, size_t size, off_t offset)
+    {
+        while (size > 0) {
+            ssize_t ret = pwrite(fd, data, size, offset);
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+            CHECK_AND_RETURN_RET_LOG(ret > 0, false, "write failed, errno: %{public}d", errno);
+            data += ret;
+            size -= static_cast<size_t>(ret);
+            offset += ret;
+        }
+        return true;
+    }
+}
+
+namespace OHOS {
+namespace Media {
+AVMetadataCache &AVMetadataCache::GetInstance()
+{
+    static AVMetadataCache instance;
+    return instance;
+}
+
+AVMetadataCache::~AVMetadataCache()
+{
+    CloseLocked();
+}
+
+bool AVMetadataCache::Get(const AVMetadataCacheKey &key, std::unordered_map<int32_t, std::string> &meta)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!loaded_) {
+        LoadLocked();
+    }
+
+    auto it = index_.find(key);
+    if (it == index_.end() || !DecodeLocked(*it->second, meta)) {
+        stats_.missCount++;
+        return false;
+    }
+
+    lruList_.splice(lruList_.begin(), lruList_, it->second);
+    stats_.hitCount++;
+    return true;
+}
+
+void AVMetadataCache::Put(const AVMetadataCacheKey &key, const std::unordered_map<int32_t, std::string> &meta)
+{
+    std::vector<uint8_t> record(sizeof(RecordHeader));
+    for (auto &[metaKey, value] : meta) {
+        ItemHeader item = { metaKey, static_cast<uint32_t>(value.size()) };
+        const uint8_t *itemData = reinterpret_cast<const uint8_t *>(&item);
+        record.insert(record.end(), itemData, itemData + sizeof(item));
+        record.insert(record.end(), value.begin(), value.end());
+    }
+    record.resize((record.size() + RECORD_ALIGN - 1) / RECORD_ALIGN * RECORD_ALIGN, 0);
+    CHECK_AND_RETURN_LOG(record.size() <= MAX_RECORD_SIZE, "metadata too large: %{public}zu", record.size());
+
+    RecordHeader header = { RECORD_MAGIC, static_cast<uint32_t>(record.size() - sizeof(RecordHeader)), 0,
+        static_cast<uint32_t>(meta.size()), key };
+    header.checksum = RecordChecksum(key, record.data() + sizeof(RecordHeader), header.payloadSize);
+    (void)memcpy_s(record.data(), sizeof(RecordHeader), &header, sizeof(RecordHeader));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!loaded_) {
+        LoadLocked();
+    }
+    CHECK_AND_RETURN(fd_ >= 0);
+
+    size_t offset = fileSize_;
+    if (!WriteAll(fd_, record.data(), record.size(), static_cast<off_t>(offset))) {
+        (void)ftruncate(fd_, static_cast<off_t>(offset));
+        return;
+    }
+    if (!MapLocked(offset + record.size())) {
+        CloseLocked();
+        return;
+    }
+
+    InsertLocked(key, offset, record.size());
+    stats_.putCount++;
+    EvictLocked();
+
+    size_t deadBytes = fileSize_ - sizeof(FileHeader) - liveBytes_;
+    if (deadBytes > std::max(liveBytes_, MIN_COMPACT_DEAD_BYTES)) {
+        CompactLocked();
+    }
+}
+
+void AVMetadataCache::LoadLocked()
+{
+    loaded_ = true;
+    if (mkdir(CACHE_DIR, S_IRWXU) != 0 && errno != EEXIST) {
+        MEDIA_LOGW("create cache dir failed, errno: %{public}d", errno);
+        return;
+    }
+    fd_ = ::open(CACHE_PATH, O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    CHECK_AND_RETURN_LOG(fd_ >= 0, "open cache file failed, errno: %{public}d", errno);
+
+    struct stat st = {};
+    size_t size = (fstat(fd_, &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+    FileHeader header = {};
+    if (size < sizeof(FileHeader) || pread(fd_, &header, sizeof(header), 0) != sizeof(header) ||
+        header.magic != FILE_MAGIC || header.version != FILE_VERSION) {
+        header = { FILE_MAGIC, FILE_VERSION };
+        if (ftruncate(fd_, 0) != 0 || !WriteAll(fd_, reinterpret_cast<const uint8_t *>(&header), sizeof(header), 0)) {
+            CloseLocked();
+            return;
+        }
+        size = sizeof(header);
+    }
+    if (!MapLocked(size)) {
+        CloseLocked();
+        return;
+    }
+
+    size_t pos = sizeof(FileHeader);
+    while (pos + sizeof(RecordHeader) <= size) {
+        RecordHeader record = {};
+        (void)memcpy_s(&record, sizeof(record), mapping_ + pos, sizeof(record));
+        size_t payloadSize = record.payloadSize;
+        if (record.magic != RECORD_MAGIC || payloadSize > size - pos - sizeof(RecordHeader) ||
+            record.checksum != RecordChecksum(record.key, mapping_ + pos + sizeof(RecordHeader), payloadSize)) {
+            break;
+        }
+        InsertLocked(record.key, pos, sizeof(RecordHeader) + payloadSize);
+        pos += sizeof(RecordHeader) + payloadSize;
+    }
+
+    if (pos < size) {
+        // the tail written partially at the last exiting.
+        MEDIA_LOGW("drop the broken tail of the cache file at %{public}zu", pos);
+        (void)ftruncate(fd_, static_cast<off_t>(pos));
+        (void)MapLocked(pos);
+    }
+    EvictLocked();
+    MEDIA_LOGI("cache loaded, entries: %{public}zu, file bytes: %{public}zu", index_.size(), fileSize_);
+}
+
+bool AVMetadataCache::MapLocked(size_t size)
+{
+    UnmapLocked();
+    void *addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+    CHECK_AND_RETURN_RET_LOG(addr != MAP_FAILED, false, "map cache file failed, errno: %{public}d", errno);
+    mapping_ = static_cast<const uint8_t *>(addr);
+    fileSize_ = size;
+    return true;
+}
+
+void AVMetadataCache::UnmapLocked()
+{
+    if (mapping_ != nullptr) {
+        (void)::munmap(const_cast<uint8_t *>(mapping_), fileSize_);
+        mapping_ = nullptr;
+    }
+}
+
+// the cache is disabled until the service restarting.
+void AVMetadataCache::CloseLocked()
+{
+    UnmapLocked();
+    if (fd_ >= 0) {
+        (void)::close(fd_);
+        fd_ = -1;
+    }
+    lruList_.clear();
+    index_.clear();
+    liveBytes_ = 0;
+    fileSize_ = 0;
+}
+
+void AVMetadataCache::InsertLocked(const AVMetadataCacheKey &key, size_t offset, size_t size)
+{
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        liveBytes_ -= it->second->size;
+        lruList_.erase(it->second);
+    }
+    lruList_.push_front({ key, offset, size });
+    index_[key] = lruList_.begin();
+    liveBytes_ += size;
+}
+
+void AVMetadataCache::EvictLocked()
+{
+    while (liveBytes_ > MAX_LIVE_BYTES && !lruList_.empty()) {
+        Entry &entry = lruList_.back();
+        liveBytes_ -= entry.size;
+        (void)index_.erase(entry.key);
+        lruList_.pop_back();
+        stats_.evictCount++;
+    }
+}
+
+void AVMetadataCache::CompactLocked()
+{
+    int32_t tmpFd = ::open(CACHE_TMP_PATH, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    CHECK_AND_RETURN_LOG(tmpFd >= 0, "open tmp cache file failed, errno: %{public}d", errno);
+
+    // the oldest first, so that the LRU order is kept at next loading.
+    FileHeader header = { FILE_MAGIC, FILE_VERSION };
+    bool ret = WriteAll(tmpFd, reinterpret_cast<const uint8_t *>(&header), sizeof(header), 0);
+    std::vector<size_t> offsets;
+    size_t pos = sizeof(header);
+    for (auto it = lruList_.rbegin(); ret && it != lruList_.rend(); ++it) {
+        ret = WriteAll(tmpFd, mapping_ + it->offset, it->size, static_cast<off_t>(pos));
+        offsets.push_back(pos);
+        pos += it->size;
+    }
+    if (!ret || fsync(tmpFd) != 0 || rename(CACHE_TMP_PATH, CACHE_PATH) != 0) {
+        MEDIA_LOGE("compact cache file failed, errno: %{public}d", errno);
+        (void)::close(tmpFd);
+        (void)unlink(CACHE_TMP_PATH);
+        return;
+    }
+
+    UnmapLocked();
+    (void)::close(fd_);
+    fd_ = tmpFd;
+    size_t index = 0;
+    for (auto it = lruList_.rbegin(); it != lruList_.rend(); ++it) {
+        it->offset = offsets[index++];
+    }
+    if (!MapLocked(pos)) {
+        CloseLocked();
+        return;
+    }
+    stats_.compactCount++;
+    MEDIA_LOGI("cache compacted, entries: %{public}zu, file bytes: %{public}zu", index_.size(), fileSize_);
+}
+
+bool AVMetadataCache::DecodeLocked(const Entry &entry, std::unordered_map<int32_t, std::string> &meta) const
+{
+    RecordHeader record = {};
+    (void)memcpy_s(&record, sizeof(record), mapping_ + entry.offset, sizeof(record));
+    const uint8_t *pos = mapping_ + entry.offset + sizeof(RecordHeader);
+    const uint8_t *end = pos + record.payloadSize;
+
+    meta.clear();
+    for (uint32_t i = 0; i < record.itemCount; i++) {
+        ItemHeader item = {};
+        CHECK_AND_RETURN_RET(static_cast<size_t>(end - pos) >= sizeof(item), false);
+        (void)memcpy_s(&item, sizeof(item), pos, sizeof(item));
+        pos += sizeof(item);
+        CHECK_AND_RETURN_RET(static_cast<size_t>(end - pos) >= item.length, false);
+        meta[item.key] = std::string(reinterpret_cast<const char *>(pos), item.length);
+        pos += item.length;
+    }
+    return true;
+}
+
+AVMetadataCache::Stats AVMetadataCache::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.entryCount = index_.size();
+    stats.liveBytes = liveBytes_;
+    stats.fileBytes = fileSize_;
+    return stats;
+}
+
+void AVMetadataCache::DumpStats(std::string &dumpString)
+{
+    Stats stats = GetStats();
+    uint64_t lookupCount = stats.hitCount + stats.missCount;
+    double hitRate = (lookupCount == 0) ? 0.0 : (PERCENT * stats.hitCount / lookupCount);
+    char buf[256] = {0}; // 256 is enough for one line.
+    (void)sprintf_s(buf, sizeof(buf), "AVMetadataCache statistics: entries %zu, live bytes %zu, file bytes %zu\n"
+        "  hit %" PRIu64 ", miss %" PRIu64 ", hit rate %.1f%%, put %" PRIu64 ", evict %" PRIu64 ", compact %" PRIu64
+        "\n", stats.entryCount, stats.liveBytes, stats.fileBytes, stats.hitCount, stats.missCount, hitRate,
+        stats.putCount, stats.evictCount, stats.compactCount);
+    dumpString += buf;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETADATA_CACHE_H
+#define AVMETADATA_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "avmetadata_cache_key.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The metadata resolved before are kept in a file, so that the unchanged files are not prerolled
+ * again after the service restarting.
+ *
+ * The cache file is an append log of records, each one is a key and the serialized metadata, and
+ * it is mapped read only, the hit is decoded from the mapping directly. The index and the LRU order
+ * are in the memory, rebuilt from the records at loading, the later record wins. The entries beyond
+ * the size limit are evicted from the index, and the file is compacted when the dead records are
+ * more than the live ones.
+ */
+class AVMetadataCache {
+public:
+    struct Stats {
+        uint64_t hitCount = 0;
+        uint64_t missCount = 0;
+        uint64_t putCount = 0;
+        uint64_t evictCount = 0;
+        uint64_t compactCount = 0;
+        size_t entryCount = 0;
+        size_t liveBytes = 0;
+        size_t fileBytes = 0;
+    };
+
+    static AVMetadataCache &GetInstance();
+
+    bool Get(const AVMetadataCacheKey &key, std::unordered_map<int32_t, std::string> &meta);
+    void Put(const AVMetadataCacheKey &key, const std::unordered_map<int32_t, std::string> &meta);
+    Stats GetStats();
+    void DumpStats(std::string &dumpString);
+
+    DISALLOW_COPY_AND_MOVE(AVMetadataCache);
+
+private:
+    AVMetadataCache() = default;
+    ~AVMetadataCache();
+
+    struct Entry {
+        AVMetadataCacheKey key;
+        size_t offset; // the offset of the record in the file.
+        size_t size;
+    };
+
+    void LoadLocked();
+    bool MapLocked(size_t size);
+    void UnmapLocked();
+    void CloseLocked();
+    void InsertLocked(const AVMetadataCacheKey &key, size_t offset, size_t size);
+    void EvictLocked();
+    void CompactLocked();
+    bool DecodeLocked(const Entry &entry, std::unordered_map<int32_t, std::string> &meta) const;
+
+    std::mutex mutex_;
+    bool loaded_ = false;
+    int32_t fd_ = -1;
+    const uint8_t *mapping_ = nullptr;
+    size_t fileSize_ = 0;
+    size_t liveBytes_ = 0;
+    std::list<Entry> lruList_; // the most recently used at the front.
+    std::unordered_map<AVMetadataCacheKey, std::list<Entry>::iterator, AVMetadataCacheKey::Hash> index_;
+    Stats stats_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETADATA_CACHE_H
@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmetadata_scan_scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <unistd.h>
+#include <securec.h>
+#include "media_errors.h"
+#include "media_log.h"
+#include "engine_factory_repo.h"
+#include "avmetadata_cache.h"
+#include "avmetadatahelper_engine_pool.h"
+#include "uri_helper.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataScanScheduler"};
+    constexpr size_t MIN_WORKER_NUM = 2;
+    // bounded by the idle engines of the pool and the bandwidth of the storage, more workers
+    // just make the engines to be recreated and the reads to be more random.
+    constexpr size_t MAX_WORKER_NUM = 4;
+    constexpr double US_PER_MS = 1000.0;
+    // one full scan of a client, each client may run scans on several avmetadatahelpers.
+    constexpr size_t MAX_CLIENT_FD_NUM = 512;
+    // far below the fd limit of the media service, the players and recorders also need fds.
+    constexpr size_t MAX_OPEN_FD_NUM = 1024;
+
+    int64_t GetCurTimeUs()
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+    }
+}
+
+namespace OHOS {
+namespace Media {
+AVMetadataScanScheduler &AVMetadataScanScheduler::GetInstance()
+{
+    // never destroyed, the workers may be still running during the static destruction.
+    static auto *instance = new AVMetadataScanScheduler();
+    return *instance;
+}
+
+AVMetadataScanScheduler::AVMetadataScanScheduler()
+{
+    size_t cores = static_cast<size_t>(std::thread::hardware_concurrency());
+    maxWorkers_ = std::min(std::max(cores, MIN_WORKER_NUM), MAX_WORKER_NUM);
+    MEDIA_LOGI("scan scheduler created, max workers: %{public}zu", maxWorkers_);
+}
+
+int32_t AVMetadataScanScheduler::Submit(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+    const std::shared_ptr<AVMetadataScanCallback> &callback, pid_t pid, uint64_t &scanId)
+{
+    CHECK_AND_RETURN_RET_LOG(!sources.empty() && callback != nullptr, MSERR_INVALID_VAL, "invalid scan");
+    CHECK_AND_RETURN_RET_LOG(priority >= AV_META_SCAN_PRIORITY_BACKGROUND &&
+        priority <= AV_META_SCAN_PRIORITY_FOREGROUND, MSERR_INVALID_VAL,
+        "invalid scan priority: %{public}d", priority);
+
+    size_t fdNum = static_cast<size_t>(std::count_if(sources.begin(), sources.end(),
+        [](const AVMetadataScanSource &source) { return source.fd >= 0; }));
+    auto task = std::make_shared<ScanTask>();
+    task->priority = priority;
+    task->pid = pid;
+    task->callback = callback;
+    task->sources = sources;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t &clientFdNum = clientFdNum_[pid];
+    if (clientFdNum + fdNum > MAX_CLIENT_FD_NUM || openFdNum_ + fdNum > MAX_OPEN_FD_NUM) {
+        MEDIA_LOGE("too many fds to scan, client %{public}d: %{public}zu, total: %{public}zu, new: %{public}zu",
+            pid, clientFdNum, openFdNum_, fdNum);
+        if (clientFdNum == 0) {
+            (void)clientFdNum_.erase(pid);
+        }
+        return MSERR_NO_MEMORY;
+    }
+    for (auto &source : task->sources) {
+        if (source.fd < 0) {
+            continue;
+        }
+        // the source fails alone if its fd can not be dupped.
+        source.fd = dup(source.fd);
+        if (source.fd >= 0) {
+            clientFdNum++;
+            openFdNum_++;
+        }
+    }
+    if (clientFdNum == 0) {
+        (void)clientFdNum_.erase(pid);
+    }
+
+    task->id = ++nextScanId_;
+    runningTasks_[task->id] = task;
+    pendingTasks_[priority].push_back(task);
+    stats_.scanCount++;
+    SpawnWorkersLocked(task->sources.size());
+    cond_.notify_all();
+
+    MEDIA_LOGI("scan %{public}" PRIu64 " submitted, sources: %{public}zu, priority: %{public}d",
+        task->id, task->sources.size(), priority);
+    scanId = task->id;
+    return MSERR_OK;
+}
+
+void AVMetadataScanScheduler::Cancel(uint64_t scanId)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = runningTasks_.find(scanId);
+    if (it == runningTasks_.end()) {
+        return;
+    }
+
+    std::shared_ptr<ScanTask> task = it->second;
+    if (task->canceled) {
+        return;
+    }
+    task->canceled = true;
+    stats_.cancelCount++;
+    auto &pending = pendingTasks_[task->priority];
+    (void)pending.erase(std::remove(pending.begin(), pending.end(), task), pending.end());
+    for (size_t index = task->nextIndex; index < task->sources.size(); index++) {
+        CloseSourceFdLocked(*task, index);
+    }
+    MEDIA_LOGI("scan %{public}" PRIu64 " canceled, dropped: %{public}zu", scanId,
+        task->sources.size() - task->nextIndex);
+    task->nextIndex = task->sources.size();
+    FinishIfDoneLocked(lock, task);
+}
+
+bool AVMetadataScanScheduler::IsRunning(uint64_t scanId)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return runningTasks_.count(scanId) != 0;
+}
+
+void AVMetadataScanScheduler::SpawnWorkersLocked(size_t sourceNum)
+{
+    size_t spawnNum = 0;
+    while (workers_.size() < maxWorkers_ && idleWorkers_ + spawnNum < sourceNum) {
+        workers_.emplace_back(&AVMetadataScanScheduler::WorkerLoop, this);
+        spawnNum++;
+    }
+    if (spawnNum != 0) {
+        MEDIA_LOGI("scan scheduler grows to %{public}zu workers", workers_.size());
+    }
+}
+
+std::shared_ptr<AVMetadataScanScheduler::ScanTask> AVMetadataScanScheduler::TakeSourceLocked(size_t &index)
+{
+    for (int32_t priority = AV_META_SCAN_PRIORITY_FOREGROUND; priority >= AV_META_SCAN_PRIORITY_BACKGROUND;
+        priority--) {
+        auto &pending = pendingTasks_[priority];
+        if (pending.empty()) {
+            continue;
+        }
+
+        std::shared_ptr<ScanTask> task = pending.front();
+        pending.pop_front();
+        index = task->nextIndex++;
+        if (task->nextIndex < task->sources.size()) {
+            // round robin among the scans of the same priority.
+            pending.push_back(task);
+        }
+        return task;
+    }
+    return nullptr;
+}
+
+void AVMetadataScanScheduler::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        size_t index = 0;
+        std::shared_ptr<ScanTask> task = TakeSourceLocked(index);
+        if (task == nullptr) {
+            idleWorkers_++;
+            cond_.wait(lock);
+            idleWorkers_--;
+            continue;
+        }
+        ScanOneSource(lock, task, index);
+    }
+}
+
+void AVMetadataScanScheduler::ScanOneSource(std::unique_lock<std::mutex> &lock,
+    const std::shared_ptr<ScanTask> &task, size_t index)
+{
+    AVMetadataScanSource source = task->sources[index];
+    task->runningCount++;
+    lock.unlock();
+
+    std::unordered_map<int32_t, std::string> metadata;
+    bool cacheHit = false;
+    int64_t startUs = GetCurTimeUs();
+    int32_t ret = ScanSource(source, metadata, cacheHit);
+    int64_t costUs = GetCurTimeUs() - startUs;
+
+    lock.lock();
+    CloseSourceFdLocked(*task, index);
+    bool canceled = task->canceled;
+    stats_.sourceCount++;
+    stats_.failedCount += (ret != MSERR_OK) ? 1 : 0;
+    stats_.cacheHitCount += cacheHit ? 1 : 0;
+    stats_.totalCostUs += static_cast<uint64_t>(costUs);
+    lock.unlock();
+
+    if (!canceled) {
+        task->callback->OnScanResult(static_cast<int32_t>(index), ret, metadata);
+    }
+
+    lock.lock();
+    // counted after the result is reported, so that the finished is reported after all results.
+    task->runningCount--;
+    task->scannedCount += canceled ? 0 : 1;
+    FinishIfDoneLocked(lock, task);
+}
+
+int32_t AVMetadataScanScheduler::ScanSource(const AVMetadataScanSource &source,
+    std::unordered_map<int32_t, std::string> &metadata, bool &cacheHit)
+{
+    std::string uri;
+    if (source.fd >= 0) {
+        uri = UriHelper::MakeFdUri(source.fd, source.offset, source.size);
+    } else {
+        // the fd in the uri is not valid in this process.
+        CHECK_AND_RETURN_RET_LOG(!source.uri.empty() && !UriHelper(source.uri).IsFdScheme(), MSERR_INVALID_VAL,
+            "invalid scan source");
+        uri = source.uri;
+    }
+
+    AVMetadataCacheKey cacheKey;
+    bool cacheable = AVMetadataCacheKey::Make(uri, cacheKey);
+    if (cacheable && AVMetadataCache::GetInstance().Get(cacheKey, metadata)) {
+        cacheHit = true;
+        return MSERR_OK;
+    }
+
+    auto engineFactory = EngineFactoryRepo::Instance().GetEngineFactory(IEngineFactory::Scene::SCENE_AVMETADATA, uri);
+    CHECK_AND_RETURN_RET_LOG(engineFactory != nullptr, MSERR_CREATE_AVMETADATAHELPER_ENGINE_FAILED,
+        "Failed to get engine factory");
+    std::shared_ptr<IAVMetadataHelperEngine> engine =
+        AVMetadataHelperEnginePool::GetInstance().Acquire(engineFactory.get());
+    if (engine == nullptr) {
+        engine = engineFactory->CreateAVMetadataHelperEngine();
+        CHECK_AND_RETURN_RET_LOG(engine != nullptr, MSERR_CREATE_AVMETADATAHELPER_ENGINE_FAILED,
+            "Failed to create avmetadatahelper engine");
+    }
+
+    int32_t ret = engine->SetSource(uri, AV_META_USAGE_META_ONLY);
+    if (ret == MSERR_OK) {
+        metadata = engine->ResolveMetadata();
+        ret = metadata.empty() ? MSERR_UNKNOWN : MSERR_OK;
+    }
+    // the engine stops reading the source before the fd is closed.
+    engine->Reset();
+    AVMetadataHelperEnginePool::GetInstance().Release(engineFactory.get(), std::move(engine));
+
+    if (ret == MSERR_OK && cacheable) {
+        AVMetadataCache::GetInstance().Put(cacheKey, metadata);
+    }
+    return ret;
+}
+
+void AVMetadataScanScheduler::FinishIfDoneLocked(std::unique_lock<std::mutex> &lock,
+    const std::shared_ptr<ScanTask> &task)
+{
+    if (task->nextIndex < task->sources.size() || task->runningCount != 0 ||
+        runningTasks_.erase(task->id) == 0) {
+        return;
+    }
+
+    int32_t scannedCount = task->scannedCount;
+    bool canceled = task->canceled;
+    lock.unlock();
+    MEDIA_LOGI("scan %{public}" PRIu64 " finished, scanned: %{public}d", task->id, scannedCount);
+    task->callback->OnScanFinished(scannedCount, canceled);
+    lock.lock();
+}
+
+void AVMetadataScanScheduler::CloseSourceFdLocked(ScanTask &task, size_t index)
+{
+    AVMetadataScanSource &source = task.sources[index];
+    if (source.fd < 0) {
+        return;
+    }
+    (void)::close(source.fd);
+    source.fd = -1;
+    openFdNum_--;
+    auto it = clientFdNum_.find(task.pid);
+    if (it != clientFdNum_.end() && --it->second == 0) {
+        (void)clientFdNum_.erase(it);
+    }
+}
+
+AVMetadataScanScheduler::Stats AVMetadataScanScheduler::GetStats()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.workerCount = workers_.size();
+    stats.runningScanCount = runningTasks_.size();
+    return stats;
+}
+
+void AVMetadataScanScheduler::DumpStats(std::string &dumpString)
+{
+    Stats stats = GetStats();
+    double avgCostMs = (stats.sourceCount == 0) ? 0.0 : (stats.totalCostUs / US_PER_MS / stats.sourceCount);
+    char buf[256] = {0}; // 256 is enough for one line.
+    (void)sprintf_s(buf, sizeof(buf), "AVMetadataScanScheduler statistics: workers %zu, max workers %zu, "
+        "running scans %zu\n  scan %" PRIu64 ", cancel %" PRIu64 ", source %" PRIu64 ", failed %" PRIu64
+        ", cache hit %" PRIu64 ", avg cost %.2f ms\n", stats.workerCount, maxWorkers_, stats.runningScanCount,
+        stats.scanCount, stats.cancelCount, stats.sourceCount, stats.failedCount, stats.cacheHitCount, avgCostMs);
+    dumpString += buf;
+}
+} // namespace Media
+} // namespace OHOS
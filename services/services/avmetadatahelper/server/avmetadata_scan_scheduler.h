@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETADATA_SCAN_SCHEDULER_H
+#define AVMETADATA_SCAN_SCHEDULER_H
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "avmetadatahelper.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Scan the metadata of the sources submitted by all avmetadatahelpers on a bounded worker pool,
+ * so that the media library scanning is not limited by the number of the avmetadatahelpers.
+ *
+ * The workers take the sources of the foreground scans before the background ones, and the scans
+ * of the same priority are taken in turn, one source each time. Each source is scanned with a
+ * warm engine from the AVMetadataHelperEnginePool, and the result is reported at once.
+ *
+ * The dupped fds stay open until their sources are scanned or dropped, so the fds outstanding are
+ * bounded per client and in total, the scan exceeding the bounds is rejected.
+ */
+class AVMetadataScanScheduler {
+public:
+    struct Stats {
+        uint64_t scanCount = 0;
+        uint64_t cancelCount = 0;
+        uint64_t sourceCount = 0;
+        uint64_t failedCount = 0;
+        uint64_t cacheHitCount = 0;
+        uint64_t totalCostUs = 0;
+        size_t workerCount = 0;
+        size_t runningScanCount = 0;
+    };
+
+    static AVMetadataScanScheduler &GetInstance();
+
+    // the fds of the sources are dupped and counted to the client pid, the id of the scan is got by scanId.
+    int32_t Submit(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+        const std::shared_ptr<AVMetadataScanCallback> &callback, pid_t pid, uint64_t &scanId);
+    // the sources not taken are dropped, the scan is finished once the taken ones are done.
+    void Cancel(uint64_t scanId);
+    bool IsRunning(uint64_t scanId);
+    Stats GetStats();
+    void DumpStats(std::string &dumpString);
+
+    DISALLOW_COPY_AND_MOVE(AVMetadataScanScheduler);
+
+private:
+    AVMetadataScanScheduler();
+    ~AVMetadataScanScheduler() = default;
+
+    struct ScanTask {
+        uint64_t id = 0;
+        int32_t priority = AV_META_SCAN_PRIORITY_BACKGROUND;
+        pid_t pid = 0;
+        std::vector<AVMetadataScanSource> sources; // the fds are owned, closed once scanned or dropped.
+        std::shared_ptr<AVMetadataScanCallback> callback;
+        size_t nextIndex = 0;
+        int32_t runningCount = 0;
+        int32_t scannedCount = 0;
+        bool canceled = false;
+    };
+
+    void WorkerLoop();
+    void SpawnWorkersLocked(size_t sourceNum);
+    std::shared_ptr<ScanTask> TakeSourceLocked(size_t &index);
+    void ScanOneSource(std::unique_lock<std::mutex> &lock, const std::shared_ptr<ScanTask> &task, size_t index);
+    int32_t ScanSource(const AVMetadataScanSource &source, std::unordered_map<int32_t, std::string> &metadata,
+        bool &cacheHit);
+    void FinishIfDoneLocked(std::unique_lock<std::mutex> &lock, const std::shared_ptr<ScanTask> &task);
+    void CloseSourceFdLocked(ScanTask &task, size_t index);
+
+    // the scans which still have sources not taken, indexed by the priority.
+    std::deque<std::shared_ptr<ScanTask>> pendingTasks_[AV_META_SCAN_PRIORITY_FOREGROUND + 1];
+    std::map<uint64_t, std::shared_ptr<ScanTask>> runningTasks_;
+    std::vector<std::thread> workers_;
+    size_t maxWorkers_ = 0;
+    size_t idleWorkers_ = 0;
+    uint64_t nextScanId_ = 0;
+    size_t openFdNum_ = 0;
+    std::map<pid_t, size_t> clientFdNum_;
+    Stats stats_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETADATA_SCAN_SCHEDULER_H
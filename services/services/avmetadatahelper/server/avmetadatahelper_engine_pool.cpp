@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmetadatahelper_engine_pool.h"
+#include <chrono>
+#include <securec.h>
+#include "media_errors.h"
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataHelperEnginePool"};
+    constexpr size_t MAX_IDLE_ENGINES = 4;
+    constexpr int64_t IDLE_TIMEOUT_MS = 30000; // 30s
+    constexpr uint64_t US_PER_MS = 1000;
+    constexpr double PERCENT = 100.0;
+
+    int64_t GetCurTimeMs()
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    }
+}
+
+namespace OHOS {
+namespace Media {
+AVMetadataHelperEnginePool &AVMetadataHelperEnginePool::GetInstance()
+{
+    // never destroyed, the engines can not be destroyed after the engine library is unloaded.
+    static auto *instance = new AVMetadataHelperEnginePool();
+    return *instance;
+}
+
+std::shared_ptr<IAVMetadataHelperEngine> AVMetadataHelperEnginePool::Acquire(const IEngineFactory *factory)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    stats_.acquireCount++;
+
+    // take the most recently released one, its memory is more likely to be still resident.
+    for (auto it = idleEngines_.rbegin(); it != idleEngines_.rend(); ++it) {
+        if (it->factory == factory) {
+            std::shared_ptr<IAVMetadataHelperEngine> engine = std::move(it->engine);
+            (void)idleEngines_.erase(std::next(it).base());
+            stats_.hitCount++;
+            return engine;
+        }
+    }
+    return nullptr;
+}
+
+void AVMetadataHelperEnginePool::Release(const IEngineFactory *factory,
+    std::shared_ptr<IAVMetadataHelperEngine> engine)
+{
+    if (factory == nullptr || engine == nullptr) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<IAVMetadataHelperEngine>> trimmed;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stats_.releaseCount++;
+        idleEngines_.push_back({ factory, std::move(engine), GetCurTimeMs() });
+        while (idleEngines_.size() > MAX_IDLE_ENGINES) {
+            trimmed.push_back(std::move(idleEngines_.front().engine));
+            idleEngines_.pop_front();
+            stats_.trimCount++;
+        }
+        ScheduleTrimLocked(IDLE_TIMEOUT_MS);
+    }
+    // destroyed out of the lock, it takes time to stop the threads of the engine.
+    trimmed.clear();
+}
+
+void AVMetadataHelperEnginePool::Clear()
+{
+    std::list<IdleEngine> trimmed;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stats_.trimCount += idleEngines_.size();
+        trimmed.swap(idleEngines_);
+    }
+    // destroyed out of the lock, it takes time to stop the threads of the engine.
+    trimmed.clear();
+}
+
+void AVMetadataHelperEnginePool::ScheduleTrimLocked(int64_t delayMs)
+{
+    if (trimScheduled_) {
+        return;
+    }
+
+    // not the shared pool, destroying the engines blocks for stopping their threads.
+    if (trimQueue_ == nullptr) {
+        auto trimQueue = std::make_unique<TaskQueue>("avmeta-engine-pool");
+        CHECK_AND_RETURN_LOG(trimQueue->Start() == MSERR_OK, "start trim queue failed");
+        trimQueue_ = std::move(trimQueue);
+    }
+
+    auto trimTask = std::make_shared<TaskHandler<void>>([this]() { OnTrimTimeout(); });
+    uint64_t delayUs = static_cast<uint64_t>(delayMs > 0 ? delayMs : 0) * US_PER_MS;
+    CHECK_AND_RETURN_LOG(trimQueue_->EnqueueTask(trimTask, false, delayUs) == MSERR_OK, "schedule trim failed");
+    trimScheduled_ = true;
+}
+
+void AVMetadataHelperEnginePool::OnTrimTimeout()
+{
+    std::vector<std::shared_ptr<IAVMetadataHelperEngine>> trimmed;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        trimScheduled_ = false;
+        int64_t nowMs = GetCurTimeMs();
+        while (!idleEngines_.empty() && nowMs - idleEngines_.front().releaseTimeMs >= IDLE_TIMEOUT_MS) {
+            trimmed.push_back(std::move(idleEngines_.front().engine));
+            idleEngines_.pop_front();
+            stats_.trimCount++;
+        }
+        if (!idleEngines_.empty()) {
+            ScheduleTrimLocked(idleEngines_.front().releaseTimeMs + IDLE_TIMEOUT_MS - nowMs);
+        }
+    }
+
+    if (!trimmed.empty()) {
+        MEDIA_LOGI("trim %{public}zu idle engines", trimmed.size());
+    }
+    trimmed.clear();
+}
+
+AVMetadataHelperEnginePool::Stats AVMetadataHelperEnginePool::GetStats()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.idleCount = idleEngines_.size();
+    return stats;
+}
+
+void AVMetadataHelperEnginePool::DumpStats(std::string &dumpString)
+{
+    Stats stats = GetStats();
+    double hitRate = (stats.acquireCount == 0) ? 0.0 : (PERCENT * stats.hitCount / stats.acquireCount);
+    char buf[256] = {0}; // 256 is enough for one line.
+    (void)sprintf_s(buf, sizeof(buf), "AVMetadataHelperEnginePool statistics: idle %zu, max idle %zu, "
+        "idle timeout %" PRIi64 " ms\n  acquire %" PRIu64 ", hit %" PRIu64 ", hit rate %.1f%%, release %" PRIu64
+        ", trim %" PRIu64 "\n", stats.idleCount, MAX_IDLE_ENGINES, IDLE_TIMEOUT_MS, stats.acquireCount,
+        stats.hitCount, hitRate, stats.releaseCount, stats.trimCount);
+    dumpString += buf;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETADATAHELPER_ENGINE_POOL_H
+#define AVMETADATAHELPER_ENGINE_POOL_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "i_engine_factory.h"
+#include "task_queue.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The engines of the released avmetadatahelpers are kept warm, their threads and pipelines are reused
+ * by the next sources instead of being created again, which dominates the cost of the bulk scanning.
+ *
+ * The idle engines are bounded by the count, the least recently released one is destroyed when the
+ * pool is full, and the engines idle longer than the timeout are destroyed by a delayed task.
+ */
+class __attribute__((visibility("default"))) AVMetadataHelperEnginePool {
+public:
+    struct Stats {
+        uint64_t acquireCount = 0;
+        uint64_t hitCount = 0;
+        uint64_t releaseCount = 0;
+        uint64_t trimCount = 0;
+        size_t idleCount = 0;
+    };
+
+    static AVMetadataHelperEnginePool &GetInstance();
+
+    // get an idle engine created by the factory, return nullptr if there is none.
+    std::shared_ptr<IAVMetadataHelperEngine> Acquire(const IEngineFactory *factory);
+    // the engine must have been reset, so that it does not read the previous source anymore.
+    void Release(const IEngineFactory *factory, std::shared_ptr<IAVMetadataHelperEngine> engine);
+    // destroy all the idle engines, so that the next sources start cold.
+    void Clear();
+    Stats GetStats();
+    void DumpStats(std::string &dumpString);
+
+    DISALLOW_COPY_AND_MOVE(AVMetadataHelperEnginePool);
+
+private:
+    AVMetadataHelperEnginePool() = default;
+    ~AVMetadataHelperEnginePool() = default;
+
+    struct IdleEngine {
+        const IEngineFactory *factory;
+        std::shared_ptr<IAVMetadataHelperEngine> engine;
+        int64_t releaseTimeMs;
+    };
+
+    void ScheduleTrimLocked(int64_t delayMs);
+    void OnTrimTimeout();
+
+    // ordered by the release time, the most recently released one at the back.
+    std::list<IdleEngine> idleEngines_;
+    Stats stats_;
+    std::unique_ptr<TaskQueue> trimQueue_;
+    bool trimScheduled_ = false;
+    std::mutex mutex_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETADATAHELPER_ENGINE_POOL_H
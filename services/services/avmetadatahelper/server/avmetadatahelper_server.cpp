@@ -14,9 +14,15 @@
  */
 
 #include "avmetadatahelper_server.h"
+#include <cerrno>
+#include <unistd.h>
+#include "ipc_skeleton.h"
 #include "media_log.h"
 #include "media_errors.h"
 #include "engine_factory_repo.h"
+#include "avmetadatahelper_engine_pool.h"
+#include "avmetadata_scan_scheduler.h"
+#include "uri_helper.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataHelperServer"};
@@ -40,56 +46,211 @@ AVMetadataHelperServer::~AVMetadataHelperServer()
 {
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
     std::lock_guard<std::mutex> lock(mutex_);
-    avMetadataHelperEngine_ = nullptr;
+    AVMetadataScanScheduler::GetInstance().Cancel(scanId_);
+    ResetSource();
 }
 
 int32_t AVMetadataHelperServer::SetSource(const std::string &uri, int32_t usage)
 {
     std::lock_guard<std::mutex> lock(mutex_);
+    // the fd in the uri is not valid in this process, the fd source must be set by the fd.
+    CHECK_AND_RETURN_RET_LOG(!UriHelper(uri).IsFdScheme(), MSERR_INVALID_VAL, "fd uri is not accepted");
+    return SetSourceInternal(uri, usage);
+}
+
+int32_t AVMetadataHelperServer::SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(fd >= 0 && offset >= 0, MSERR_INVALID_VAL, "invalid fd source");
+
+    int32_t dupFd = dup(fd);
+    CHECK_AND_RETURN_RET_LOG(dupFd >= 0, MSERR_INVALID_VAL, "dup fd failed, errno: %{public}d", errno);
+    int32_t ret = SetSourceInternal(UriHelper::MakeFdUri(dupFd, offset, size), usage);
+    if (ret != MSERR_OK) {
+        ResetSource();
+        (void)::close(dupFd);
+        return ret;
+    }
+    sourceFd_ = dupFd;
+    return MSERR_OK;
+}
+
+void AVMetadataHelperServer::CloseSourceFd()
+{
+    if (sourceFd_ >= 0) {
+        (void)::close(sourceFd_);
+        sourceFd_ = -1;
+    }
+}
+
+void AVMetadataHelperServer::ReleaseEngine()
+{
+    if (avMetadataHelperEngine_ != nullptr) {
+        // the engine stops reading the source before the fd is closed, and is kept warm for the next source.
+        avMetadataHelperEngine_->Reset();
+        AVMetadataHelperEnginePool::GetInstance().Release(engineFactory_.get(), std::move(avMetadataHelperEngine_));
+        avMetadataHelperEngine_ = nullptr;
+    }
+    engineFactory_ = nullptr;
+}
+
+void AVMetadataHelperServer::ResetSource()
+{
+    ReleaseEngine();
+    CloseSourceFd();
+    uri_.clear();
+    cacheable_ = false;
+    hasMetadata_ = false;
+    metadata_.clear();
+}
+
+int32_t AVMetadataHelperServer::SetSourceInternal(const std::string &uri, int32_t usage)
+{
     MEDIA_LOGD("Current uri is : %{public}s %{public}u", uri.c_str(), usage);
-    auto engineFactory = EngineFactoryRepo::Instance().GetEngineFactory(IEngineFactory::Scene::SCENE_AVMETADATA, uri);
+    // a cache hit returns before any engine checks the usage.
+    CHECK_AND_RETURN_RET_LOG(usage == AVMetadataUsage::AV_META_USAGE_META_ONLY ||
+        usage == AVMetadataUsage::AV_META_USAGE_PIXEL_MAP, MSERR_INVALID_VAL, "invalid usage: %{public}d", usage);
+    // the previous engine may still read the previous fd source.
+    ResetSource();
+    uri_ = uri;
+    usage_ = usage;
+
+    cacheable_ = AVMetadataCacheKey::Make(uri, cacheKey_);
+    if (cacheable_ && AVMetadataCache::GetInstance().Get(cacheKey_, metadata_)) {
+        MEDIA_LOGD("metadata cache hit");
+        hasMetadata_ = true;
+        return MSERR_OK;
+    }
+
+    int32_t ret = CreateEngine();
+    if (ret != MSERR_OK) {
+        ResetSource();
+    }
+    return ret;
+}
+
+int32_t AVMetadataHelperServer::CreateEngine()
+{
+    auto engineFactory = EngineFactoryRepo::Instance().GetEngineFactory(IEngineFactory::Scene::SCENE_AVMETADATA, uri_);
     CHECK_AND_RETURN_RET_LOG(engineFactory != nullptr, MSERR_CREATE_AVMETADATAHELPER_ENGINE_FAILED,
         "Failed to get engine factory");
-    avMetadataHelperEngine_ = engineFactory->CreateAVMetadataHelperEngine();
-    CHECK_AND_RETURN_RET_LOG(avMetadataHelperEngine_ != nullptr, MSERR_CREATE_AVMETADATAHELPER_ENGINE_FAILED,
-        "Failed to create avmetadatahelper engine");
+    avMetadataHelperEngine_ = AVMetadataHelperEnginePool::GetInstance().Acquire(engineFactory.get());
+    if (avMetadataHelperEngine_ == nullptr) {
+        avMetadataHelperEngine_ = engineFactory->CreateAVMetadataHelperEngine();
+        CHECK_AND_RETURN_RET_LOG(avMetadataHelperEngine_ != nullptr, MSERR_CREATE_AVMETADATAHELPER_ENGINE_FAILED,
+            "Failed to create avmetadatahelper engine");
+    }
+    engineFactory_ = engineFactory;
 
-    int32_t ret = avMetadataHelperEngine_->SetSource(uri, usage);
+    int32_t ret = avMetadataHelperEngine_->SetSource(uri_, usage_);
     CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "SetSource failed!");
 
     return MSERR_OK;
 }
 
+int32_t AVMetadataHelperServer::ResolveAllMetadata()
+{
+    if (hasMetadata_) {
+        return MSERR_OK;
+    }
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperEngine_ != nullptr, MSERR_INVALID_OPERATION,
+        "avMetadataHelperEngine_ is nullptr");
+
+    metadata_ = avMetadataHelperEngine_->ResolveMetadata();
+    CHECK_AND_RETURN_RET_LOG(!metadata_.empty(), MSERR_UNKNOWN, "resolve metadata failed");
+    hasMetadata_ = true;
+    if (cacheable_) {
+        AVMetadataCache::GetInstance().Put(cacheKey_, metadata_);
+    }
+    return MSERR_OK;
+}
+
 std::string AVMetadataHelperServer::ResolveMetadata(int32_t key)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     MEDIA_LOGD("Key is %{public}d", key);
-    CHECK_AND_RETURN_RET_LOG(avMetadataHelperEngine_ != nullptr, "",
-        "avMetadataHelperEngine_ is nullptr");
-    return avMetadataHelperEngine_->ResolveMetadata(key);
+    if (!hasMetadata_) {
+        // the engine returns once this key is known, not waiting for all keys.
+        CHECK_AND_RETURN_RET_LOG(avMetadataHelperEngine_ != nullptr, "", "avMetadataHelperEngine_ is nullptr");
+        return avMetadataHelperEngine_->ResolveMetadata(key);
+    }
+
+    auto it = metadata_.find(key);
+    CHECK_AND_RETURN_RET_LOG(it != metadata_.end(), "",
+        "The specified metadata %{public}d cannot be obtained from the specified stream.", key);
+    return it->second;
 }
 
 std::unordered_map<int32_t, std::string> AVMetadataHelperServer::ResolveMetadata()
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    CHECK_AND_RETURN_RET_LOG(avMetadataHelperEngine_ != nullptr, {},
-        "avMetadataHelperEngine_ is nullptr");
-    return avMetadataHelperEngine_->ResolveMetadata();
+    int32_t ret = ResolveAllMetadata();
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, {});
+    return metadata_;
 }
 
 std::shared_ptr<AVSharedMemory> AVMetadataHelperServer::FetchFrameAtTime(int64_t timeUs, int32_t option,
     OutputConfiguration param)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    CHECK_AND_RETURN_RET_LOG(avMetadataHelperEngine_ != nullptr, nullptr,
-        "avMetadataHelperEngine_ is nullptr");
+    int32_t ret = PrepareFrameEngine();
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
     return avMetadataHelperEngine_->FetchFrameAtTime(timeUs, option, param);
 }
 
+std::shared_ptr<AVSharedMemory> AVMetadataHelperServer::FetchFramesAtTimes(const std::vector<int64_t> &timesUs,
+    int32_t option, OutputConfiguration param)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    int32_t ret = PrepareFrameEngine();
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+    return avMetadataHelperEngine_->FetchFramesAtTimes(timesUs, option, param);
+}
+
+int32_t AVMetadataHelperServer::PrepareFrameEngine()
+{
+    if (avMetadataHelperEngine_ == nullptr && !uri_.empty()) {
+        // the metadata was got from the cache, the frame needs the engine.
+        int32_t ret = CreateEngine();
+        if (ret != MSERR_OK) {
+            ReleaseEngine();
+            return ret;
+        }
+    }
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperEngine_ != nullptr, MSERR_INVALID_OPERATION,
+        "avMetadataHelperEngine_ is nullptr");
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperServer::ScanMetadata(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+    const std::shared_ptr<AVMetadataScanCallback> &callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    AVMetadataScanScheduler &scheduler = AVMetadataScanScheduler::GetInstance();
+    CHECK_AND_RETURN_RET_LOG(scanId_ == 0 || !scheduler.IsRunning(scanId_), MSERR_INVALID_STATE,
+        "the previous scan is still running");
+
+    uint64_t scanId = 0;
+    int32_t ret = scheduler.Submit(sources, priority, callback, IPCSkeleton::GetCallingPid(), scanId);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "submit scan failed");
+    scanId_ = scanId;
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperServer::CancelScan()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    AVMetadataScanScheduler::GetInstance().Cancel(scanId_);
+    scanId_ = 0;
+    return MSERR_OK;
+}
+
 void AVMetadataHelperServer::Release()
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    avMetadataHelperEngine_ = nullptr;
+    AVMetadataScanScheduler::GetInstance().Cancel(scanId_);
+    scanId_ = 0;
+    ResetSource();
+}
 }
 }
-}
\ No newline at end of file
@@ -19,6 +19,8 @@
 #include <mutex>
 #include "i_avmetadatahelper_service.h"
 #include "i_avmetadatahelper_engine.h"
+#include "i_engine_factory.h"
+#include "avmetadata_cache.h"
 #include "nocopyable.h"
 
 namespace OHOS {
@@ -31,13 +33,37 @@ public:
     DISALLOW_COPY_AND_MOVE(AVMetadataHelperServer);
 
     int32_t SetSource(const std::string &uri, int32_t usage) override;
+    int32_t SetSource(int32_t fd, int64_t offset, int64_t size, int32_t usage) override;
     std::string ResolveMetadata(int32_t key) override;
     std::unordered_map<int32_t, std::string> ResolveMetadata() override;
     std::shared_ptr<AVSharedMemory> FetchFrameAtTime(int64_t timeUs,
         int32_t option, OutputConfiguration param) override;
+    std::shared_ptr<AVSharedMemory> FetchFramesAtTimes(const std::vector<int64_t> &timesUs,
+        int32_t option, OutputConfiguration param) override;
+    int32_t ScanMetadata(const std::vector<AVMetadataScanSource> &sources, int32_t priority,
+        const std::shared_ptr<AVMetadataScanCallback> &callback) override;
+    int32_t CancelScan() override;
     void Release() override;
 private:
+    int32_t SetSourceInternal(const std::string &uri, int32_t usage);
+    int32_t CreateEngine();
+    void ReleaseEngine();
+    int32_t PrepareFrameEngine();
+    int32_t ResolveAllMetadata();
+    void CloseSourceFd();
+    void ResetSource();
+
     std::shared_ptr<IAVMetadataHelperEngine> avMetadataHelperEngine_ = nullptr;
+    std::shared_ptr<IEngineFactory> engineFactory_ = nullptr; // the factory of the engine, for pooling.
+    int32_t sourceFd_ = -1; // the dup of the fd source, read by the engine until released.
+    std::string uri_;
+    int32_t usage_ = AVMetadataUsage::AV_META_USAGE_PIXEL_MAP;
+    // the engine is not created if the metadata is got from the cache, until a frame is fetched.
+    bool cacheable_ = false;
+    AVMetadataCacheKey cacheKey_;
+    bool hasMetadata_ = false;
+    std::unordered_map<int32_t, std::string> metadata_;
+    uint64_t scanId_ = 0; // the scan submitted to the AVMetadataScanScheduler, 0 if none.
     std::mutex mutex_;
 };
 } // namespace Media
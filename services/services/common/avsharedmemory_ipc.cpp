@@ -34,33 +34,113 @@ int32_t WriteAVSharedMemoryToParcel(const std::shared_ptr<AVSharedMemory> &memor
     }
 
     int32_t fd = baseMem->GetFd();
-    int32_t size = baseMem->GetSize();
+    // the receiver maps the whole region, whose size is checked with the ashmem size.
+    int32_t size = baseMem->GetCapacity();
     CHECK_AND_RETURN_RET_LOG(fd > 0 || size > 0, MSERR_INVALID_VAL, "fd or size invalid");
 
     (void)parcel.WriteFileDescriptor(fd);
     parcel.WriteInt32(size);
     parcel.WriteUint32(baseMem->GetFlags());
     parcel.WriteString(baseMem->GetName());
+    parcel.WriteUint64(baseMem->GetUniqueId());
 
     return MSERR_OK;
 }
 
+namespace {
+std::shared_ptr<AVSharedMemory> CreateRemoteMemory(int32_t fd, int32_t size, uint32_t flags, const std::string &name)
+{
+    std::shared_ptr<AVSharedMemoryBase> memory = std::make_shared<AVSharedMemoryBase>(fd, size, flags, name);
+    int32_t ret = memory->Init();
+    if (ret != MSERR_OK) {
+        MEDIA_LOGE("create remote AVSharedMemoryBase failed, ret = %{public}d", ret);
+        memory = nullptr;
+    }
+    return memory;
+}
+}
+
 std::shared_ptr<AVSharedMemory> ReadAVSharedMemoryFromParcel(MessageParcel &parcel)
 {
     int32_t fd  = parcel.ReadFileDescriptor();
     int32_t size = parcel.ReadInt32();
     uint32_t flags = parcel.ReadUint32();
     std::string name = parcel.ReadString();
+    (void)parcel.ReadUint64();
 
-    std::shared_ptr<AVSharedMemoryBase> memory = std::make_shared<AVSharedMemoryBase>(fd, size, flags, name);
-    int32_t ret = memory->Init();
-    if (ret != MSERR_OK) {
-        MEDIA_LOGE("create remote AVSharedMemoryBase failed, ret = %{public}d", ret);
-        memory = nullptr;
+    std::shared_ptr<AVSharedMemory> memory = CreateRemoteMemory(fd, size, flags, name);
+    (void)::close(fd);
+    return memory;
+}
+
+std::shared_ptr<AVSharedMemory> ReadAVSharedMemoryFromParcel(MessageParcel &parcel, AVSharedMemoryCache &cache)
+{
+    int32_t fd  = parcel.ReadFileDescriptor();
+    int32_t size = parcel.ReadInt32();
+    uint32_t flags = parcel.ReadUint32();
+    std::string name = parcel.ReadString();
+    uint64_t uniqueId = parcel.ReadUint64();
+
+    std::shared_ptr<AVSharedMemory> memory = cache.Find(uniqueId, size, flags, name);
+    if (memory == nullptr) {
+        memory = CreateRemoteMemory(fd, size, flags, name);
+        if (memory != nullptr) {
+            cache.Insert(uniqueId, memory);
+        }
     }
 
     (void)::close(fd);
     return memory;
 }
+
+AVSharedMemoryCache::AVSharedMemoryCache(size_t capacity) : capacity_(capacity)
+{
+}
+
+std::shared_ptr<AVSharedMemory> AVSharedMemoryCache::Find(uint64_t uniqueId, int32_t size, uint32_t flags,
+    const std::string &name)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->uniqueId != uniqueId) {
+            continue;
+        }
+        std::shared_ptr<AVSharedMemoryBase> baseMem = std::static_pointer_cast<AVSharedMemoryBase>(it->memory);
+        if (baseMem->GetCapacity() != size || baseMem->GetFlags() != flags || baseMem->GetName() != name) {
+            MEDIA_LOGW("the remote memory %{public}s mismatched, drop the cached one", name.c_str());
+            (void)entries_.erase(it);
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, it);
+        return baseMem;
+    }
+    return nullptr;
+}
+
+void AVSharedMemoryCache::Insert(uint64_t uniqueId, const std::shared_ptr<AVSharedMemory> &memory)
+{
+    std::shared_ptr<AVSharedMemory> evicted = nullptr;
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (capacity_ == 0) {
+        return;
+    }
+    if (entries_.size() >= capacity_) {
+        evicted = std::move(entries_.back().memory);
+        entries_.pop_back();
+    }
+    entries_.push_front({ uniqueId, memory });
+    lock.unlock();
+    // unmap out of the lock if this is the last reference.
+    evicted = nullptr;
+}
+
+void AVSharedMemoryCache::Clear()
+{
+    std::list<CacheEntry> entries;
+    std::unique_lock<std::mutex> lock(mutex_);
+    entries.swap(entries_);
+    lock.unlock();
+    entries.clear();
+}
 }
 }
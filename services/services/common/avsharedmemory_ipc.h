@@ -16,14 +16,55 @@
 #ifndef AVSHAREDMEMORY_IPC_H
 #define AVSHAREDMEMORY_IPC_H
 
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
 #include <message_parcel.h>
 #include "avsharedmemory.h"
+#include "nocopyable.h"
 
 namespace OHOS {
 namespace Media {
+/**
+ * Keep the mappings of the remote memories received from one peer. The sender writes the unique id
+ * of the memory into the parcel, so the memory sent again, e.g. the one recycled by the sender's
+ * AVSharedMemoryPool, reuses the existing mapping instead of mmap and munmap again.
+ *
+ * The ids are never reused by the sender, the entries of the memories dropped by the remote side will
+ * not be hit anymore, and they are evicted as the least recently used ones. The memory got from
+ * the cache may be the same object returned before, so it is only suitable for the case where the
+ * previous content has been consumed when the next memory is read, such as the data source.
+ */
+class AVSharedMemoryCache {
+public:
+    explicit AVSharedMemoryCache(size_t capacity = DEFAULT_CAPACITY);
+    ~AVSharedMemoryCache() = default;
+
+    std::shared_ptr<AVSharedMemory> Find(uint64_t uniqueId, int32_t size, uint32_t flags, const std::string &name);
+    void Insert(uint64_t uniqueId, const std::shared_ptr<AVSharedMemory> &memory);
+    void Clear();
+
+    DISALLOW_COPY_AND_MOVE(AVSharedMemoryCache);
+
+private:
+    static constexpr size_t DEFAULT_CAPACITY = 8;
+    struct CacheEntry {
+        uint64_t uniqueId;
+        std::shared_ptr<AVSharedMemory> memory;
+    };
+    size_t capacity_;
+    // the most recently used one at the front.
+    std::list<CacheEntry> entries_;
+    std::mutex mutex_;
+};
+
 [[maybe_unused]] int32_t WriteAVSharedMemoryToParcel(const std::shared_ptr<AVSharedMemory> &memory,
     MessageParcel &parcel);
 [[maybe_unused]] std::shared_ptr<AVSharedMemory> ReadAVSharedMemoryFromParcel(MessageParcel &parcel);
+// reuse the mapping in the cache if the same remote memory is received again.
+[[maybe_unused]] std::shared_ptr<AVSharedMemory> ReadAVSharedMemoryFromParcel(MessageParcel &parcel,
+    AVSharedMemoryCache &cache);
 }
 }
 #endif
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "player_clock.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <new>
+#include "media_errors.h"
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "PlayerClock"};
+    constexpr double RATE_BASE = 1000.0;
+    constexpr int64_t NS_PER_SEC = 1000000000;
+    constexpr int64_t NS_PER_MS = 1000000;
+    constexpr uint32_t HIGH_SHIFT = 32;
+    constexpr uint32_t MAX_READ_RETRIES = 64;
+    // not extrapolated further, in case the position updates stop without any notification.
+    constexpr int64_t MAX_EXTRAPOLATION_NS = 1000 * NS_PER_MS;
+
+    int64_t GetMonotonicNs()
+    {
+        struct timespec ts = {};
+        (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * NS_PER_SEC + static_cast<int64_t>(ts.tv_nsec);
+    }
+
+    int32_t Extrapolate(int32_t anchorPositionMs, int64_t anchorTimeNs, uint32_t rateMilli, int64_t nowNs)
+    {
+        int64_t elapsedNs = std::clamp<int64_t>(nowNs - anchorTimeNs, 0, MAX_EXTRAPOLATION_NS);
+        int64_t positionMs = anchorPositionMs + elapsedNs * rateMilli / static_cast<int64_t>(RATE_BASE) / NS_PER_MS;
+        return static_cast<int32_t>(std::min<int64_t>(positionMs, INT32_MAX));
+    }
+}
+
+namespace OHOS {
+namespace Media {
+int32_t PlayerClockWriter::Init()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(memory_ == nullptr, MSERR_INVALID_OPERATION, "inited already");
+
+    memory_ = AVSharedMemory::Create(sizeof(PlayerClockPage), AVSharedMemory::FLAGS_READ_ONLY, "PlayerClock");
+    CHECK_AND_RETURN_RET_LOG(memory_ != nullptr && memory_->GetBase() != nullptr, MSERR_NO_MEMORY,
+        "create clock memory failed");
+
+    page_ = new (memory_->GetBase()) PlayerClockPage();
+    page_->version.store(PlayerClockPage::VERSION, std::memory_order_relaxed);
+    PublishLocked();
+    return MSERR_OK;
+}
+
+std::shared_ptr<AVSharedMemory> PlayerClockWriter::GetMemory() const
+{
+    return memory_;
+}
+
+void PlayerClockWriter::SetState(PlayerStates state)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN(page_ != nullptr);
+    ReanchorLocked(GetMonotonicNs());
+    state_ = state;
+    if (state != PLAYER_STARTED && state != PLAYER_PAUSED && state != PLAYER_PLAYBACK_COMPLETE) {
+        anchorPositionMs_ = 0;
+    }
+    PublishLocked();
+}
+
+void PlayerClockWriter::SetPosition(int32_t positionMs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN(page_ != nullptr);
+    anchorPositionMs_ = positionMs;
+    anchorTimeNs_ = GetMonotonicNs();
+    PublishLocked();
+}
+
+void PlayerClockWriter::SetBuffering(bool buffering)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN(page_ != nullptr);
+    ReanchorLocked(GetMonotonicNs());
+    buffering_ = buffering;
+    PublishLocked();
+}
+
+void PlayerClockWriter::SetRate(double rate)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN(page_ != nullptr);
+    ReanchorLocked(GetMonotonicNs());
+    rateMilli_ = static_cast<uint32_t>(std::lround(rate * RATE_BASE));
+    PublishLocked();
+}
+
+void PlayerClockWriter::ReanchorLocked(int64_t nowNs)
+{
+    // freeze or resume at the current position, the elapsed time before is counted by the old values.
+    if (state_ == PLAYER_STARTED && !buffering_) {
+        anchorPositionMs_ = Extrapolate(anchorPositionMs_, anchorTimeNs_, rateMilli_, nowNs);
+    }
+    anchorTimeNs_ = nowNs;
+}
+
+void PlayerClockWriter::PublishLocked()
+{
+    uint32_t seq = page_->seq.load(std::memory_order_relaxed);
+    page_->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    page_->state.store(static_cast<int32_t>(state_), std::memory_order_relaxed);
+    page_->running.store((state_ == PLAYER_STARTED && !buffering_) ? 1 : 0, std::memory_order_relaxed);
+    page_->anchorPositionMs.store(anchorPositionMs_, std::memory_order_relaxed);
+    uint64_t anchorTimeNs = static_cast<uint64_t>(anchorTimeNs_);
+    page_->anchorTimeNsHigh.store(static_cast<uint32_t>(anchorTimeNs >> HIGH_SHIFT), std::memory_order_relaxed);
+    page_->anchorTimeNsLow.store(static_cast<uint32_t>(anchorTimeNs), std::memory_order_relaxed);
+    page_->rateMilli.store(rateMilli_, std::memory_order_relaxed);
+    page_->seq.store(seq + 2, std::memory_order_release); // 2: even again, the write is done.
+}
+
+PlayerClockReader::PlayerClockReader(const std::shared_ptr<AVSharedMemory> &memory) : memory_(memory)
+{
+    if (memory_ != nullptr && memory_->GetBase() != nullptr &&
+        memory_->GetSize() >= static_cast<int32_t>(sizeof(PlayerClockPage))) {
+        page_ = reinterpret_cast<const PlayerClockPage *>(memory_->GetBase());
+    }
+}
+
+bool PlayerClockReader::GetCurrentTime(int32_t &currentTime) const
+{
+    CHECK_AND_RETURN_RET(page_ != nullptr, false);
+
+    for (uint32_t retry = 0; retry < MAX_READ_RETRIES; retry++) {
+        uint32_t seq = page_->seq.load(std::memory_order_acquire);
+        if ((seq & 1) != 0) {
+            continue; // being written.
+        }
+        uint32_t version = page_->version.load(std::memory_order_relaxed);
+        int32_t state = page_->state.load(std::memory_order_relaxed);
+        uint32_t running = page_->running.load(std::memory_order_relaxed);
+        int32_t anchorPositionMs = page_->anchorPositionMs.load(std::memory_order_relaxed);
+        uint64_t anchorTimeNs = (static_cast<uint64_t>(page_->anchorTimeNsHigh.load(std::memory_order_relaxed)) <<
+            HIGH_SHIFT) | page_->anchorTimeNsLow.load(std::memory_order_relaxed);
+        uint32_t rateMilli = page_->rateMilli.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (page_->seq.load(std::memory_order_relaxed) != seq) {
+            continue;
+        }
+
+        // the position at the completion or the stop is decided by the engine.
+        if (version != PlayerClockPage::VERSION ||
+            (state != PLAYER_PREPARED && state != PLAYER_STARTED && state != PLAYER_PAUSED)) {
+            return false;
+        }
+        currentTime = (running != 0) ? Extrapolate(anchorPositionMs, static_cast<int64_t>(anchorTimeNs),
+            rateMilli, GetMonotonicNs()) : anchorPositionMs;
+        return true;
+    }
+    MEDIA_LOGW("the clock page is busy, read from the server");
+    return false;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PLAYER_CLOCK_H
+#define PLAYER_CLOCK_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "avsharedmemory.h"
+#include "player.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The playback clock shared by the player server with its client, so that the client computes the
+ * position locally instead of a GetCurrentTime IPC for each polling.
+ *
+ * The page is written by the server only, under a seqlock: the seq is odd while writing. All fields
+ * are 32 bits atomics, so the read-only mapping of the client never needs an exclusive store.
+ * The position is anchor position + (now - anchor time) * rate while running, the anchor time is
+ * of the CLOCK_MONOTONIC, which is the same in all processes.
+ */
+struct PlayerClockPage {
+    static constexpr uint32_t VERSION = 1;
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> version;
+    std::atomic<int32_t> state; // PlayerStates
+    std::atomic<uint32_t> running; // started and not buffering
+    std::atomic<int32_t> anchorPositionMs;
+    std::atomic<uint32_t> anchorTimeNsHigh;
+    std::atomic<uint32_t> anchorTimeNsLow;
+    std::atomic<uint32_t> rateMilli; // the playback rate * 1000
+};
+
+class PlayerClockWriter {
+public:
+    PlayerClockWriter() = default;
+    ~PlayerClockWriter() = default;
+
+    int32_t Init();
+    // the memory is read-only for the remote process, return nullptr if not inited.
+    std::shared_ptr<AVSharedMemory> GetMemory() const;
+    void SetState(PlayerStates state);
+    void SetPosition(int32_t positionMs);
+    void SetBuffering(bool buffering);
+    void SetRate(double rate);
+
+    DISALLOW_COPY_AND_MOVE(PlayerClockWriter);
+
+private:
+    void ReanchorLocked(int64_t nowNs);
+    void PublishLocked();
+
+    std::shared_ptr<AVSharedMemory> memory_ = nullptr;
+    PlayerClockPage *page_ = nullptr;
+    // the copy of the published values, only accessed by the writer.
+    PlayerStates state_ = PLAYER_IDLE;
+    bool buffering_ = false;
+    int32_t anchorPositionMs_ = 0;
+    int64_t anchorTimeNs_ = 0;
+    uint32_t rateMilli_ = 1000;
+    std::mutex mutex_;
+};
+
+class PlayerClockReader {
+public:
+    explicit PlayerClockReader(const std::shared_ptr<AVSharedMemory> &memory);
+    ~PlayerClockReader() = default;
+
+    /**
+     * Compute the current position from the page. Return false if the page is being written for too
+     * long, or the position can not be computed locally in current state, the caller should get it
+     * from the server instead.
+     */
+    bool GetCurrentTime(int32_t &currentTime) const;
+
+    DISALLOW_COPY_AND_MOVE(PlayerClockReader);
+
+private:
+    std::shared_ptr<AVSharedMemory> memory_;
+    const PlayerClockPage *page_ = nullptr;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // PLAYER_CLOCK_H
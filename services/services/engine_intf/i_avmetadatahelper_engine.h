@@ -69,6 +69,28 @@ public:
      */
     virtual std::shared_ptr<AVSharedMemory> FetchFrameAtTime(
         int64_t timeUs, int32_t option, OutputConfiguration param) = 0;
+
+    /**
+     * Fetch the video frames at the given timestamps over one prepared pipeline. The timestamps
+     * are visited in the time order, the frame shared by several timestamps is fetched once, and
+     * the nearby frames are decoded forward instead of seeking for each one. This method must be
+     * called after the SetSource.
+     * @param timesUs the time positions in microseconds, at most {@link OutputFrameSlab::MAX_FRAME_COUNT}.
+     * @param option the hint about how to fetch a frame, see {@link AVMetadataQueryOption}
+     * @param param the desired configuration of returned video frames, see {@link OutputConfiguration}.
+     * All frames are scaled to the same size.
+     * @return Returns a chunk of shared memory in the layout of {@link OutputFrameSlab}, the entry of the
+     * failed timestamp has zero offset. Returns null if none of the frames can be fetched.
+     */
+    virtual std::shared_ptr<AVSharedMemory> FetchFramesAtTimes(
+        const std::vector<int64_t> &timesUs, int32_t option, OutputConfiguration param) = 0;
+
+    /**
+     * Release the current source, the source is not read anymore after this method returns. The
+     * engine can be set with another source by the SetSource, and it may keep the resources of the
+     * previous source that are expensive to create, such as the threads and the pipeline, for reuse.
+     */
+    virtual void Reset() = 0;
 };
 }
 }
@@ -40,11 +40,14 @@ public:
 
     virtual int32_t SetSource(const std::string &uri) = 0;
     virtual int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc) = 0;
+    // the fd uri is accepted, the fd must be valid until the engine is reset.
+    virtual int32_t SetNextSource(const std::string &uri) = 0;
     virtual int32_t Play() = 0;
     virtual int32_t Prepare() = 0;
     virtual int32_t PrepareAsync() = 0;
     virtual int32_t Pause() = 0;
     virtual int32_t Stop() = 0;
+    // the engine is reusable after the reset, with the source and the surface set again.
     virtual int32_t Reset() = 0;
     virtual int32_t SetVolume(float leftVolume, float rightVolume) = 0;
     virtual int32_t Seek(int32_t mSeconds, PlayerSeekMode mode) = 0;
@@ -54,6 +57,8 @@ public:
     virtual int32_t GetPlaybackSpeed(PlaybackRateMode &mode) = 0;
     virtual int32_t SetVideoSurface(sptr<Surface> surface) = 0;
     virtual int32_t SetLooping(bool loop) = 0;
+    // no video chain is built for the audio only player, set before the prepare.
+    virtual int32_t SetAudioOnly(bool audioOnly) = 0;
     virtual int32_t SetObs(const std::weak_ptr<IPlayerEngineObs> &obs) = 0;
 };
 } // Media
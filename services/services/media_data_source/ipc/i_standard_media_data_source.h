@@ -32,12 +32,22 @@ public:
     virtual int32_t ReadAt(int64_t pos, uint32_t length) = 0;
     virtual int32_t ReadAt(uint32_t length) = 0;
     virtual int32_t GetSize(int64_t &size) = 0;
+    /**
+     * Share a ring buffer created by the server with the client once, then each ReadAtRingBuffer
+     * costs only one transaction: the client copies the data into the ring at the given offset,
+     * no memory object is passed back.
+     */
+    virtual int32_t SetRingBuffer(const std::shared_ptr<AVSharedMemory> &ringBuffer) = 0;
+    // read from the stream if the pos is less than 0, return the length written into the ring buffer.
+    virtual int32_t ReadAtRingBuffer(int64_t pos, uint32_t length, uint32_t offset) = 0;
 
     enum ListenerMsg {
         READ_AT = 0,
         READ_AT_POS,
         GET_SIZE,
         GET_MEM,
+        SET_RING_BUFFER,
+        READ_AT_RING_BUFFER,
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"IStandardMediaDataSource");
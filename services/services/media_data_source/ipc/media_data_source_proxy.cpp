@@ -14,12 +14,14 @@
  */
 
 #include "media_data_source_proxy.h"
+#include <algorithm>
 #include "media_log.h"
 #include "media_errors.h"
 #include "avsharedmemory_ipc.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "MediaDataSourceProxy"};
+constexpr int32_t RING_BUFFER_SIZE = 2 * 1024 * 1024; // 2MB
 }
 
 namespace OHOS {
@@ -35,21 +37,50 @@ MediaDataCallback::~MediaDataCallback()
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
 }
 
+int32_t MediaDataCallback::InitRingBuffer()
+{
+    CHECK_AND_RETURN_RET_LOG(callbackProxy_ != nullptr, MSERR_INVALID_OPERATION, "callbackProxy_ is nullptr");
+    std::shared_ptr<AVSharedMemory> ringBuffer =
+        AVSharedMemory::Create(RING_BUFFER_SIZE, AVSharedMemory::FLAGS_READ_WRITE, "DataSourceRingBuffer");
+    CHECK_AND_RETURN_RET_LOG(ringBuffer != nullptr, MSERR_NO_MEMORY, "create ring buffer failed");
+
+    int32_t ret = callbackProxy_->SetRingBuffer(ringBuffer);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "set ring buffer failed");
+    ringBuffer_ = ringBuffer;
+    return MSERR_OK;
+}
+
+int32_t MediaDataCallback::ReadAtRingBuffer(int64_t pos, uint32_t length)
+{
+    // the reader copies the data out before the next read, so every read is written at the start of the ring.
+    length = std::min(length, static_cast<uint32_t>(ringBuffer_->GetSize()));
+    return callbackProxy_->ReadAtRingBuffer(pos, length, 0);
+}
+
 std::shared_ptr<AVSharedMemory> MediaDataCallback::GetMem()
 {
     CHECK_AND_RETURN_RET_LOG(callbackProxy_ != nullptr, nullptr, "callbackProxy_ is nullptr");
+    if (ringBuffer_ != nullptr) {
+        return ringBuffer_;
+    }
     return callbackProxy_->GetMem();
 }
 
 int32_t MediaDataCallback::ReadAt(uint32_t length)
 {
     CHECK_AND_RETURN_RET_LOG(callbackProxy_ != nullptr, SOURCE_ERROR_IO, "callbackProxy_ is nullptr");
+    if (ringBuffer_ != nullptr) {
+        return ReadAtRingBuffer(-1, length);
+    }
     return callbackProxy_->ReadAt(length);
 }
 
 int32_t MediaDataCallback::ReadAt(int64_t pos, uint32_t length)
 {
     CHECK_AND_RETURN_RET_LOG(callbackProxy_ != nullptr, SOURCE_ERROR_IO, "callbackProxy_ is nullptr");
+    if (ringBuffer_ != nullptr) {
+        return ReadAtRingBuffer(pos, length);
+    }
     return callbackProxy_->ReadAt(pos, length);
 }
 
@@ -68,6 +99,7 @@ MediaDataSourceProxy::MediaDataSourceProxy(const sptr<IRemoteObject> &impl)
 MediaDataSourceProxy::~MediaDataSourceProxy()
 {
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+    memCache_.Clear();
 }
 
 std::shared_ptr<AVSharedMemory> MediaDataSourceProxy::GetMem()
@@ -80,7 +112,7 @@ std::shared_ptr<AVSharedMemory> MediaDataSourceProxy::GetMem()
         MEDIA_LOGE("on info failed, error: %{public}d", error);
         return nullptr;
     }
-    return ReadAVSharedMemoryFromParcel(reply);
+    return ReadAVSharedMemoryFromParcel(reply, memCache_);
 }
 
 int32_t MediaDataSourceProxy::ReadAt(int64_t pos, uint32_t length)
@@ -128,5 +160,36 @@ int32_t MediaDataSourceProxy::GetSize(int64_t &size)
     int32_t ret = reply.ReadInt32();
     return ret;
 }
+
+int32_t MediaDataSourceProxy::SetRingBuffer(const std::shared_ptr<AVSharedMemory> &ringBuffer)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_SYNC);
+    int32_t ret = WriteAVSharedMemoryToParcel(ringBuffer, data);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "write ring buffer failed");
+    int error = Remote()->SendRequest(ListenerMsg::SET_RING_BUFFER, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("set ring buffer failed, error: %{public}d", error);
+        return MSERR_INVALID_OPERATION;
+    }
+    return reply.ReadInt32();
+}
+
+int32_t MediaDataSourceProxy::ReadAtRingBuffer(int64_t pos, uint32_t length, uint32_t offset)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_SYNC);
+    data.WriteInt64(pos);
+    data.WriteUint32(length);
+    data.WriteUint32(offset);
+    int error = Remote()->SendRequest(ListenerMsg::READ_AT_RING_BUFFER, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("read at ring buffer failed, error: %{public}d", error);
+        return SOURCE_ERROR_IO;
+    }
+    return reply.ReadInt32();
+}
 } // namespace Media
 } // namespace OHOS
\ No newline at end of file
@@ -17,11 +17,16 @@
 #define MEDIA_DATA_SOURCE_PROXY_H
 
 #include "i_standard_media_data_source.h"
+#include "avsharedmemory_ipc.h"
 #include "media_death_recipient.h"
 #include "nocopyable.h"
 
 namespace OHOS {
 namespace Media {
+/**
+ * The memory got by GetMem is shared with the client, which can still write it at any time. The caller
+ * must copy the data out before parsing it, and before the next read overwrites it.
+ */
 class MediaDataCallback : public IMediaDataSource {
 public:
     explicit MediaDataCallback(const sptr<IStandardMediaDataSource> &proxy);
@@ -31,9 +36,17 @@ public:
     int32_t ReadAt(int64_t pos, uint32_t length) override;
     int32_t ReadAt(uint32_t length) override;
     int32_t GetSize(int64_t &size) override;
+    /**
+     * Share a ring buffer with the client, the reads cost one transaction each and the memory got by
+     * GetMem is the ring, each read is written at its start. Keep the GET_MEM protocol if failed.
+     */
+    int32_t InitRingBuffer();
 
 private:
+    int32_t ReadAtRingBuffer(int64_t pos, uint32_t length);
+
     sptr<IStandardMediaDataSource> callbackProxy_ = nullptr;
+    std::shared_ptr<AVSharedMemory> ringBuffer_ = nullptr;
 };
 
 class MediaDataSourceProxy : public IRemoteProxy<IStandardMediaDataSource> {
@@ -45,9 +58,13 @@ public:
     int32_t ReadAt(int64_t pos, uint32_t length) override;
     int32_t ReadAt(uint32_t length) override;
     int32_t GetSize(int64_t &size) override;
+    int32_t SetRingBuffer(const std::shared_ptr<AVSharedMemory> &ringBuffer) override;
+    int32_t ReadAtRingBuffer(int64_t pos, uint32_t length, uint32_t offset) override;
 
 private:
     static inline BrokerDelegator<MediaDataSourceProxy> delegator_;
+    // the client usually recycles a few memories, keep their mappings across the reads.
+    AVSharedMemoryCache memCache_;
 };
 } // namespace Media
 } // namespace OHOS
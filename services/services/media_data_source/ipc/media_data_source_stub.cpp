@@ -14,10 +14,12 @@
  */
 
 #include "media_data_source_stub.h"
+#include <algorithm>
 #include "media_log.h"
 #include "media_errors.h"
 #include "media_data_source.h"
 #include "avsharedmemory_ipc.h"
+#include "securec.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "MediaDataSourceStubProxy"};
@@ -64,6 +66,18 @@ int MediaDataSourceStub::OnRemoteRequest(uint32_t code, MessageParcel &data, Mes
             std::shared_ptr<AVSharedMemory> mem = GetMem();
             return WriteAVSharedMemoryToParcel(mem, reply);
         }
+        case ListenerMsg::SET_RING_BUFFER: {
+            std::shared_ptr<AVSharedMemory> ringBuffer = ReadAVSharedMemoryFromParcel(data);
+            reply.WriteInt32(SetRingBuffer(ringBuffer));
+            return MSERR_OK;
+        }
+        case ListenerMsg::READ_AT_RING_BUFFER: {
+            int64_t pos = data.ReadInt64();
+            uint32_t length = data.ReadUint32();
+            uint32_t offset = data.ReadUint32();
+            reply.WriteInt32(ReadAtRingBuffer(pos, length, offset));
+            return MSERR_OK;
+        }
         default: {
             MEDIA_LOGE("default case, need check MediaDataSourceStub");
             return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
@@ -94,5 +108,39 @@ int32_t MediaDataSourceStub::GetSize(int64_t &size)
     CHECK_AND_RETURN_RET_LOG(dataSrc_ != nullptr, MSERR_INVALID_OPERATION, "dataSrc_ is nullptr");
     return dataSrc_->GetSize(size);
 }
+
+int32_t MediaDataSourceStub::SetRingBuffer(const std::shared_ptr<AVSharedMemory> &ringBuffer)
+{
+    CHECK_AND_RETURN_RET_LOG(ringBuffer != nullptr && ringBuffer->GetBase() != nullptr, MSERR_INVALID_VAL,
+        "invalid ring buffer");
+    CHECK_AND_RETURN_RET_LOG((ringBuffer->GetFlags() & AVSharedMemory::FLAGS_READ_ONLY) == 0, MSERR_INVALID_VAL,
+        "ring buffer is read only");
+    std::unique_lock<std::mutex> lock(mutex_);
+    ringBuffer_ = ringBuffer;
+    return MSERR_OK;
+}
+
+int32_t MediaDataSourceStub::ReadAtRingBuffer(int64_t pos, uint32_t length, uint32_t offset)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(ringBuffer_ != nullptr, SOURCE_ERROR_IO, "ring buffer is not set");
+    uint32_t ringSize = static_cast<uint32_t>(ringBuffer_->GetSize());
+    CHECK_AND_RETURN_RET_LOG(offset <= ringSize && length <= ringSize - offset, SOURCE_ERROR_IO,
+        "invalid offset %{public}u or length %{public}u", offset, length);
+
+    int32_t realLen = pos < 0 ? ReadAt(length) : ReadAt(pos, length);
+    if (realLen <= 0) {
+        return realLen;
+    }
+
+    std::shared_ptr<AVSharedMemory> mem = GetMem();
+    CHECK_AND_RETURN_RET_LOG(mem != nullptr && mem->GetBase() != nullptr, SOURCE_ERROR_IO, "get mem failed");
+    uint32_t copyLen = std::min({ static_cast<uint32_t>(realLen), static_cast<uint32_t>(mem->GetSize()), length });
+    if (memcpy_s(ringBuffer_->GetBase() + offset, length, mem->GetBase(), copyLen) != EOK) {
+        MEDIA_LOGE("copy into ring buffer failed");
+        return SOURCE_ERROR_IO;
+    }
+    return static_cast<int32_t>(copyLen);
+}
 } // namespace Media
 } // namespace OHOS
\ No newline at end of file
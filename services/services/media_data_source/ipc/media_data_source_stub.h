@@ -16,6 +16,7 @@
 #ifndef MEDIA_DATA_SOURCE_STUB_H
 #define MEDIA_DATA_SOURCE_STUB_H
 
+#include <mutex>
 #include "i_standard_media_data_source.h"
 #include "media_death_recipient.h"
 #include "nocopyable.h"
@@ -32,9 +33,13 @@ public:
     int32_t ReadAt(int64_t pos, uint32_t length) override;
     int32_t ReadAt(uint32_t length) override;
     int32_t GetSize(int64_t &size) override;
+    int32_t SetRingBuffer(const std::shared_ptr<AVSharedMemory> &ringBuffer) override;
+    int32_t ReadAtRingBuffer(int64_t pos, uint32_t length, uint32_t offset) override;
 
 private:
     std::shared_ptr<IMediaDataSource> dataSrc_ = nullptr;
+    std::shared_ptr<AVSharedMemory> ringBuffer_ = nullptr;
+    std::mutex mutex_;
 };
 } // namespace Media
 } // namespace OHOS
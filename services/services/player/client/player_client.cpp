@@ -69,6 +69,7 @@ void PlayerClient::MediaServerDied()
     std::lock_guard<std::mutex> lock(mutex_);
     playerProxy_ = nullptr;
     listenerStub_ = nullptr;
+    clock_ = nullptr;
     if (callback_ != nullptr) {
         callback_->OnError(PLAYER_ERROR, MSERR_SERVICE_DIED);
     }
@@ -95,6 +96,27 @@ int32_t PlayerClient::SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc
     return playerProxy_->SetSource(object);
 }
 
+int32_t PlayerClient::SetSource(int32_t fd, int64_t offset, int64_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(playerProxy_ != nullptr, MSERR_NO_MEMORY, "player service does not exist..");
+    return playerProxy_->SetSource(fd, offset, size);
+}
+
+int32_t PlayerClient::SetNextSource(const std::string &uri)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(playerProxy_ != nullptr, MSERR_NO_MEMORY, "player service does not exist..");
+    return playerProxy_->SetNextSource(uri);
+}
+
+int32_t PlayerClient::SetNextSource(int32_t fd, int64_t offset, int64_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(playerProxy_ != nullptr, MSERR_NO_MEMORY, "player service does not exist..");
+    return playerProxy_->SetNextSource(fd, offset, size);
+}
+
 int32_t PlayerClient::Play()
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -167,6 +189,16 @@ int32_t PlayerClient::GetCurrentTime(int32_t &currentTime)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     CHECK_AND_RETURN_RET_LOG(playerProxy_ != nullptr, MSERR_NO_MEMORY, "player service does not exist..");
+    if (!clockFetched_) {
+        clockFetched_ = true;
+        std::shared_ptr<AVSharedMemory> memory = playerProxy_->GetClockMemory();
+        if (memory != nullptr) {
+            clock_ = std::make_unique<PlayerClockReader>(memory);
+        }
+    }
+    if (clock_ != nullptr && clock_->GetCurrentTime(currentTime)) {
+        return MSERR_OK;
+    }
     return playerProxy_->GetCurrentTime(currentTime);
 }
 
@@ -220,6 +252,13 @@ int32_t PlayerClient::SetLooping(bool loop)
     return playerProxy_->SetLooping(loop);
 }
 
+int32_t PlayerClient::SetAudioOnly(bool audioOnly)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(playerProxy_ != nullptr, MSERR_NO_MEMORY, "player service does not exist..");
+    return playerProxy_->SetAudioOnly(audioOnly);
+}
+
 int32_t PlayerClient::SetPlayerCallback(const std::shared_ptr<PlayerCallback> &callback)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -20,6 +20,7 @@
 #include "i_standard_player_service.h"
 #include "player_listener_stub.h"
 #include "media_data_source_stub.h"
+#include "player_clock.h"
 
 namespace OHOS {
 namespace Media {
@@ -32,6 +33,9 @@ public:
     // IPlayerService override
     int32_t SetSource(const std::string &uri) override;
     int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc) override;
+    int32_t SetSource(int32_t fd, int64_t offset, int64_t size) override;
+    int32_t SetNextSource(const std::string &uri) override;
+    int32_t SetNextSource(int32_t fd, int64_t offset, int64_t size) override;
     int32_t Play() override;
     int32_t Prepare() override;
     int32_t PrepareAsync() override;
@@ -49,6 +53,7 @@ public:
     bool IsPlaying() override;
     bool IsLooping() override;
     int32_t SetLooping(bool loop) override;
+    int32_t SetAudioOnly(bool audioOnly) override;
     int32_t SetPlayerCallback(const std::shared_ptr<PlayerCallback> &callback) override;
 
     // PlayerClient
@@ -60,6 +65,9 @@ private:
     sptr<IStandardPlayerService> playerProxy_ = nullptr;
     sptr<PlayerListenerStub> listenerStub_ = nullptr;
     sptr<MediaDataSourceStub> dataSrcStub_ = nullptr;
+    // fetched at the first GetCurrentTime, the position is read from the server if it is not available.
+    std::unique_ptr<PlayerClockReader> clock_ = nullptr;
+    bool clockFetched_ = false;
     std::shared_ptr<PlayerCallback> callback_ = nullptr;
     std::mutex mutex_;
 };
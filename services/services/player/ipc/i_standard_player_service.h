@@ -21,6 +21,7 @@
 #include "iremote_proxy.h"
 #include "iremote_stub.h"
 #include "player.h"
+#include "avsharedmemory.h"
 
 namespace OHOS {
 namespace Media {
@@ -30,6 +31,9 @@ public:
     virtual int32_t SetListenerObject(const sptr<IRemoteObject> &object) = 0;
     virtual int32_t SetSource(const std::string &uri) = 0;
     virtual int32_t SetSource(const sptr<IRemoteObject> &object) = 0;
+    virtual int32_t SetSource(int32_t fd, int64_t offset, int64_t size) = 0;
+    virtual int32_t SetNextSource(const std::string &uri) = 0;
+    virtual int32_t SetNextSource(int32_t fd, int64_t offset, int64_t size) = 0;
     virtual int32_t Play() = 0;
     virtual int32_t Prepare() = 0;
     virtual int32_t PrepareAsync() = 0;
@@ -47,8 +51,11 @@ public:
     virtual bool IsPlaying() = 0;
     virtual bool IsLooping() = 0;
     virtual int32_t SetLooping(bool loop) = 0;
+    virtual int32_t SetAudioOnly(bool audioOnly) = 0;
     virtual int32_t DestroyStub() = 0;
     virtual int32_t SetPlayerCallback() = 0;
+    // the read-only clock page of this player, see PlayerClockPage.
+    virtual std::shared_ptr<AVSharedMemory> GetClockMemory() = 0;
 
     /**
      * IPC code ID
@@ -76,6 +83,11 @@ public:
         SET_LOOPING,
         DESTROY,
         SET_CALLBACK,
+        SET_FD_SOURCE,
+        SET_NEXT_SOURCE,
+        SET_NEXT_FD_SOURCE,
+        GET_CLOCK_MEMORY,
+        SET_AUDIO_ONLY,
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"IStandardPlayerService");
@@ -93,6 +93,9 @@ void PlayerListenerStub::OnInfo(PlayerOnInfoType type, int32_t extra, const Form
         case INFO_TYPE_EXTRA_FORMAT:
             cb->OnInfo(INFO_TYPE_EXTRA_FORMAT, extra, infoBody);
             break;
+        case INFO_TYPE_NEXT_SOURCE_START:
+            cb->OnInfo(INFO_TYPE_NEXT_SOURCE_START, extra, infoBody);
+            break;
         default:
             MEDIA_LOGE("default case, need check PlayerListenerStub");
             break;
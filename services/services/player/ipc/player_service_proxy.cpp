@@ -15,6 +15,7 @@
 
 #include "player_service_proxy.h"
 #include "player_listener_stub.h"
+#include "avsharedmemory_ipc.h"
 #include "media_log.h"
 #include "media_errors.h"
 
@@ -79,6 +80,52 @@ int32_t PlayerServiceProxy::SetSource(const sptr<IRemoteObject> &object)
     return reply.ReadInt32();
 }
 
+int32_t PlayerServiceProxy::SetSource(int32_t fd, int64_t offset, int64_t size)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    (void)data.WriteFileDescriptor(fd);
+    (void)data.WriteInt64(offset);
+    (void)data.WriteInt64(size);
+    int error = Remote()->SendRequest(SET_FD_SOURCE, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("Set fd source failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
+int32_t PlayerServiceProxy::SetNextSource(const std::string &uri)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteString(uri);
+    int error = Remote()->SendRequest(SET_NEXT_SOURCE, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("Set next source failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
+int32_t PlayerServiceProxy::SetNextSource(int32_t fd, int64_t offset, int64_t size)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    (void)data.WriteFileDescriptor(fd);
+    (void)data.WriteInt64(offset);
+    (void)data.WriteInt64(size);
+    int error = Remote()->SendRequest(SET_NEXT_FD_SOURCE, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("Set next fd source failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
 int32_t PlayerServiceProxy::Play()
 {
     MessageParcel data;
@@ -325,6 +372,20 @@ int32_t PlayerServiceProxy::SetLooping(bool loop)
     return reply.ReadInt32();
 }
 
+int32_t PlayerServiceProxy::SetAudioOnly(bool audioOnly)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteBool(audioOnly);
+    int error = Remote()->SendRequest(SET_AUDIO_ONLY, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("Set audio only failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
 int32_t PlayerServiceProxy::DestroyStub()
 {
     MessageParcel data;
@@ -350,5 +411,19 @@ int32_t PlayerServiceProxy::SetPlayerCallback()
     }
     return reply.ReadInt32();
 }
+
+std::shared_ptr<AVSharedMemory> PlayerServiceProxy::GetClockMemory()
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    int error = Remote()->SendRequest(GET_CLOCK_MEMORY, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("get clock memory failed, error: %{public}d", error);
+        return nullptr;
+    }
+    CHECK_AND_RETURN_RET_LOG(reply.ReadInt32() == MSERR_OK, nullptr, "no clock memory");
+    return ReadAVSharedMemoryFromParcel(reply);
+}
 } // namespace Media
 } // namespace OHOS
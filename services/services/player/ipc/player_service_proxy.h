@@ -27,6 +27,9 @@ public:
     int32_t SetListenerObject(const sptr<IRemoteObject> &object) override;
     int32_t SetSource(const std::string &uri) override;
     int32_t SetSource(const sptr<IRemoteObject> &object) override;
+    int32_t SetSource(int32_t fd, int64_t offset, int64_t size) override;
+    int32_t SetNextSource(const std::string &uri) override;
+    int32_t SetNextSource(int32_t fd, int64_t offset, int64_t size) override;
     int32_t Play() override;
     int32_t Prepare() override;
     int32_t PrepareAsync() override;
@@ -44,8 +47,10 @@ public:
     bool IsPlaying() override;
     bool IsLooping() override;
     int32_t SetLooping(bool loop) override;
+    int32_t SetAudioOnly(bool audioOnly) override;
     int32_t DestroyStub() override;
     int32_t SetPlayerCallback() override;
+    std::shared_ptr<AVSharedMemory> GetClockMemory() override;
 
 private:
     static inline BrokerDelegator<PlayerServiceProxy> delegator_;
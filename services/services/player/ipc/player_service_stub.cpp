@@ -14,10 +14,13 @@
  */
 
 #include "player_service_stub.h"
+#include <unistd.h>
 #include "player_listener_proxy.h"
 #include "media_data_source_proxy.h"
+#include "avsharedmemory_ipc.h"
 #include "media_server_manager.h"
 #include "media_log.h"
+#include "media_trace.h"
 #include "media_errors.h"
 
 namespace {
@@ -71,8 +74,13 @@ int32_t PlayerServiceStub::Init()
     playerFuncs_[IS_PLAYING] = &PlayerServiceStub::IsPlaying;
     playerFuncs_[IS_LOOPING] = &PlayerServiceStub::IsLooping;
     playerFuncs_[SET_LOOPING] = &PlayerServiceStub::SetLooping;
+    playerFuncs_[SET_AUDIO_ONLY] = &PlayerServiceStub::SetAudioOnly;
     playerFuncs_[DESTROY] = &PlayerServiceStub::DestroyStub;
     playerFuncs_[SET_CALLBACK] = &PlayerServiceStub::SetPlayerCallback;
+    playerFuncs_[SET_FD_SOURCE] = &PlayerServiceStub::SetFdSource;
+    playerFuncs_[SET_NEXT_SOURCE] = &PlayerServiceStub::SetNextSource;
+    playerFuncs_[SET_NEXT_FD_SOURCE] = &PlayerServiceStub::SetNextFdSource;
+    playerFuncs_[GET_CLOCK_MEMORY] = &PlayerServiceStub::GetClockMemory;
     return MSERR_OK;
 }
 
@@ -89,6 +97,7 @@ int PlayerServiceStub::OnRemoteRequest(uint32_t code, MessageParcel &data, Messa
     MessageOption &option)
 {
     MEDIA_LOGI("Stub: OnRemoteRequest of code: %{public}d is received", code);
+    MediaTraceScope trace("PlayerServiceStub::OnRemoteRequest", MEDIA_TRACE_IPC, code);
 
     auto itFunc = playerFuncs_.find(code);
     if (itFunc != playerFuncs_.end()) {
@@ -134,12 +143,33 @@ int32_t PlayerServiceStub::SetSource(const sptr<IRemoteObject> &object)
     sptr<IStandardMediaDataSource> proxy = iface_cast<IStandardMediaDataSource>(object);
     CHECK_AND_RETURN_RET_LOG(proxy != nullptr, MSERR_NO_MEMORY, "failed to convert MeidaDataSourceProxy");
 
-    std::shared_ptr<IMediaDataSource> mediaDataSrc = std::make_shared<MediaDataCallback>(proxy);
+    std::shared_ptr<MediaDataCallback> mediaDataSrc = std::make_shared<MediaDataCallback>(proxy);
     CHECK_AND_RETURN_RET_LOG(mediaDataSrc != nullptr, MSERR_NO_MEMORY, "failed to new PlayerListenerCallback");
+    if (mediaDataSrc->InitRingBuffer() != MSERR_OK) {
+        MEDIA_LOGW("ring buffer is unavailable, read the data source by GetMem");
+    }
 
     return playerServer_->SetSource(mediaDataSrc);
 }
 
+int32_t PlayerServiceStub::SetSource(int32_t fd, int64_t offset, int64_t size)
+{
+    CHECK_AND_RETURN_RET_LOG(playerServer_ != nullptr, MSERR_NO_MEMORY, "player server is nullptr");
+    return playerServer_->SetSource(fd, offset, size);
+}
+
+int32_t PlayerServiceStub::SetNextSource(const std::string &uri)
+{
+    CHECK_AND_RETURN_RET_LOG(playerServer_ != nullptr, MSERR_NO_MEMORY, "player server is nullptr");
+    return playerServer_->SetNextSource(uri);
+}
+
+int32_t PlayerServiceStub::SetNextSource(int32_t fd, int64_t offset, int64_t size)
+{
+    CHECK_AND_RETURN_RET_LOG(playerServer_ != nullptr, MSERR_NO_MEMORY, "player server is nullptr");
+    return playerServer_->SetNextSource(fd, offset, size);
+}
+
 int32_t PlayerServiceStub::Play()
 {
     CHECK_AND_RETURN_RET_LOG(playerServer_ != nullptr, MSERR_NO_MEMORY, "player server is nullptr");
@@ -243,6 +273,12 @@ int32_t PlayerServiceStub::SetLooping(bool loop)
     return playerServer_->SetLooping(loop);
 }
 
+int32_t PlayerServiceStub::SetAudioOnly(bool audioOnly)
+{
+    CHECK_AND_RETURN_RET_LOG(playerServer_ != nullptr, MSERR_NO_MEMORY, "player server is nullptr");
+    return playerServer_->SetAudioOnly(audioOnly);
+}
+
 int32_t PlayerServiceStub::SetPlayerCallback()
 {
     MEDIA_LOGD("SetPlayerCallback");
@@ -250,6 +286,12 @@ int32_t PlayerServiceStub::SetPlayerCallback()
     return playerServer_->SetPlayerCallback(playerCallback_);
 }
 
+std::shared_ptr<AVSharedMemory> PlayerServiceStub::GetClockMemory()
+{
+    CHECK_AND_RETURN_RET_LOG(playerServer_ != nullptr, nullptr, "player server is nullptr");
+    return playerServer_->GetClockMemory();
+}
+
 int32_t PlayerServiceStub::SetListenerObject(MessageParcel &data, MessageParcel &reply)
 {
     sptr<IRemoteObject> object = data.ReadRemoteObject();
@@ -271,6 +313,37 @@ int32_t PlayerServiceStub::SetMediaDataSource(MessageParcel &data, MessageParcel
     return MSERR_OK;
 }
 
+int32_t PlayerServiceStub::SetFdSource(MessageParcel &data, MessageParcel &reply)
+{
+    int32_t fd = data.ReadFileDescriptor();
+    int64_t offset = data.ReadInt64();
+    int64_t size = data.ReadInt64();
+    reply.WriteInt32(SetSource(fd, offset, size));
+    if (fd >= 0) {
+        (void)::close(fd);
+    }
+    return MSERR_OK;
+}
+
+int32_t PlayerServiceStub::SetNextSource(MessageParcel &data, MessageParcel &reply)
+{
+    std::string uri = data.ReadString();
+    reply.WriteInt32(SetNextSource(uri));
+    return MSERR_OK;
+}
+
+int32_t PlayerServiceStub::SetNextFdSource(MessageParcel &data, MessageParcel &reply)
+{
+    int32_t fd = data.ReadFileDescriptor();
+    int64_t offset = data.ReadInt64();
+    int64_t size = data.ReadInt64();
+    reply.WriteInt32(SetNextSource(fd, offset, size));
+    if (fd >= 0) {
+        (void)::close(fd);
+    }
+    return MSERR_OK;
+}
+
 int32_t PlayerServiceStub::Play(MessageParcel &data, MessageParcel &reply)
 {
     reply.WriteInt32(Play());
@@ -411,6 +484,13 @@ int32_t PlayerServiceStub::SetLooping(MessageParcel &data, MessageParcel &reply)
     return MSERR_OK;
 }
 
+int32_t PlayerServiceStub::SetAudioOnly(MessageParcel &data, MessageParcel &reply)
+{
+    bool audioOnly = data.ReadBool();
+    reply.WriteInt32(SetAudioOnly(audioOnly));
+    return MSERR_OK;
+}
+
 int32_t PlayerServiceStub::DestroyStub(MessageParcel &data, MessageParcel &reply)
 {
     (void)data;
@@ -424,5 +504,17 @@ int32_t PlayerServiceStub::SetPlayerCallback(MessageParcel &data, MessageParcel
     reply.WriteInt32(SetPlayerCallback());
     return MSERR_OK;
 }
+
+int32_t PlayerServiceStub::GetClockMemory(MessageParcel &data, MessageParcel &reply)
+{
+    (void)data;
+    std::shared_ptr<AVSharedMemory> memory = GetClockMemory();
+    if (memory == nullptr) {
+        reply.WriteInt32(MSERR_INVALID_OPERATION);
+        return MSERR_OK;
+    }
+    reply.WriteInt32(MSERR_OK);
+    return WriteAVSharedMemoryToParcel(memory, reply);
+}
 } // namespace Media
 } // namespace OHOS
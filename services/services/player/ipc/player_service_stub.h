@@ -35,6 +35,9 @@ public:
     int32_t SetListenerObject(const sptr<IRemoteObject> &object) override;
     int32_t SetSource(const std::string &uri) override;
     int32_t SetSource(const sptr<IRemoteObject> &object) override;
+    int32_t SetSource(int32_t fd, int64_t offset, int64_t size) override;
+    int32_t SetNextSource(const std::string &uri) override;
+    int32_t SetNextSource(int32_t fd, int64_t offset, int64_t size) override;
     int32_t Play() override;
     int32_t Prepare() override;
     int32_t PrepareAsync() override;
@@ -52,8 +55,10 @@ public:
     bool IsPlaying() override;
     bool IsLooping() override;
     int32_t SetLooping(bool loop) override;
+    int32_t SetAudioOnly(bool audioOnly) override;
     int32_t DestroyStub() override;
     int32_t SetPlayerCallback() override;
+    std::shared_ptr<AVSharedMemory> GetClockMemory() override;
 
 private:
     PlayerServiceStub();
@@ -61,6 +66,9 @@ private:
     int32_t SetListenerObject(MessageParcel &data, MessageParcel &reply);
     int32_t SetSource(MessageParcel &data, MessageParcel &reply);
     int32_t SetMediaDataSource(MessageParcel &data, MessageParcel &reply);
+    int32_t SetFdSource(MessageParcel &data, MessageParcel &reply);
+    int32_t SetNextSource(MessageParcel &data, MessageParcel &reply);
+    int32_t SetNextFdSource(MessageParcel &data, MessageParcel &reply);
     int32_t Play(MessageParcel &data, MessageParcel &reply);
     int32_t Prepare(MessageParcel &data, MessageParcel &reply);
     int32_t PrepareAsync(MessageParcel &data, MessageParcel &reply);
@@ -78,12 +86,14 @@ private:
     int32_t IsPlaying(MessageParcel &data, MessageParcel &reply);
     int32_t IsLooping(MessageParcel &data, MessageParcel &reply);
     int32_t SetLooping(MessageParcel &data, MessageParcel &reply);
+    int32_t SetAudioOnly(MessageParcel &data, MessageParcel &reply);
     int32_t DestroyStub(MessageParcel &data, MessageParcel &reply);
     int32_t SetPlayerCallback(MessageParcel &data, MessageParcel &reply);
+    int32_t GetClockMemory(MessageParcel &data, MessageParcel &reply);
 
     std::mutex mutex_;
     std::shared_ptr<PlayerCallback> playerCallback_ = nullptr;
-    std::shared_ptr<IPlayerService> playerServer_ = nullptr;
+    std::shared_ptr<PlayerServer> playerServer_ = nullptr;
     std::map<uint32_t, PlayerStubFunc> playerFuncs_;
 };
 }
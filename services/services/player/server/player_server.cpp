@@ -14,19 +14,30 @@
  */
 
 #include "player_server.h"
+#include <cerrno>
+#include <map>
+#include <unistd.h>
 #include "media_log.h"
 #include "media_errors.h"
 #include "engine_factory_repo.h"
+#include "uri_helper.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "PlayerServer"};
+const std::map<OHOS::Media::PlaybackRateMode, double> PLAYBACK_RATES = {
+    { OHOS::Media::SPEED_FORWARD_0_75_X, 0.75 },
+    { OHOS::Media::SPEED_FORWARD_1_00_X, 1.00 },
+    { OHOS::Media::SPEED_FORWARD_1_25_X, 1.25 },
+    { OHOS::Media::SPEED_FORWARD_1_75_X, 1.75 },
+    { OHOS::Media::SPEED_FORWARD_2_00_X, 2.00 },
+};
 }
 
 namespace OHOS {
 namespace Media {
 const std::string START_TAG = "PlayerCreate->Start";
 const std::string STOP_TAG = "PlayerStop->Destroy";
-std::shared_ptr<IPlayerService> PlayerServer::Create()
+std::shared_ptr<PlayerServer> PlayerServer::Create()
 {
     std::shared_ptr<PlayerServer> server = std::make_shared<PlayerServer>();
     CHECK_AND_RETURN_RET_LOG(server != nullptr, nullptr, "failed to new PlayerServer");
@@ -45,17 +56,29 @@ PlayerServer::PlayerServer()
 PlayerServer::~PlayerServer()
 {
     (void)Release();
+    CloseSourceFd();
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
 }
 
 int32_t PlayerServer::Init()
 {
+    int32_t ret = clock_.Init();
+    if (ret != MSERR_OK) {
+        MEDIA_LOGW("init the clock page failed, the client gets the position by ipc");
+    }
     return MSERR_OK;
 }
 
+std::shared_ptr<AVSharedMemory> PlayerServer::GetClockMemory() const
+{
+    return clock_.GetMemory();
+}
+
 int32_t PlayerServer::SetSource(const std::string &uri)
 {
     std::lock_guard<std::mutex> lock(mutex_);
+    // the fd in the uri is not valid in this process, the fd source must be set by the fd.
+    CHECK_AND_RETURN_RET_LOG(!UriHelper(uri).IsFdScheme(), MSERR_INVALID_VAL, "fd uri is not accepted");
     int32_t ret = InitPlayEngine(uri);
     CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, MSERR_INVALID_OPERATION, "SetSource Failed!");
     return ret;
@@ -73,6 +96,86 @@ int32_t PlayerServer::SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc
     return ret;
 }
 
+int32_t PlayerServer::SetSource(int32_t fd, int64_t offset, int64_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(fd >= 0 && offset >= 0, MSERR_INVALID_VAL, "invalid fd source");
+    CHECK_AND_RETURN_RET_LOG(status_ == PLAYER_IDLE, MSERR_INVALID_OPERATION,
+        "current state is: %{public}d, not support SetSource", status_);
+
+    int32_t dupFd = dup(fd);
+    CHECK_AND_RETURN_RET_LOG(dupFd >= 0, MSERR_INVALID_VAL, "dup fd failed, errno: %{public}d", errno);
+    int32_t ret = InitPlayEngine(UriHelper::MakeFdUri(dupFd, offset, size));
+    if (ret != MSERR_OK) {
+        playerEngine_ = nullptr;
+        (void)::close(dupFd);
+        MEDIA_LOGE("SetSource Failed!");
+        return MSERR_INVALID_OPERATION;
+    }
+    CloseSourceFd();
+    sourceFd_ = dupFd;
+    return MSERR_OK;
+}
+
+void PlayerServer::CloseSourceFd()
+{
+    if (sourceFd_ >= 0) {
+        (void)::close(sourceFd_);
+        sourceFd_ = -1;
+    }
+    if (nextSourceFd_ >= 0) {
+        (void)::close(nextSourceFd_);
+        nextSourceFd_ = -1;
+    }
+    nextSourceStarted_ = false;
+}
+
+int32_t PlayerServer::SetNextSource(const std::string &uri)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(!UriHelper(uri).IsFdScheme(), MSERR_INVALID_VAL, "fd uri is not accepted");
+    return OnSetNextSource(uri, -1);
+}
+
+int32_t PlayerServer::SetNextSource(int32_t fd, int64_t offset, int64_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(fd >= 0 && offset >= 0, MSERR_INVALID_VAL, "invalid fd source");
+
+    int32_t dupFd = dup(fd);
+    CHECK_AND_RETURN_RET_LOG(dupFd >= 0, MSERR_INVALID_VAL, "dup fd failed, errno: %{public}d", errno);
+    int32_t ret = OnSetNextSource(UriHelper::MakeFdUri(dupFd, offset, size), dupFd);
+    if (ret != MSERR_OK) {
+        (void)::close(dupFd);
+    }
+    return ret;
+}
+
+int32_t PlayerServer::OnSetNextSource(const std::string &uri, int32_t fd)
+{
+    CHECK_AND_RETURN_RET_LOG(playerEngine_ != nullptr, MSERR_NO_MEMORY, "playerEngine_ is nullptr");
+    if (status_ != PLAYER_PREPARED && status_ != PLAYER_STARTED && status_ != PLAYER_PAUSED) {
+        MEDIA_LOGE("Can not SetNextSource, currentState is %{public}d", status_);
+        return MSERR_INVALID_OPERATION;
+    }
+
+    int32_t ret = playerEngine_->SetNextSource(uri);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Engine SetNextSource Failed!");
+
+    if (nextSourceStarted_.exchange(false)) {
+        // the previous next source has become the current one, the old current one is done.
+        if (sourceFd_ >= 0) {
+            (void)::close(sourceFd_);
+        }
+        sourceFd_ = nextSourceFd_;
+    } else if (nextSourceFd_ >= 0) {
+        // replaced before the playbin takes it, the engine refuses once it is taken.
+        (void)::close(nextSourceFd_);
+    }
+    nextSourceFd_ = fd;
+    return MSERR_OK;
+}
+
 int32_t PlayerServer::InitPlayEngine(const std::string &uri)
 {
     if (status_ != PLAYER_IDLE) {
@@ -84,9 +187,17 @@ int32_t PlayerServer::InitPlayEngine(const std::string &uri)
     auto engineFactory = EngineFactoryRepo::Instance().GetEngineFactory(IEngineFactory::Scene::SCENE_PLAYBACK, uri);
     CHECK_AND_RETURN_RET_LOG(engineFactory != nullptr, MSERR_CREATE_PLAYER_ENGINE_FAILED,
         "failed to get engine factory");
-    playerEngine_ = engineFactory->CreatePlayerEngine();
+    if (idleEngine_ != nullptr && idleEngineFactory_ == engineFactory) {
+        MEDIA_LOGI("reuse the engine kept by the last reset");
+        playerEngine_ = std::move(idleEngine_);
+    } else {
+        playerEngine_ = engineFactory->CreatePlayerEngine();
+    }
+    idleEngine_ = nullptr;
+    idleEngineFactory_ = nullptr;
     CHECK_AND_RETURN_RET_LOG(playerEngine_ != nullptr, MSERR_CREATE_PLAYER_ENGINE_FAILED,
         "failed to create player engine");
+    engineFactory_ = engineFactory;
     int32_t ret = MSERR_OK;
     if (dataSrc_ == nullptr) {
         ret = playerEngine_->SetSource(uri);
@@ -123,7 +234,8 @@ int32_t PlayerServer::OnPrepare(bool async)
     }
 
     CHECK_AND_RETURN_RET_LOG(playerEngine_ != nullptr, MSERR_NO_MEMORY, "playerEngine_ is nullptr");
-    int32_t ret = MSERR_OK;
+    int32_t ret = playerEngine_->SetAudioOnly(audioOnly_);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, MSERR_INVALID_OPERATION, "Engine SetAudioOnly Failed!");
     if (surface_ != nullptr) {
         ret = playerEngine_->SetVideoSurface(surface_);
         CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, MSERR_INVALID_OPERATION, "Engine SetVideoSurface Failed!");
@@ -243,8 +355,12 @@ int32_t PlayerServer::OnReset()
     CHECK_AND_RETURN_RET_LOG(playerEngine_ != nullptr, MSERR_NO_MEMORY, "playerEngine_ is nullptr");
     int32_t ret = playerEngine_->Reset();
     CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, MSERR_INVALID_OPERATION, "Engine Reset Failed!");
+    idleEngine_ = std::move(playerEngine_);
+    idleEngineFactory_ = std::move(engineFactory_);
     playerEngine_ = nullptr;
+    engineFactory_ = nullptr;
     dataSrc_ = nullptr;
+    CloseSourceFd();
     Format format;
     OnInfo(INFO_TYPE_STATE_CHANGE, PLAYER_IDLE, format);
     stopTimeMonitor_.FinishTime();
@@ -259,6 +375,8 @@ int32_t PlayerServer::Release()
         playerCb_ = nullptr;
     }
     (void)OnReset();
+    idleEngine_ = nullptr;
+    idleEngineFactory_ = nullptr;
     return MSERR_OK;
 }
 
@@ -290,6 +408,7 @@ bool PlayerServer::IsValidSeekMode(PlayerSeekMode mode)
         case SEEK_NEXT_SYNC:
         case SEEK_CLOSEST_SYNC:
         case SEEK_CLOSEST:
+        case SEEK_SCRUB:
             break;
         default:
             MEDIA_LOGE("Unknown seek mode %{public}d", mode);
@@ -364,6 +483,10 @@ int32_t PlayerServer::SetPlaybackSpeed(PlaybackRateMode mode)
 
     int ret = playerEngine_->SetPlaybackSpeed(mode);
     CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, MSERR_INVALID_OPERATION, "Engine SetPlaybackSpeed Failed!");
+    auto it = PLAYBACK_RATES.find(mode);
+    if (it != PLAYBACK_RATES.end()) {
+        clock_.SetRate(it->second);
+    }
     return MSERR_OK;
 }
 
@@ -434,6 +557,18 @@ int32_t PlayerServer::SetLooping(bool loop)
     return ret;
 }
 
+int32_t PlayerServer::SetAudioOnly(bool audioOnly)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // the mode is given to the engine at the prepare, the gstplayer is built for it then.
+    if (status_ != PLAYER_IDLE && status_ != PLAYER_INITIALIZED) {
+        MEDIA_LOGE("current state: %{public}d, can not SetAudioOnly", status_);
+        return MSERR_INVALID_OPERATION;
+    }
+    audioOnly_ = audioOnly;
+    return MSERR_OK;
+}
+
 int32_t PlayerServer::SetPlayerCallback(const std::shared_ptr<PlayerCallback> &callback)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -466,6 +601,15 @@ void PlayerServer::OnInfo(PlayerOnInfoType type, int32_t extra, const Format &in
     if (type == INFO_TYPE_STATE_CHANGE) {
         status_ = static_cast<PlayerStates>(extra);
         MEDIA_LOGI("Callback State change, currentState is %{public}d", status_);
+        clock_.SetState(status_);
+    } else if (type == INFO_TYPE_NEXT_SOURCE_START) {
+        nextSourceStarted_ = true;
+        clock_.SetPosition(0);
+    } else if (type == INFO_TYPE_POSITION_UPDATE || type == INFO_TYPE_SEEKDONE) {
+        clock_.SetPosition(extra);
+    } else if (type == INFO_TYPE_MESSAGE &&
+        (extra == PLAYER_INFO_BUFFERING_START || extra == PLAYER_INFO_BUFFERING_END)) {
+        clock_.SetBuffering(extra == PLAYER_INFO_BUFFERING_START);
     }
 
     if (playerCb_ != nullptr) {
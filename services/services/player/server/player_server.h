@@ -16,22 +16,28 @@
 #ifndef PLAYER_SERVICE_SERVER_H
 #define PLAYER_SERVICE_SERVER_H
 
+#include <atomic>
 #include "i_player_service.h"
 #include "i_player_engine.h"
+#include "i_engine_factory.h"
 #include "time_monitor.h"
+#include "player_clock.h"
 #include "nocopyable.h"
 
 namespace OHOS {
 namespace Media {
 class PlayerServer : public IPlayerService, public IPlayerEngineObs {
 public:
-    static std::shared_ptr<IPlayerService> Create();
+    static std::shared_ptr<PlayerServer> Create();
     PlayerServer();
     virtual ~PlayerServer();
     DISALLOW_COPY_AND_MOVE(PlayerServer);
 
     int32_t SetSource(const std::string &uri) override;
     int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc) override;
+    int32_t SetSource(int32_t fd, int64_t offset, int64_t size) override;
+    int32_t SetNextSource(const std::string &uri) override;
+    int32_t SetNextSource(int32_t fd, int64_t offset, int64_t size) override;
     int32_t Play() override;
     int32_t Prepare() override;
     int32_t PrepareAsync() override;
@@ -49,7 +55,10 @@ public:
     bool IsPlaying() override;
     bool IsLooping() override;
     int32_t SetLooping(bool loop) override;
+    int32_t SetAudioOnly(bool audioOnly) override;
     int32_t SetPlayerCallback(const std::shared_ptr<PlayerCallback> &callback) override;
+    // the clock page for the remote client to compute the position, see PlayerClockPage.
+    std::shared_ptr<AVSharedMemory> GetClockMemory() const;
 
     // IPlayerEngineObs override
     void OnError(PlayerErrorType errorType, int32_t errorCode) override;
@@ -61,17 +70,28 @@ private:
     int32_t OnReset();
     int32_t InitPlayEngine(const std::string &uri);
     int32_t OnPrepare(bool async);
+    int32_t OnSetNextSource(const std::string &uri, int32_t fd);
+    void CloseSourceFd();
 
     std::unique_ptr<IPlayerEngine> playerEngine_ = nullptr;
+    std::shared_ptr<IEngineFactory> engineFactory_ = nullptr;
+    // the engine kept by the reset, reused by the next source selecting the same factory.
+    std::unique_ptr<IPlayerEngine> idleEngine_ = nullptr;
+    std::shared_ptr<IEngineFactory> idleEngineFactory_ = nullptr;
     std::shared_ptr<PlayerCallback> playerCb_ = nullptr;
     sptr<Surface> surface_ = nullptr;
     PlayerStates status_ = PLAYER_IDLE;
     std::mutex mutex_;
     std::mutex mutexCb_;
     bool looping_ = false;
+    bool audioOnly_ = false;
     TimeMonitor startTimeMonitor_;
     TimeMonitor stopTimeMonitor_;
     std::shared_ptr<IMediaDataSource> dataSrc_ = nullptr;
+    int32_t sourceFd_ = -1; // the dup of the fd source, read by the engine until reset.
+    int32_t nextSourceFd_ = -1;
+    std::atomic<bool> nextSourceStarted_ = false;
+    PlayerClockWriter clock_;
 };
 } // namespace Media
 } // namespace OHOS
@@ -18,6 +18,7 @@
 #include "recorder_listener_proxy.h"
 #include "media_server_manager.h"
 #include "media_log.h"
+#include "media_trace.h"
 #include "media_errors.h"
 
 namespace {
@@ -95,6 +96,7 @@ int RecorderServiceStub::OnRemoteRequest(uint32_t code, MessageParcel &data, Mes
     MessageOption &option)
 {
     MEDIA_LOGI("Stub: OnRemoteRequest of code: %{public}d is received", code);
+    MediaTraceScope trace("RecorderServiceStub::OnRemoteRequest", MEDIA_TRACE_IPC, code);
 
     auto itFunc = recFuncs_.find(code);
     if (itFunc != recFuncs_.end()) {
@@ -15,6 +15,7 @@
 
 #include "media_service_stub.h"
 #include "media_log.h"
+#include "media_trace.h"
 #include "media_errors.h"
 #include "media_server_manager.h"
 
@@ -79,6 +80,7 @@ int MediaServiceStub::OnRemoteRequest(uint32_t code, MessageParcel &data, Messag
     MessageOption &option)
 {
     MEDIA_LOGI("Stub: OnRemoteRequest of code: %{public}u is received", code);
+    MediaTraceScope trace("MediaServiceStub::OnRemoteRequest", MEDIA_TRACE_IPC, code);
 
     auto itFunc = mediaFuncs_.find(code);
     if (itFunc != mediaFuncs_.end()) {
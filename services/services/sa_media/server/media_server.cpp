@@ -14,13 +14,71 @@
  */
 
 #include "media_server.h"
+#include <cstdlib>
+#include <unistd.h>
 #include "iservice_registry.h"
 #include "media_log.h"
 #include "system_ability_definition.h"
 #include "media_server_manager.h"
+#include "media_errors.h"
+#include "task_queue.h"
+#include "media_trace.h"
+#include "avmetadata_cache.h"
+#include "avmetadatahelper_engine_pool.h"
+#include "avmetadata_scan_scheduler.h"
+#include "player_startup_stats.h"
+#include "scrub_stats.h"
+#include "string_ex.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "MediaServer"};
+constexpr int32_t CATEGORIES_BASE = 0; // accept both the decimal and the hexadecimal.
+
+/**
+ * hidumper -s <id> -a "trace on [categories]": enable the trace categories, all if not specified.
+ * hidumper -s <id> -a "trace off [categories]": disable the trace categories, all if not specified.
+ * hidumper -s <id> -a "trace": dump the trace events in the chrome trace event json format.
+ */
+void DumpTrace(const std::vector<std::string> &args, std::string &dumpString)
+{
+    using namespace OHOS::Media;
+    constexpr size_t commandIndex = 1;
+    constexpr size_t categoriesIndex = 2;
+    if (args.size() <= commandIndex) {
+        MediaTrace::DumpChromeTrace(dumpString);
+        return;
+    }
+
+    uint32_t categories = MEDIA_TRACE_ALL;
+    if (args.size() > categoriesIndex) {
+        categories = static_cast<uint32_t>(std::strtoul(args[categoriesIndex].c_str(), nullptr, CATEGORIES_BASE));
+    }
+    if (args[commandIndex] == "on") {
+        MediaTrace::EnableCategories(categories);
+        dumpString += "trace enabled\n";
+    } else if (args[commandIndex] == "off") {
+        MediaTrace::DisableCategories(categories);
+        dumpString += "trace disabled\n";
+    } else {
+        dumpString += "usage: trace [on|off [categories]]\n";
+    }
+}
+
+/**
+ * hidumper -s <id> -a "avmetadata clear": destroy the idle avmetadatahelper engines, so that the
+ * next sources start cold, used by the avmetadatahelper benchmark.
+ */
+void DumpAVMetadata(const std::vector<std::string> &args, std::string &dumpString)
+{
+    using namespace OHOS::Media;
+    constexpr size_t commandIndex = 1;
+    if (args.size() > commandIndex && args[commandIndex] == "clear") {
+        AVMetadataHelperEnginePool::GetInstance().Clear();
+        dumpString += "avmetadata engines cleared\n";
+    } else {
+        dumpString += "usage: avmetadata clear\n";
+    }
+}
 }
 
 namespace OHOS {
@@ -42,6 +100,33 @@ void MediaServer::OnDump()
     MEDIA_LOGD("MediaServer OnDump");
 }
 
+int32_t MediaServer::Dump(int32_t fd, const std::vector<std::u16string> &args)
+{
+    std::vector<std::string> argList;
+    for (auto &arg : args) {
+        argList.push_back(Str16ToStr8(arg));
+    }
+
+    std::string dumpString;
+    if (!argList.empty() && argList[0] == "trace") {
+        DumpTrace(argList, dumpString);
+    } else if (!argList.empty() && argList[0] == "avmetadata") {
+        DumpAVMetadata(argList, dumpString);
+    } else {
+        TaskQueue::DumpAllStats(dumpString);
+        AVMetadataCache::GetInstance().DumpStats(dumpString);
+        AVMetadataHelperEnginePool::GetInstance().DumpStats(dumpString);
+        AVMetadataScanScheduler::GetInstance().DumpStats(dumpString);
+        ScrubStats::GetInstance().DumpStats(dumpString);
+        PlayerStartupStats::GetInstance().DumpStats(dumpString);
+    }
+
+    ssize_t ret = write(fd, dumpString.c_str(), dumpString.size());
+    CHECK_AND_RETURN_RET_LOG(ret == static_cast<ssize_t>(dumpString.size()), MSERR_INVALID_OPERATION,
+        "write dump info failed");
+    return MSERR_OK;
+}
+
 void MediaServer::OnStart()
 {
     MEDIA_LOGD("MediaServer OnStart");
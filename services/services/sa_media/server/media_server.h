@@ -31,6 +31,9 @@ public:
     // IStandardMediaService override
     sptr<IRemoteObject> GetSubSystemAbility(IStandardMediaService::MediaSystemAbility subSystemId) override;
 
+    // IRemoteObject override, called by hidumper.
+    int32_t Dump(int32_t fd, const std::vector<std::u16string> &args) override;
+
 protected:
     // SystemAbility override
     void OnDump() override;
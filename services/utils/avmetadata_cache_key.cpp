@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmetadata_cache_key.h"
+#include <algorithm>
+#include <cerrno>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "media_log.h"
+#include "uri_helper.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataCacheKey"};
+    constexpr int64_t HASH_BLOCK_SIZE = 4096;
+    constexpr int64_t NS_PER_SECOND = 1000000000;
+    constexpr uint64_t FNV64_OFFSET = 14695981039346656037ULL;
+    constexpr uint64_t FNV64_PRIME = 1099511628211ULL;
+
+    uint64_t Fnv1a64(const uint8_t *data, size_t size, uint64_t hash = FNV64_OFFSET)
+    {
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ data[i]) * FNV64_PRIME;
+        }
+        return hash;
+    }
+
+    // hash the first and the last blocks, the metadata of most formats are at the head or the tail.
+    bool HashRange(int32_t fd, int64_t offset, int64_t length, uint64_t &hash)
+    {
+        uint8_t block[HASH_BLOCK_SIZE];
+        hash = FNV64_OFFSET;
+        std::vector<int64_t> starts = { offset };
+        if (length > HASH_BLOCK_SIZE) {
+            starts.push_back(offset + length - HASH_BLOCK_SIZE);
+        }
+        for (int64_t start : starts) {
+            size_t size = static_cast<size_t>(std::min(length, HASH_BLOCK_SIZE));
+            ssize_t ret = pread64(fd, block, size, start);
+            CHECK_AND_RETURN_RET_LOG(ret == static_cast<ssize_t>(size), false, "read failed, errno: %{public}d", errno);
+            hash = Fnv1a64(block, size, hash);
+        }
+        return true;
+    }
+}
+
+namespace OHOS {
+namespace Media {
+size_t AVMetadataCacheKey::Hash::operator()(const AVMetadataCacheKey &key) const
+{
+    return static_cast<size_t>(Fnv1a64(reinterpret_cast<const uint8_t *>(&key), sizeof(key)));
+}
+
+bool AVMetadataCacheKey::Make(const std::string &uri, AVMetadataCacheKey &key)
+{
+    UriHelper uriHelper(uri);
+    uriHelper.FormatMe();
+
+    int32_t fd = -1;
+    int32_t ownedFd = -1;
+    int64_t offset = 0;
+    int64_t length = -1;
+    if (uriHelper.UriType() == UriHelper::URI_TYPE_FD) {
+        fd = uriHelper.GetFd();
+        offset = uriHelper.GetOffset();
+        length = uriHelper.GetSize();
+    } else if (uriHelper.UriType() == UriHelper::URI_TYPE_FILE) {
+        static const std::string fileHead = "file://";
+        std::string path = uriHelper.FormattedUri().substr(fileHead.size());
+        ownedFd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        fd = ownedFd;
+    }
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat64 st = {};
+    bool ret = (fstat64(fd, &st) == 0) && S_ISREG(st.st_mode);
+    if (ret) {
+        length = (length < 0) ? (st.st_size - offset) : length;
+        key.dev = static_cast<uint64_t>(st.st_dev);
+        key.ino = static_cast<uint64_t>(st.st_ino);
+        key.fileSize = st.st_size;
+        key.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * NS_PER_SECOND + st.st_mtim.tv_nsec;
+        key.offset = offset;
+        key.length = length;
+        ret = (length > 0) && HashRange(fd, offset, length, key.contentHash);
+    }
+
+    if (ownedFd >= 0) {
+        (void)::close(ownedFd);
+    }
+    return ret;
+}
+} // namespace Media
+} // namespace OHOS
@@ -14,6 +14,7 @@
  */
 
 #include "avsharedmemorybase.h"
+#include <atomic>
 #include <sys/mman.h>
 #include <unistd.h>
 #include "ashmem.h"
@@ -23,6 +24,15 @@
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVSharedMemoryBase"};
+    constexpr uint32_t PID_SHIFT = 32;
+    std::atomic<uint32_t> g_memorySeq = 0;
+
+    uint64_t GenerateUniqueId()
+    {
+        // the pid in the high bits makes the ids from different processes distinct.
+        uint64_t pid = static_cast<uint64_t>(static_cast<uint32_t>(getpid()));
+        return (pid << PID_SHIFT) | (g_memorySeq.fetch_add(1, std::memory_order_relaxed) + 1);
+    }
 }
 
 namespace OHOS {
@@ -40,14 +50,16 @@ std::shared_ptr<AVSharedMemory> AVSharedMemory::Create(int32_t size, uint32_t fl
 }
 
 AVSharedMemoryBase::AVSharedMemoryBase(int32_t size, uint32_t flags, const std::string &name)
-    : base_(nullptr), size_(size), flags_(flags), name_(name), fd_(-1)
+    : base_(nullptr), size_(size), usedSize_(size), flags_(flags), name_(name), fd_(-1),
+      uniqueId_(GenerateUniqueId())
 {
     MEDIA_LOGD("enter ctor, instance: 0x%{public}06" PRIXPTR ", name = %{public}s",
                FAKE_POINTER(this), name_.c_str());
 }
 
 AVSharedMemoryBase::AVSharedMemoryBase(int32_t fd, int32_t size, uint32_t flags, const std::string &name)
-    : base_(nullptr), size_(size), flags_(flags), name_(name), fd_(dup(fd))
+    : base_(nullptr), size_(size), usedSize_(size), flags_(flags), name_(name), fd_(dup(fd)),
+      uniqueId_(GenerateUniqueId())
 {
     MEDIA_LOGD("enter ctor, instance: 0x%{public}06" PRIXPTR ", name = %{public}s",
                FAKE_POINTER(this), name_.c_str());
@@ -113,6 +125,7 @@ void AVSharedMemoryBase::Close() noexcept
         (void)::munmap(base_, static_cast<size_t>(size_));
         base_ = nullptr;
         size_ = 0;
+        usedSize_ = 0;
         flags_ = 0;
     }
 
@@ -129,7 +142,14 @@ uint8_t *AVSharedMemoryBase::GetBase()
 
 int32_t AVSharedMemoryBase::GetSize()
 {
-    return size_;
+    return usedSize_;
+}
+
+void AVSharedMemoryBase::SetUsedSize(int32_t size)
+{
+    CHECK_AND_RETURN_LOG(size > 0 && size <= size_, "invalid used size: %{public}d, capacity: %{public}d",
+        size, size_);
+    usedSize_ = size;
 }
 
 uint32_t AVSharedMemoryBase::GetFlags()
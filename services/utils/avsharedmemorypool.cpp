@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avsharedmemorypool.h"
+#include <chrono>
+#include "media_errors.h"
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVSharedMemoryPool"};
+    constexpr int32_t MIN_SIZE_CLASS = 4096;
+    constexpr uint32_t SUB_CLASS_SHIFT = 2; // split each power of two range into 4 classes.
+
+    int64_t GetCurTimeMs()
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    }
+}
+
+namespace OHOS {
+namespace Media {
+AVSharedMemoryPool::AVSharedMemoryPool(const std::string &name) : name_(name)
+{
+    MEDIA_LOGD("enter ctor, instance: 0x%{public}06" PRIXPTR ", name = %{public}s",
+               FAKE_POINTER(this), name_.c_str());
+}
+
+AVSharedMemoryPool::~AVSharedMemoryPool()
+{
+    MEDIA_LOGD("enter dtor, instance: 0x%{public}06" PRIXPTR ", name = %{public}s",
+               FAKE_POINTER(this), name_.c_str());
+    Trim(true);
+}
+
+int32_t AVSharedMemoryPool::Init(const InitializeOption &option)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET(!inited_, MSERR_INVALID_OPERATION);
+    CHECK_AND_RETURN_RET(option.maxPooledSize > 0 && option.maxIdleBytes >= 0, MSERR_INVALID_VAL);
+
+    option_ = option;
+    inited_ = true;
+    return MSERR_OK;
+}
+
+int32_t AVSharedMemoryPool::SizeClass(int32_t size)
+{
+    if (size <= MIN_SIZE_CLASS) {
+        return MIN_SIZE_CLASS;
+    }
+
+    uint32_t val = static_cast<uint32_t>(size) - 1;
+    uint32_t msb = 31 - static_cast<uint32_t>(__builtin_clz(val)); // 31 is the highest bit index.
+    uint32_t step = 1U << (msb - SUB_CLASS_SHIFT);
+    uint64_t sizeClass = (static_cast<uint64_t>(val / step) + 1) * step;
+    if (sizeClass > static_cast<uint64_t>(INT32_MAX)) {
+        return size;
+    }
+    return static_cast<int32_t>(sizeClass);
+}
+
+std::shared_ptr<AVSharedMemory> AVSharedMemoryPool::AcquireMemory(int32_t size)
+{
+    CHECK_AND_RETURN_RET_LOG(size > 0, nullptr, "invalid size: %{public}d", size);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(inited_, nullptr, "pool %{public}s not inited", name_.c_str());
+    stats_.acquireCount++;
+
+    if (size > option_.maxPooledSize) {
+        lock.unlock();
+        // too large to keep, just create one without pooling.
+        return AVSharedMemory::Create(size, option_.flags, name_);
+    }
+
+    int32_t sizeClass = SizeClass(size);
+    auto it = idleMemories_.find(sizeClass);
+    if (it != idleMemories_.end() && !it->second.empty()) {
+        std::unique_ptr<AVSharedMemoryBase> memory = std::move(it->second.back().memory);
+        it->second.pop_back();
+        stats_.reuseCount++;
+        stats_.idleCount--;
+        stats_.idleBytes -= sizeClass;
+        return WrapMemory(std::move(memory), size);
+    }
+
+    std::string name = name_ + "_" + std::to_string(memorySeq_++);
+    stats_.createCount++;
+    lock.unlock();
+
+    auto memory = std::make_unique<AVSharedMemoryBase>(sizeClass, option_.flags, name);
+    int32_t ret = memory->Init();
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, nullptr, "create memory failed, size: %{public}d", sizeClass);
+
+    return WrapMemory(std::move(memory), size);
+}
+
+std::shared_ptr<AVSharedMemory> AVSharedMemoryPool::WrapMemory(std::unique_ptr<AVSharedMemoryBase> memory,
+    int32_t size)
+{
+    memory->SetUsedSize(size);
+    std::weak_ptr<AVSharedMemoryPool> weakPool = weak_from_this();
+    AVSharedMemoryBase *raw = memory.release();
+    return std::shared_ptr<AVSharedMemoryBase>(raw, [weakPool](AVSharedMemoryBase *mem) {
+        std::shared_ptr<AVSharedMemoryPool> pool = weakPool.lock();
+        if (pool == nullptr) {
+            delete mem;
+            return;
+        }
+        pool->ReleaseMemory(mem);
+    });
+}
+
+void AVSharedMemoryPool::ReleaseMemory(AVSharedMemoryBase *memory)
+{
+    std::unique_ptr<AVSharedMemoryBase> owner(memory);
+    int32_t sizeClass = owner->GetCapacity();
+    int64_t nowMs = GetCurTimeMs();
+    std::vector<std::unique_ptr<AVSharedMemoryBase>> trimmed;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    TrimLocked(false, nowMs, trimmed);
+
+    std::vector<IdleMemory> &idleList = idleMemories_[sizeClass];
+    if (idleList.size() >= option_.maxIdleNumPerClass || stats_.idleBytes + sizeClass > option_.maxIdleBytes) {
+        stats_.trimCount++;
+        lock.unlock();
+        return; // unmapped by the owner out of the lock.
+    }
+
+    idleList.push_back({ std::move(owner), nowMs });
+    stats_.idleCount++;
+    stats_.idleBytes += sizeClass;
+}
+
+void AVSharedMemoryPool::Trim(bool force)
+{
+    std::vector<std::unique_ptr<AVSharedMemoryBase>> trimmed;
+    std::unique_lock<std::mutex> lock(mutex_);
+    TrimLocked(force, GetCurTimeMs(), trimmed);
+    lock.unlock();
+    // unmap out of the lock.
+    trimmed.clear();
+}
+
+void AVSharedMemoryPool::TrimLocked(bool force, int64_t nowMs,
+    std::vector<std::unique_ptr<AVSharedMemoryBase>> &trimmed)
+{
+    for (auto &[sizeClass, idleList] : idleMemories_) {
+        // the idle list is ordered by the release time, the expired ones are at the front.
+        auto it = idleList.begin();
+        while (it != idleList.end() && (force || nowMs - it->releaseTimeMs >= option_.trimIdleTimeMs)) {
+            trimmed.push_back(std::move(it->memory));
+            stats_.trimCount++;
+            stats_.idleCount--;
+            stats_.idleBytes -= sizeClass;
+            ++it;
+        }
+        (void)idleList.erase(idleList.begin(), it);
+    }
+}
+
+AVSharedMemoryPool::Stats AVSharedMemoryPool::GetStats()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return stats_;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETADATA_CACHE_KEY_H
+#define AVMETADATA_CACHE_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace Media {
+// the identity of the file content, without any padding, it is written into the cache file as is.
+struct __attribute__((visibility("default"))) AVMetadataCacheKey {
+    uint64_t dev = 0;
+    uint64_t ino = 0;
+    int64_t fileSize = 0;
+    int64_t mtimeNs = 0;
+    int64_t offset = 0; // the range of the fd source.
+    int64_t length = 0;
+    uint64_t contentHash = 0; // the hash of the first and last blocks of the range.
+
+    bool operator==(const AVMetadataCacheKey &other) const
+    {
+        return dev == other.dev && ino == other.ino && fileSize == other.fileSize && mtimeNs == other.mtimeNs &&
+            offset == other.offset && length == other.length && contentHash == other.contentHash;
+    }
+
+    struct Hash {
+        size_t operator()(const AVMetadataCacheKey &key) const;
+    };
+
+    // only the local file and the fd source have the key, return false for others.
+    static bool Make(const std::string &uri, AVMetadataCacheKey &key);
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETADATA_CACHE_KEY_H
@@ -36,9 +36,21 @@ public:
     {
         return name_;
     }
+    // process unique, never reused, the receiver of the parcel can use it to identify the memory.
+    uint64_t GetUniqueId() const
+    {
+        return uniqueId_;
+    }
     uint8_t *GetBase() override;
     int32_t GetSize() override;
     uint32_t GetFlags() override;
+    // the mapped size, the GetSize is less than it only when a part of the memory is used.
+    int32_t GetCapacity() const
+    {
+        return size_;
+    }
+    // used by the memory pool, which hands out a memory of the size class for a smaller request.
+    void SetUsedSize(int32_t size);
 
     DISALLOW_COPY_AND_MOVE(AVSharedMemoryBase);
 
@@ -48,9 +60,11 @@ private:
 
     uint8_t *base_;
     int32_t size_;
+    int32_t usedSize_;
     uint32_t flags_;
     std::string name_;
     int32_t fd_;
+    uint64_t uniqueId_;
 };
 }
 }
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVSHAREDMEMORYPOOL_H
+#define AVSHAREDMEMORYPOOL_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "nocopyable.h"
+#include "avsharedmemorybase.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Recycle the ashmem regions instead of AshmemCreate + mmap for each memory.
+ *
+ * The requested size is rounded up to a size class, every power of two range is split into
+ * four classes, so that at most 25% memory is wasted. The memories acquired from the pool go
+ * back to the idle list of its size class when the last reference is released. The idle lists
+ * are bounded by the count and the total bytes, and the memories idle longer than the trim
+ * time are unmapped at next acquiring or releasing.
+ *
+ * The pooled memory is a normal AVSharedMemoryBase, it can be written to the parcel directly,
+ * the parcel carries its capacity. The content of the reused memory is not cleared.
+ *
+ * Example:
+ * auto pool = std::make_shared<AVSharedMemoryPool>("your_pool_name");
+ * pool->Init(AVSharedMemoryPool::InitializeOption {});
+ * std::shared_ptr<AVSharedMemory> mem = pool->AcquireMemory(size);
+ */
+class __attribute__((visibility("default"))) AVSharedMemoryPool
+    : public std::enable_shared_from_this<AVSharedMemoryPool> {
+public:
+    explicit AVSharedMemoryPool(const std::string &name);
+    ~AVSharedMemoryPool();
+
+    struct InitializeOption {
+        uint32_t flags = AVSharedMemory::FLAGS_READ_WRITE; // the flags of all memories from this pool.
+        uint32_t maxIdleNumPerClass = 4;
+        int64_t maxIdleBytes = 16 * 1024 * 1024; // 16MB
+        int32_t maxPooledSize = 16 * 1024 * 1024; // 16MB, the larger memory will not be pooled.
+        uint32_t trimIdleTimeMs = 10000; // 10s
+    };
+
+    struct Stats {
+        uint64_t acquireCount = 0;
+        uint64_t reuseCount = 0;
+        uint64_t createCount = 0;
+        uint64_t trimCount = 0;
+        uint32_t idleCount = 0;
+        int64_t idleBytes = 0;
+    };
+
+    int32_t Init(const InitializeOption &option);
+
+    /**
+     * Get a memory of the size class of the requested size, the GetSize of the returned memory
+     * is the requested size, and the GetCapacity of it is the size of its class.
+     */
+    std::shared_ptr<AVSharedMemory> AcquireMemory(int32_t size);
+
+    // unmap the idle memories, all of them if the force is true, or only the expired ones.
+    void Trim(bool force = false);
+    Stats GetStats();
+
+    static int32_t SizeClass(int32_t size);
+
+    DISALLOW_COPY_AND_MOVE(AVSharedMemoryPool);
+
+private:
+    struct IdleMemory {
+        std::unique_ptr<AVSharedMemoryBase> memory;
+        int64_t releaseTimeMs;
+    };
+    void ReleaseMemory(AVSharedMemoryBase *memory);
+    std::shared_ptr<AVSharedMemory> WrapMemory(std::unique_ptr<AVSharedMemoryBase> memory, int32_t size);
+    void TrimLocked(bool force, int64_t nowMs, std::vector<std::unique_ptr<AVSharedMemoryBase>> &trimmed);
+
+    std::string name_;
+    InitializeOption option_;
+    bool inited_ = false;
+    // the idle memories of each size class, the most recently released one at the back.
+    std::map<int32_t, std::vector<IdleMemory>> idleMemories_;
+    Stats stats_;
+    uint64_t memorySeq_ = 0;
+    std::mutex mutex_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVSHAREDMEMORYPOOL_H
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INLINE_TASK_HANDLER_H
+#define INLINE_TASK_HANDLER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "task_queue.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Recycle the fixed size memory blocks of the fire-and-forget tasks. At most MAX_FREE_BLOCKS
+ * blocks are kept for each block size, the others are returned to the heap.
+ */
+template <size_t BlockSize>
+class TaskBlockFreeList {
+public:
+    static TaskBlockFreeList &GetInstance()
+    {
+        // never destroyed, the tasks may be released during the static destruction.
+        static TaskBlockFreeList *instance = new TaskBlockFreeList();
+        return *instance;
+    }
+
+    void *Allocate()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (head_ != nullptr) {
+                FreeBlock *block = head_;
+                head_ = block->next;
+                freeCount_--;
+                return block;
+            }
+        }
+        return ::operator new(BlockSize);
+    }
+
+    void Release(void *ptr)
+    {
+        if (ptr == nullptr) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (freeCount_ < MAX_FREE_BLOCKS) {
+                FreeBlock *block = static_cast<FreeBlock *>(ptr);
+                block->next = head_;
+                head_ = block;
+                freeCount_++;
+                return;
+            }
+        }
+        ::operator delete(ptr);
+    }
+
+private:
+    static_assert(BlockSize >= sizeof(void *), "block too small");
+    static constexpr size_t MAX_FREE_BLOCKS = 64;
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+    TaskBlockFreeList() = default;
+    ~TaskBlockFreeList() = default;
+
+    std::mutex mutex_;
+    FreeBlock *head_ = nullptr;
+    size_t freeCount_ = 0;
+};
+
+template <typename T>
+struct TaskBlockAllocator {
+    using value_type = T;
+
+    TaskBlockAllocator() = default;
+    template <typename U>
+    TaskBlockAllocator(const TaskBlockAllocator<U> &) {}
+
+    T *allocate(size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over aligned type");
+        if (n != 1) {
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T *>(TaskBlockFreeList<sizeof(T)>::GetInstance().Allocate());
+    }
+
+    void deallocate(T *ptr, size_t n)
+    {
+        if (n != 1) {
+            ::operator delete(ptr);
+            return;
+        }
+        TaskBlockFreeList<sizeof(T)>::GetInstance().Release(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const TaskBlockAllocator<U> &) const
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const TaskBlockAllocator<U> &) const
+    {
+        return false;
+    }
+};
+
+/**
+ * Fire-and-forget task without result. The callable is stored inline and the task object is
+ * allocated from a freelist, so the enqueue path has no heap allocation after warming up.
+ * The state is an atomic instead of the mutex and condition variable of the TaskHandler, use
+ * the TaskHandler if the caller needs to wait for the result.
+ *
+ * Example:
+ * auto task = InlineTaskHandler::Create([this] { DoSomething(); });
+ * taskQ.EnqueueTask(task);
+ */
+class InlineTaskHandler : public ITaskHandler {
+public:
+    static constexpr size_t INLINE_SIZE = 64;
+
+    template <typename F>
+    static std::shared_ptr<ITaskHandler> Create(F &&func, ITaskHandler::Attribute attr = {})
+    {
+        using Callable = std::decay_t<F>;
+        static_assert(sizeof(Callable) <= INLINE_SIZE, "the captures are too large for inline storage");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "over aligned callable");
+        static_assert(std::is_void_v<std::invoke_result_t<Callable &>>, "only support the void task");
+
+        return std::allocate_shared<InlineTaskHandler>(TaskBlockAllocator<InlineTaskHandler>(),
+            PrivateTag(), std::forward<F>(func), attr);
+    }
+
+    struct PrivateTag {};
+    template <typename F>
+    InlineTaskHandler(PrivateTag, F &&func, ITaskHandler::Attribute attr) : attribute_(attr)
+    {
+        using Callable = std::decay_t<F>;
+        new (&storage_) Callable(std::forward<F>(func));
+        invoke_ = [](void *callable) { (*static_cast<Callable *>(callable))(); };
+        destroy_ = [](void *callable) { static_cast<Callable *>(callable)->~Callable(); };
+    }
+
+    ~InlineTaskHandler()
+    {
+        destroy_(&storage_);
+    }
+
+    void Execute() override
+    {
+        uint8_t expected = TASK_IDLE;
+        if (!state_.compare_exchange_strong(expected, TASK_RUNNING)) {
+            return;
+        }
+        invoke_(&storage_);
+        state_.store(TASK_FINISHED);
+    }
+
+    void Cancel() override
+    {
+        uint8_t expected = TASK_IDLE;
+        (void)state_.compare_exchange_strong(expected, TASK_CANCELED);
+    }
+
+    bool IsCanceled() override
+    {
+        return state_.load() == TASK_CANCELED;
+    }
+
+    ITaskHandler::Attribute GetAttribute() const override
+    {
+        return attribute_;
+    }
+
+    DISALLOW_COPY_AND_MOVE(InlineTaskHandler);
+
+private:
+    enum TaskState : uint8_t {
+        TASK_IDLE,
+        TASK_RUNNING,
+        TASK_CANCELED,
+        TASK_FINISHED,
+    };
+
+    std::aligned_storage_t<INLINE_SIZE, alignof(std::max_align_t)> storage_;
+    void (*invoke_)(void *) = nullptr;
+    void (*destroy_)(void *) = nullptr;
+    std::atomic<uint8_t> state_ = TASK_IDLE;
+    ITaskHandler::Attribute attribute_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // INLINE_TASK_HANDLER_H
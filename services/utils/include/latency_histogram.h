@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace Media {
+/**
+ * The latency statistics shared by the process-wide stats of the service. It is not thread safe,
+ * the owner records and reads it under its own lock.
+ */
+class __attribute__((visibility("default"))) LatencyHistogram {
+public:
+    // bucket 0 counts the latency less than 1ms, bucket i counts [2^(i-1), 2^i) ms,
+    // and the last bucket counts all the longer ones.
+    static constexpr size_t BUCKETS = 16;
+
+    void Record(uint64_t latencyUs);
+    uint64_t GetCount() const
+    {
+        return count_;
+    }
+    uint64_t GetAvgMs() const;
+    uint64_t GetMaxMs() const;
+    // approximate percentile, return the upper bound of the matched bucket, UINT64_MAX for the last one.
+    uint64_t GetPercentileMs(uint32_t percent) const;
+    // "latency(ms) avg x, p50 <= x, p99 <= x, max x", without the line end.
+    std::string ToString() const;
+
+    // the steady clock time, for measuring the latency.
+    static uint64_t GetCurTimeNs()
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    }
+
+private:
+    uint64_t count_ = 0;
+    uint64_t totalUs_ = 0;
+    uint64_t maxUs_ = 0;
+    std::array<uint64_t, BUCKETS> buckets_ {};
+};
+} // namespace Media
+} // namespace OHOS
+#endif // LATENCY_HISTOGRAM_H
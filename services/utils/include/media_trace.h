@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEDIA_TRACE_H
+#define MEDIA_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+enum MediaTraceCategory : uint32_t {
+    MEDIA_TRACE_IPC = 1 << 0,
+    MEDIA_TRACE_TASK_QUEUE = 1 << 1,
+    MEDIA_TRACE_APPSRC = 1 << 2,
+    MEDIA_TRACE_RENDER = 1 << 3,
+    MEDIA_TRACE_RECORDER = 1 << 4,
+    MEDIA_TRACE_ALL = 0xFFFFFFFF,
+};
+
+/**
+ * Hot path tracing. The events are written into the ring buffer of the current thread without
+ * lock, the oldest ones are overwritten, and nothing is recorded for the disabled categories.
+ * The event names must be string literals or the names got from InternName, they are referenced
+ * until the events are dumped.
+ *
+ * Example:
+ * MediaTraceScope trace("PlayerServiceStub::OnRemoteRequest", MEDIA_TRACE_IPC, code);
+ */
+class __attribute__((visibility("default"))) MediaTrace {
+public:
+    static constexpr int64_t NO_ARG = INT64_MIN;
+
+    static void EnableCategories(uint32_t categories);
+    static void DisableCategories(uint32_t categories);
+    static bool IsEnabled(uint32_t category)
+    {
+        return (enabledCategories_.load(std::memory_order_relaxed) & category) != 0;
+    }
+
+    // the monotonic clock of the vdso, no system call.
+    static uint64_t GetTimeNs()
+    {
+        struct timespec ts = {};
+        (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    static void RecordSpan(const char *name, uint32_t category, uint64_t startNs, uint64_t endNs,
+        int64_t arg = NO_ARG);
+    static void RecordInstant(const char *name, uint32_t category, int64_t arg = NO_ARG);
+    // get a name string that is never released, for the names not known at the compiling time.
+    static const char *InternName(const std::string &name);
+    // dump the events of all threads in the chrome trace event json format.
+    static void DumpChromeTrace(std::string &dumpString);
+
+private:
+    static std::atomic<uint32_t> enabledCategories_;
+};
+
+class MediaTraceScope {
+public:
+    MediaTraceScope(const char *name, uint32_t category, int64_t arg = MediaTrace::NO_ARG)
+        : name_(MediaTrace::IsEnabled(category) ? name : nullptr), category_(category), arg_(arg)
+    {
+        if (name_ != nullptr) {
+            startNs_ = MediaTrace::GetTimeNs();
+        }
+    }
+
+    ~MediaTraceScope()
+    {
+        if (name_ != nullptr) {
+            MediaTrace::RecordSpan(name_, category_, startNs_, MediaTrace::GetTimeNs(), arg_);
+        }
+    }
+
+    void SetArg(int64_t arg)
+    {
+        arg_ = arg;
+    }
+
+    DISALLOW_COPY_AND_MOVE(MediaTraceScope);
+
+private:
+    const char *name_;
+    uint32_t category_;
+    int64_t arg_;
+    uint64_t startNs_ = 0;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // MEDIA_TRACE_H
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PLAYER_STARTUP_STATS_H
+#define PLAYER_STARTUP_STATS_H
+
+#include <mutex>
+#include <string>
+#include "latency_histogram.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The process-wide statistics of the startup latency of all players, measured from the source set
+ * to the engine to the prepared state, when the first frame is prerolled. The warm startups reuse
+ * the gstplayer kept by the last reset, and the cold ones build a new gstplayer. The audio only
+ * startups, without the surface, are counted apart from the video ones.
+ */
+class __attribute__((visibility("default"))) PlayerStartupStats {
+public:
+    static PlayerStartupStats &GetInstance();
+
+    void OnPrepared(bool warm, bool audioOnly, uint64_t latencyUs);
+    LatencyHistogram GetStats(bool warm, bool audioOnly);
+    void DumpStats(std::string &dumpString);
+
+    DISALLOW_COPY_AND_MOVE(PlayerStartupStats);
+
+private:
+    PlayerStartupStats() = default;
+    ~PlayerStartupStats() = default;
+    static void DumpOne(std::string &dumpString, const char *name, const LatencyHistogram &stats);
+
+    // indexed by [audioOnly][warm].
+    LatencyHistogram stats_[2][2];
+    std::mutex mutex_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // PLAYER_STARTUP_STATS_H
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCRUB_STATS_H
+#define SCRUB_STATS_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "latency_histogram.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The process-wide statistics of the scrubbing seeks of all players. The latency is measured from
+ * the seek request to the seek done of the same target, so that the time waiting behind the previous
+ * seek is counted too. The release latency is the one of the accurate seek that ends a scrubbing.
+ */
+class __attribute__((visibility("default"))) ScrubStats {
+public:
+    struct Stats {
+        uint64_t sessionCount = 0;
+        uint64_t requestCount = 0;
+        uint64_t coalescedCount = 0;
+        LatencyHistogram latency; // the count of it is the executed seeks.
+        uint64_t totalReleaseLatencyUs = 0;
+        uint64_t maxReleaseLatencyUs = 0;
+    };
+
+    static ScrubStats &GetInstance();
+
+    void OnScrubRequested(bool coalesced);
+    void OnScrubSeekDone(uint64_t latencyUs);
+    void OnScrubReleased(uint64_t latencyUs);
+    Stats GetStats();
+    void DumpStats(std::string &dumpString);
+
+    DISALLOW_COPY_AND_MOVE(ScrubStats);
+
+private:
+    ScrubStats() = default;
+    ~ScrubStats() = default;
+
+    Stats stats_;
+    std::mutex mutex_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // SCRUB_STATS_H
@@ -16,11 +16,13 @@
 #ifndef RECORDER_TASK_QUEUE_H
 #define RECORDER_TASK_QUEUE_H
 
+#include <array>
+#include <atomic>
 #include <thread>
 #include <condition_variable>
 #include <mutex>
 #include <functional>
-#include <list>
+#include <vector>
 #include <string>
 #include <optional>
 #include <type_traits>
@@ -61,6 +63,13 @@ namespace Media {
  * } else {
  *     MEDIA_LOGI("handler2 not executed");
  * }
+ *
+ * Example 3:
+ * // no dedicated thread, the tasks run one by one on the process-wide TaskWorkerPool.
+ * TaskQueue taskQ("your_task_queue_name", TaskQueue::SHARED_POOL);
+ * taskQ.Start();
+ * Only use this mode for the short tasks that never block waiting for another task,
+ * because the workers are shared by all queues of this mode in the process.
  */
 
 class TaskQueue;
@@ -183,9 +192,33 @@ private:
     ITaskHandler::Attribute attribute_; // task execute attribute.
 };
 
+struct TaskQueueStats {
+    // bucket 0 counts the durations less than 1us, bucket i counts [2^(i-1), 2^i) us,
+    // and the last bucket counts all the longer ones.
+    static constexpr size_t HISTOGRAM_BUCKETS = 24;
+    uint64_t enqueuedCount = 0;
+    uint64_t executedCount = 0;
+    uint64_t canceledCount = 0;
+    uint64_t depthHighWater = 0;
+    uint64_t totalWaitUs = 0; // from the expected execute time to the actual start time.
+    uint64_t maxWaitUs = 0;
+    uint64_t totalExecUs = 0;
+    uint64_t maxExecUs = 0;
+    std::array<uint64_t, HISTOGRAM_BUCKETS> waitUsHistogram {};
+    std::array<uint64_t, HISTOGRAM_BUCKETS> execUsHistogram {};
+
+    // approximate percentile from the histogram, return the upper bound of the matched bucket.
+    static uint64_t Percentile(const std::array<uint64_t, HISTOGRAM_BUCKETS> &histogram, uint32_t percent);
+};
+
 class __attribute__((visibility("default"))) TaskQueue {
 public:
-    explicit TaskQueue(const std::string &name) : name_(name) {}
+    enum ExecuteMode : uint8_t {
+        DEDICATED_THREAD, // the queue owns a thread to execute its tasks.
+        SHARED_POOL, // the queue is a serial executor on the process-wide TaskWorkerPool.
+    };
+
+    explicit TaskQueue(const std::string &name, ExecuteMode mode = DEDICATED_THREAD);
     ~TaskQueue();
 
     int32_t Start();
@@ -195,22 +228,94 @@ public:
     int32_t EnqueueTask(const std::shared_ptr<ITaskHandler> &task,
         bool cancelNotExecuted = false, uint64_t delayUs = 0ULL);
 
+    // the statistics are recorded by relaxed atomics, always enabled.
+    TaskQueueStats GetStats() const;
+    const std::string &GetName() const
+    {
+        return name_;
+    }
+
+    // dump the statistics of all alive task queues in this process.
+    static void DumpAllStats(std::string &dumpString);
+
     DISALLOW_COPY_AND_MOVE(TaskQueue);
 
 private:
+    friend class TaskWorkerPool;
     struct TaskHandlerItem {
         std::shared_ptr<ITaskHandler> task_ { nullptr };
         uint64_t executeTimeNs_ { 0ULL };
+        uint64_t seq_ { 0ULL }; // keep fifo order for the tasks with same execute time.
+    };
+    // min-heap order: the earliest execute time at the top, then the smallest seq.
+    struct TaskHandlerItemLater {
+        bool operator()(const TaskHandlerItem &lhs, const TaskHandlerItem &rhs) const
+        {
+            if (lhs.executeTimeNs_ != rhs.executeTimeNs_) {
+                return lhs.executeTimeNs_ > rhs.executeTimeNs_;
+            }
+            return lhs.seq_ > rhs.seq_;
+        }
+    };
+    enum StrandState : uint8_t {
+        STRAND_IDLE, // no task, not scheduled to the pool.
+        STRAND_PENDING, // scheduled to the pool, waiting for a worker.
+        STRAND_RUNNING, // a worker is executing one task of this queue.
+    };
+    class StatsRecorder {
+    public:
+        void OnEnqueued(uint64_t depth);
+        void OnCanceled();
+        void OnExecuted(uint64_t waitUs, uint64_t execUs);
+        void Snapshot(TaskQueueStats &stats) const;
+
+    private:
+        using Histogram = std::array<std::atomic<uint64_t>, TaskQueueStats::HISTOGRAM_BUCKETS>;
+        static void UpdateMax(std::atomic<uint64_t> &maxVal, uint64_t val);
+        static size_t BucketIndex(uint64_t valUs);
+
+        std::atomic<uint64_t> enqueuedCount_ = 0;
+        std::atomic<uint64_t> executedCount_ = 0;
+        std::atomic<uint64_t> canceledCount_ = 0;
+        std::atomic<uint64_t> depthHighWater_ = 0;
+        std::atomic<uint64_t> totalWaitUs_ = 0;
+        std::atomic<uint64_t> maxWaitUs_ = 0;
+        std::atomic<uint64_t> totalExecUs_ = 0;
+        std::atomic<uint64_t> maxExecUs_ = 0;
+        Histogram waitUsHistogram_ {};
+        Histogram execUsHistogram_ {};
     };
     void TaskProcessor();
+    void ExecuteTask(const TaskHandlerItem &item);
+    void SchedulePoolLocked();
+    // called by the TaskWorkerPool, return the next wake up time, or UINT64_MAX if no need to schedule.
+    uint64_t RunOnPool();
     void CancelNotExecutedTaskLocked();
+    bool HasTaskLocked() const;
+    const TaskHandlerItem &NextTaskLocked() const;
+    void PopNextTaskLocked();
 
     bool isExit_ = true;
     std::unique_ptr<std::thread> thread_;
-    std::list<TaskHandlerItem> taskList_;
+    // zero-delay tasks are always appended in time order, no need to sort them. The consumed items
+    // before immediateHead_ are dropped in batch, so the storage is reused without allocation.
+    std::vector<TaskHandlerItem> immediateTasks_;
+    size_t immediateHead_ = 0;
+    // delayed or periodic tasks, kept as a binary heap by TaskHandlerItemLater.
+    std::vector<TaskHandlerItem> delayedTasks_;
+    uint64_t nextSeq_ = 0;
     std::mutex mutex_;
     std::condition_variable cond_;
     std::string name_;
+    const char *traceName_;
+    ExecuteMode mode_;
+    StatsRecorder stats_;
+    StrandState strandState_ = STRAND_IDLE;
+    uint64_t strandWakeNs_ = 0;
+    // the schedule state in the TaskWorkerPool, protected by the pool's lock.
+    uint64_t poolSeq_ = 0; // 0 means not scheduled.
+    uint64_t poolWakeNs_ = 0;
+    uint32_t poolRunning_ = 0;
 };
 }
 }
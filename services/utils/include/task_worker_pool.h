@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TASK_WORKER_POOL_H
+#define TASK_WORKER_POOL_H
+
+#include <cstdint>
+#include <thread>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+class TaskQueue;
+
+/**
+ * Process-wide worker threads shared by all the TaskQueues created with TaskQueue::SHARED_POOL.
+ *
+ * Each such TaskQueue is a serial executor (strand) on this pool: the pool holds at most one
+ * schedule entry for a queue, and a queue is never run by two workers at the same time, so the
+ * per-queue execution order is kept. The workers are created on demand when no worker is idle,
+ * and never more than the number of cpu cores.
+ */
+class TaskWorkerPool {
+public:
+    static TaskWorkerPool &GetInstance();
+
+    // schedule the queue to run at the steady clock time wakeNs, keep the earlier one if already scheduled.
+    void Schedule(TaskQueue &queue, uint64_t wakeNs);
+    // drop the schedule entry of the queue, and wait until no worker is running it.
+    void Remove(TaskQueue &queue);
+
+    DISALLOW_COPY_AND_MOVE(TaskWorkerPool);
+
+private:
+    TaskWorkerPool();
+    ~TaskWorkerPool();
+
+    struct ScheduleEntry {
+        uint64_t wakeNs;
+        uint64_t seq; // the entry is stale if not equal to the queue's poolSeq_.
+        TaskQueue *queue;
+    };
+    struct ScheduleEntryLater {
+        bool operator()(const ScheduleEntry &lhs, const ScheduleEntry &rhs) const
+        {
+            if (lhs.wakeNs != rhs.wakeNs) {
+                return lhs.wakeNs > rhs.wakeNs;
+            }
+            return lhs.seq > rhs.seq;
+        }
+    };
+    void ScheduleLocked(TaskQueue &queue, uint64_t wakeNs);
+    void PopEntryLocked();
+    void SpawnWorkerLocked();
+    void WorkerLoop();
+
+    bool isExit_ = false;
+    size_t maxWorkers_;
+    size_t idleWorkers_ = 0;
+    uint64_t nextSeq_ = 0;
+    std::vector<std::thread> workers_;
+    // binary heap, the schedule state of each queue is kept in the queue itself, so the
+    // scheduling has no allocation once the heap storage grows up.
+    std::vector<ScheduleEntry> scheduledQueues_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::condition_variable runningCond_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // TASK_WORKER_POOL_H
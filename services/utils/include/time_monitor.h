@@ -17,9 +17,9 @@
 #define MEDIA_TIME_MONITOR_H
 
 #include <string>
+#include <cstdint>
 #include <mutex>
 #include <map>
-#include <sys/time.h>
 
 namespace OHOS {
 namespace Media {
@@ -31,15 +31,8 @@ public:
     void FinishTime();
 
 private:
-    enum TimeValType {
-        TIME_VAL_MS = 1000,         /* sec to ms */
-        TIME_VAL_US = 1000000,      /* sec to us */
-        TIME_VAL_NS = 1000000000,   /* sec to ns */
-    };
-    int64_t Timeval2Sec(const timeval &tv, TimeValType valType) const;
     std::string objectName_ = "Unknown";
-    struct timeval startTime_ = {};
-    struct timeval finishTime_ = {};
+    uint64_t startTimeNs_ = 0;
     bool isStart_ = false;
 };
 } // namespace Media
@@ -54,13 +54,34 @@ public:
 
     UriHelper &FormatMe();
     uint8_t UriType() const;
+    /**
+     * Whether the scheme of the raw uri is "fd", case insensitive and no matter the fd is valid or not.
+     * The type of an invalid fd uri is URI_TYPE_UNKNOWN, so the uris from the clients must be checked
+     * by this, the fd in it may become valid in the service before the engine parses it again.
+     */
+    bool IsFdScheme() const;
     std::string FormattedUri() const;
     bool AccessCheck(uint8_t flag) const;
 
+    /**
+     * The fd uri is "fd://<fd>?offset=<offset>&size=<size>", the offset and size are optional
+     * and select a sub-range of the file. After FormatMe, the size is clamped to the file end,
+     * and the formatted uri always carries the offset and size.
+     */
+    int32_t GetFd() const;
+    int64_t GetOffset() const;
+    int64_t GetSize() const;
+    static std::string MakeFdUri(int32_t fd, int64_t offset, int64_t size);
+
 private:
+    bool ParseFdUri(std::string_view rawUri);
+
     std::string_view uri_;
     std::string formattedUri_ = "";
     uint8_t type_ = 0;
+    int32_t fd_ = -1;
+    int64_t offset_ = 0;
+    int64_t size_ = -1;
 };
 }
 }
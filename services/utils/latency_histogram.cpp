@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cinttypes>
+#include <securec.h>
+
+namespace {
+    constexpr uint64_t US_PER_MS = 1000;
+    constexpr uint32_t PERCENT_50 = 50;
+    constexpr uint32_t PERCENT_99 = 99;
+    constexpr uint32_t PERCENT_100 = 100;
+
+    size_t BucketIndex(uint64_t valMs)
+    {
+        size_t index = 0;
+        while (valMs != 0 && index < OHOS::Media::LatencyHistogram::BUCKETS - 1) {
+            valMs >>= 1;
+            index++;
+        }
+        return index;
+    }
+}
+
+namespace OHOS {
+namespace Media {
+void LatencyHistogram::Record(uint64_t latencyUs)
+{
+    count_++;
+    totalUs_ += latencyUs;
+    maxUs_ = std::max(maxUs_, latencyUs);
+    buckets_[BucketIndex(latencyUs / US_PER_MS)]++;
+}
+
+uint64_t LatencyHistogram::GetAvgMs() const
+{
+    return (count_ == 0) ? 0 : (totalUs_ / count_ / US_PER_MS);
+}
+
+uint64_t LatencyHistogram::GetMaxMs() const
+{
+    return maxUs_ / US_PER_MS;
+}
+
+uint64_t LatencyHistogram::GetPercentileMs(uint32_t percent) const
+{
+    if (count_ == 0) {
+        return 0;
+    }
+
+    uint64_t target = (count_ * percent + PERCENT_100 - 1) / PERCENT_100;
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        accumulated += buckets_[i];
+        if (accumulated >= target) {
+            return (i == BUCKETS - 1) ? UINT64_MAX : (1ULL << i);
+        }
+    }
+    return UINT64_MAX;
+}
+
+std::string LatencyHistogram::ToString() const
+{
+    char buf[128] = {0}; // 128 is enough for the five numbers.
+    (void)sprintf_s(buf, sizeof(buf), "latency(ms) avg %" PRIu64 ", p50 <= %" PRIu64 ", p99 <= %" PRIu64
+        ", max %" PRIu64, GetAvgMs(), GetPercentileMs(PERCENT_50), GetPercentileMs(PERCENT_99), GetMaxMs());
+    return buf;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "media_trace.h"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <securec.h>
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "MediaTrace"};
+    constexpr size_t RING_CAPACITY = 1024; // must be power of 2.
+    constexpr size_t MAX_RETIRED_RINGS = 16;
+    constexpr uint64_t INSTANT_DURATION = UINT64_MAX;
+    constexpr uint64_t NS_PER_US = 1000;
+
+    struct TraceEvent {
+        // seqlock, odd when the event is being written, 2 * (index + 1) when the write is done.
+        std::atomic<uint64_t> seq = 0;
+        std::atomic<const char *> name = nullptr;
+        std::atomic<uint32_t> category = 0;
+        std::atomic<uint64_t> startNs = 0;
+        std::atomic<uint64_t> durationNs = 0;
+        std::atomic<int64_t> arg = 0;
+    };
+
+    // written only by the owner thread, read by the dumping thread.
+    struct TraceRing {
+        explicit TraceRing(int32_t threadId) : tid(threadId) {}
+        int32_t tid;
+        std::atomic<bool> retired = false;
+        std::atomic<uint64_t> writeIndex = 0;
+        std::array<TraceEvent, RING_CAPACITY> events;
+    };
+
+    std::mutex &RingsMutex()
+    {
+        static std::mutex *ringsMutex = new std::mutex();
+        return *ringsMutex;
+    }
+
+    // never destroyed, the threads may exit during the static destruction.
+    std::vector<std::shared_ptr<TraceRing>> &AllRings()
+    {
+        static auto *rings = new std::vector<std::shared_ptr<TraceRing>>();
+        return *rings;
+    }
+
+    std::shared_ptr<TraceRing> RegisterRing()
+    {
+        auto ring = std::make_shared<TraceRing>(static_cast<int32_t>(syscall(SYS_gettid)));
+        std::lock_guard<std::mutex> lock(RingsMutex());
+        std::vector<std::shared_ptr<TraceRing>> &rings = AllRings();
+        // keep the events of the exited threads for dumping, but only the latest ones.
+        size_t retiredNum = 0;
+        for (auto &item : rings) {
+            if (item->retired.load(std::memory_order_relaxed)) {
+                retiredNum++;
+            }
+        }
+        for (auto it = rings.begin(); it != rings.end() && retiredNum > MAX_RETIRED_RINGS;) {
+            if ((*it)->retired.load(std::memory_order_relaxed)) {
+                it = rings.erase(it);
+                retiredNum--;
+                continue;
+            }
+            ++it;
+        }
+        rings.push_back(ring);
+        return ring;
+    }
+
+    class ThreadRingHolder {
+    public:
+        ThreadRingHolder() = default;
+        ~ThreadRingHolder()
+        {
+            if (ring_ != nullptr) {
+                ring_->retired.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        TraceRing &GetRing()
+        {
+            if (ring_ == nullptr) {
+                ring_ = RegisterRing();
+            }
+            return *ring_;
+        }
+
+        DISALLOW_COPY_AND_MOVE(ThreadRingHolder);
+
+    private:
+        std::shared_ptr<TraceRing> ring_ = nullptr;
+    };
+
+    thread_local ThreadRingHolder g_threadRing;
+
+    void WriteEvent(const char *name, uint32_t category, uint64_t startNs, uint64_t durationNs, int64_t arg)
+    {
+        TraceRing &ring = g_threadRing.GetRing();
+        uint64_t index = ring.writeIndex.load(std::memory_order_relaxed);
+        TraceEvent &event = ring.events[index & (RING_CAPACITY - 1)];
+
+        event.seq.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        event.name.store(name, std::memory_order_relaxed);
+        event.category.store(category, std::memory_order_relaxed);
+        event.startNs.store(startNs, std::memory_order_relaxed);
+        event.durationNs.store(durationNs, std::memory_order_relaxed);
+        event.arg.store(arg, std::memory_order_relaxed);
+        event.seq.store(index * 2 + 2, std::memory_order_release);
+        ring.writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    const char *CategoryName(uint32_t category)
+    {
+        switch (category) {
+            case OHOS::Media::MEDIA_TRACE_IPC:
+                return "ipc";
+            case OHOS::Media::MEDIA_TRACE_TASK_QUEUE:
+                return "taskqueue";
+            case OHOS::Media::MEDIA_TRACE_APPSRC:
+                return "appsrc";
+            case OHOS::Media::MEDIA_TRACE_RENDER:
+                return "render";
+            case OHOS::Media::MEDIA_TRACE_RECORDER:
+                return "recorder";
+            default:
+                return "media";
+        }
+    }
+
+    void AppendEscaped(std::string &dumpString, const char *str)
+    {
+        for (const char *ch = str; *ch != '\0'; ch++) {
+            if (*ch == '"' || *ch == '\\') {
+                dumpString += '\\';
+            }
+            dumpString += *ch;
+        }
+    }
+
+    void DumpEvent(std::string &dumpString, int32_t tid, const char *name, uint32_t category,
+        uint64_t startNs, uint64_t durationNs, int64_t arg)
+    {
+        char buf[256] = {0}; // 256 is enough for one event without the name.
+        dumpString += dumpString.back() == '[' ? "\n{\"name\":\"" : ",\n{\"name\":\"";
+        AppendEscaped(dumpString, name);
+        if (durationNs == INSTANT_DURATION) {
+            (void)sprintf_s(buf, sizeof(buf), "\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%" PRIu64 ".%03" PRIu64
+                ",\"pid\":%d,\"tid\":%d", CategoryName(category), startNs / NS_PER_US, startNs % NS_PER_US,
+                getpid(), tid);
+        } else {
+            (void)sprintf_s(buf, sizeof(buf), "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%" PRIu64 ".%03" PRIu64
+                ",\"dur\":%" PRIu64 ".%03" PRIu64 ",\"pid\":%d,\"tid\":%d", CategoryName(category),
+                startNs / NS_PER_US, startNs % NS_PER_US, durationNs / NS_PER_US, durationNs % NS_PER_US,
+                getpid(), tid);
+        }
+        dumpString += buf;
+        if (arg != OHOS::Media::MediaTrace::NO_ARG) {
+            (void)sprintf_s(buf, sizeof(buf), ",\"args\":{\"arg\":%" PRId64 "}", arg);
+            dumpString += buf;
+        }
+        dumpString += "}";
+    }
+
+    void DumpRing(std::string &dumpString, TraceRing &ring)
+    {
+        uint64_t end = ring.writeIndex.load(std::memory_order_acquire);
+        uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+        for (uint64_t index = begin; index < end; index++) {
+            TraceEvent &event = ring.events[index & (RING_CAPACITY - 1)];
+            uint64_t seq = event.seq.load(std::memory_order_acquire);
+            if (seq != index * 2 + 2) {
+                continue; // overwritten by the owner thread.
+            }
+            const char *name = event.name.load(std::memory_order_relaxed);
+            uint32_t category = event.category.load(std::memory_order_relaxed);
+            uint64_t startNs = event.startNs.load(std::memory_order_relaxed);
+            uint64_t durationNs = event.durationNs.load(std::memory_order_relaxed);
+            int64_t arg = event.arg.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (event.seq.load(std::memory_order_relaxed) != seq || name == nullptr) {
+                continue;
+            }
+            DumpEvent(dumpString, ring.tid, name, category, startNs, durationNs, arg);
+        }
+    }
+}
+
+namespace OHOS {
+namespace Media {
+std::atomic<uint32_t> MediaTrace::enabledCategories_ = 0;
+
+void MediaTrace::EnableCategories(uint32_t categories)
+{
+    uint32_t old = enabledCategories_.fetch_or(categories, std::memory_order_relaxed);
+    MEDIA_LOGI("trace categories enabled: 0x%{public}x", old | categories);
+}
+
+void MediaTrace::DisableCategories(uint32_t categories)
+{
+    uint32_t old = enabledCategories_.fetch_and(~categories, std::memory_order_relaxed);
+    MEDIA_LOGI("trace categories enabled: 0x%{public}x", old & ~categories);
+}
+
+void MediaTrace::RecordSpan(const char *name, uint32_t category, uint64_t startNs, uint64_t endNs, int64_t arg)
+{
+    if (name == nullptr || !IsEnabled(category)) {
+        return;
+    }
+    WriteEvent(name, category, startNs, endNs > startNs ? endNs - startNs : 0, arg);
+}
+
+void MediaTrace::RecordInstant(const char *name, uint32_t category, int64_t arg)
+{
+    if (name == nullptr || !IsEnabled(category)) {
+        return;
+    }
+    WriteEvent(name, category, GetTimeNs(), INSTANT_DURATION, arg);
+}
+
+const char *MediaTrace::InternName(const std::string &name)
+{
+    static std::mutex *internMutex = new std::mutex();
+    static auto *internedNames = new std::set<std::string>();
+    std::lock_guard<std::mutex> lock(*internMutex);
+    return internedNames->insert(name).first->c_str();
+}
+
+void MediaTrace::DumpChromeTrace(std::string &dumpString)
+{
+    std::vector<std::shared_ptr<TraceRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(RingsMutex());
+        rings = AllRings();
+    }
+
+    dumpString += "{\"traceEvents\":[";
+    for (auto &ring : rings) {
+        DumpRing(dumpString, *ring);
+    }
+    dumpString += "\n]}\n";
+}
+} // namespace Media
+} // namespace OHOS
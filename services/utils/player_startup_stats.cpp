@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "player_startup_stats.h"
+#include <cinttypes>
+#include <securec.h>
+
+namespace OHOS {
+namespace Media {
+PlayerStartupStats &PlayerStartupStats::GetInstance()
+{
+    static PlayerStartupStats instance;
+    return instance;
+}
+
+void PlayerStartupStats::OnPrepared(bool warm, bool audioOnly, uint64_t latencyUs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_[audioOnly][warm].Record(latencyUs);
+}
+
+LatencyHistogram PlayerStartupStats::GetStats(bool warm, bool audioOnly)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_[audioOnly][warm];
+}
+
+void PlayerStartupStats::DumpOne(std::string &dumpString, const char *name, const LatencyHistogram &stats)
+{
+    char buf[256] = {0}; // 256 is enough for one line.
+    (void)sprintf_s(buf, sizeof(buf), "  %s: count %" PRIu64 ", %s\n", name, stats.GetCount(),
+        stats.ToString().c_str());
+    dumpString += buf;
+}
+
+void PlayerStartupStats::DumpStats(std::string &dumpString)
+{
+    dumpString += "PlayerStartupStats statistics, source set to prepared:\n";
+    DumpOne(dumpString, "video warm", GetStats(true, false));
+    DumpOne(dumpString, "video cold", GetStats(false, false));
+    DumpOne(dumpString, "audio warm", GetStats(true, true));
+    DumpOne(dumpString, "audio cold", GetStats(false, true));
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scrub_stats.h"
+#include <algorithm>
+#include <cinttypes>
+#include <securec.h>
+
+namespace {
+    constexpr uint64_t US_PER_MS = 1000;
+}
+
+namespace OHOS {
+namespace Media {
+ScrubStats &ScrubStats::GetInstance()
+{
+    static ScrubStats instance;
+    return instance;
+}
+
+void ScrubStats::OnScrubRequested(bool coalesced)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.requestCount++;
+    if (coalesced) {
+        stats_.coalescedCount++;
+    }
+}
+
+void ScrubStats::OnScrubSeekDone(uint64_t latencyUs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.latency.Record(latencyUs);
+}
+
+void ScrubStats::OnScrubReleased(uint64_t latencyUs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.sessionCount++;
+    stats_.totalReleaseLatencyUs += latencyUs;
+    stats_.maxReleaseLatencyUs = std::max(stats_.maxReleaseLatencyUs, latencyUs);
+}
+
+ScrubStats::Stats ScrubStats::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ScrubStats::DumpStats(std::string &dumpString)
+{
+    Stats stats = GetStats();
+    uint64_t sessions = (stats.sessionCount == 0) ? 1 : stats.sessionCount;
+    char buf[256] = {0}; // 256 is enough for one line.
+    (void)sprintf_s(buf, sizeof(buf), "ScrubStats statistics: sessions %" PRIu64 ", requested %" PRIu64
+        ", executed %" PRIu64 ", coalesced %" PRIu64 "\n", stats.sessionCount, stats.requestCount,
+        stats.latency.GetCount(), stats.coalescedCount);
+    dumpString += buf;
+    (void)sprintf_s(buf, sizeof(buf), "  %s; release latency(ms) avg %" PRIu64 ", max %" PRIu64 "\n",
+        stats.latency.ToString().c_str(), stats.totalReleaseLatencyUs / sessions / US_PER_MS,
+        stats.maxReleaseLatencyUs / US_PER_MS);
+    dumpString += buf;
+}
+} // namespace Media
+} // namespace OHOS
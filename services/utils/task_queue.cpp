@@ -14,23 +14,175 @@
  */
 
 #include "task_queue.h"
+#include <algorithm>
+#include <set>
+#include <securec.h>
+#include "task_worker_pool.h"
+#include "media_trace.h"
 #include "media_log.h"
 #include "media_errors.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "TaskQueue"};
+    // the shared pool queue whose task is being executed by current thread.
+    thread_local OHOS::Media::TaskQueue *g_currentPoolQueue = nullptr;
+    constexpr uint64_t NS_PER_US = 1000;
+    constexpr uint32_t PERCENT_50 = 50;
+    constexpr uint32_t PERCENT_99 = 99;
+    constexpr uint32_t PERCENT_100 = 100;
+
+    std::mutex &AliveQueuesMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::set<OHOS::Media::TaskQueue *> &AliveQueues()
+    {
+        static std::set<OHOS::Media::TaskQueue *> queues;
+        return queues;
+    }
+
+    uint64_t GetCurTimeNs()
+    {
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
 }
 
 namespace OHOS {
 namespace Media {
+uint64_t TaskQueueStats::Percentile(const std::array<uint64_t, HISTOGRAM_BUCKETS> &histogram, uint32_t percent)
+{
+    uint64_t total = 0;
+    for (auto count : histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t target = (total * percent + PERCENT_100 - 1) / PERCENT_100;
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        accumulated += histogram[i];
+        if (accumulated >= target) {
+            return (i == HISTOGRAM_BUCKETS - 1) ? UINT64_MAX : (1ULL << i);
+        }
+    }
+    return UINT64_MAX;
+}
+
+void TaskQueue::StatsRecorder::UpdateMax(std::atomic<uint64_t> &maxVal, uint64_t val)
+{
+    uint64_t cur = maxVal.load(std::memory_order_relaxed);
+    while (val > cur && !maxVal.compare_exchange_weak(cur, val, std::memory_order_relaxed)) {
+    }
+}
+
+size_t TaskQueue::StatsRecorder::BucketIndex(uint64_t valUs)
+{
+    size_t index = 0;
+    while (valUs != 0 && index < TaskQueueStats::HISTOGRAM_BUCKETS - 1) {
+        valUs >>= 1;
+        index++;
+    }
+    return index;
+}
+
+void TaskQueue::StatsRecorder::OnEnqueued(uint64_t depth)
+{
+    (void)enqueuedCount_.fetch_add(1, std::memory_order_relaxed);
+    UpdateMax(depthHighWater_, depth);
+}
+
+void TaskQueue::StatsRecorder::OnCanceled()
+{
+    (void)canceledCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TaskQueue::StatsRecorder::OnExecuted(uint64_t waitUs, uint64_t execUs)
+{
+    (void)executedCount_.fetch_add(1, std::memory_order_relaxed);
+    (void)totalWaitUs_.fetch_add(waitUs, std::memory_order_relaxed);
+    (void)totalExecUs_.fetch_add(execUs, std::memory_order_relaxed);
+    UpdateMax(maxWaitUs_, waitUs);
+    UpdateMax(maxExecUs_, execUs);
+    (void)waitUsHistogram_[BucketIndex(waitUs)].fetch_add(1, std::memory_order_relaxed);
+    (void)execUsHistogram_[BucketIndex(execUs)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void TaskQueue::StatsRecorder::Snapshot(TaskQueueStats &stats) const
+{
+    stats.enqueuedCount = enqueuedCount_.load(std::memory_order_relaxed);
+    stats.executedCount = executedCount_.load(std::memory_order_relaxed);
+    stats.canceledCount = canceledCount_.load(std::memory_order_relaxed);
+    stats.depthHighWater = depthHighWater_.load(std::memory_order_relaxed);
+    stats.totalWaitUs = totalWaitUs_.load(std::memory_order_relaxed);
+    stats.maxWaitUs = maxWaitUs_.load(std::memory_order_relaxed);
+    stats.totalExecUs = totalExecUs_.load(std::memory_order_relaxed);
+    stats.maxExecUs = maxExecUs_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < TaskQueueStats::HISTOGRAM_BUCKETS; i++) {
+        stats.waitUsHistogram[i] = waitUsHistogram_[i].load(std::memory_order_relaxed);
+        stats.execUsHistogram[i] = execUsHistogram_[i].load(std::memory_order_relaxed);
+    }
+}
+
+TaskQueue::TaskQueue(const std::string &name, ExecuteMode mode)
+    : name_(name), traceName_(MediaTrace::InternName(name)), mode_(mode)
+{
+    std::lock_guard<std::mutex> lock(AliveQueuesMutex());
+    (void)AliveQueues().insert(this);
+}
+
 TaskQueue::~TaskQueue()
 {
     (void)Stop();
+    std::lock_guard<std::mutex> lock(AliveQueuesMutex());
+    (void)AliveQueues().erase(this);
+}
+
+TaskQueueStats TaskQueue::GetStats() const
+{
+    TaskQueueStats stats;
+    stats_.Snapshot(stats);
+    return stats;
+}
+
+void TaskQueue::DumpAllStats(std::string &dumpString)
+{
+    std::lock_guard<std::mutex> lock(AliveQueuesMutex());
+    dumpString += "TaskQueue statistics, alive queues: " + std::to_string(AliveQueues().size()) + "\n";
+    for (auto queue : AliveQueues()) {
+        TaskQueueStats stats = queue->GetStats();
+        char buf[256] = {0}; // 256 is enough for one line.
+        uint64_t executed = (stats.executedCount == 0) ? 1 : stats.executedCount;
+        (void)sprintf_s(buf, sizeof(buf), "  [%s] 0x%06" PRIXPTR " %s: enqueued %" PRIu64 ", executed %" PRIu64
+            ", canceled %" PRIu64 ", depth high water %" PRIu64 "\n", queue->name_.c_str(), FAKE_POINTER(queue),
+            (queue->mode_ == SHARED_POOL) ? "pool" : "thread", stats.enqueuedCount, stats.executedCount,
+            stats.canceledCount, stats.depthHighWater);
+        dumpString += buf;
+        (void)sprintf_s(buf, sizeof(buf), "    wait(us) avg %" PRIu64 ", p50 <= %" PRIu64 ", p99 <= %" PRIu64
+            ", max %" PRIu64 "; exec(us) avg %" PRIu64 ", p50 <= %" PRIu64 ", p99 <= %" PRIu64 ", max %" PRIu64 "\n",
+            stats.totalWaitUs / executed, TaskQueueStats::Percentile(stats.waitUsHistogram, PERCENT_50),
+            TaskQueueStats::Percentile(stats.waitUsHistogram, PERCENT_99), stats.maxWaitUs,
+            stats.totalExecUs / executed, TaskQueueStats::Percentile(stats.execUsHistogram, PERCENT_50),
+            TaskQueueStats::Percentile(stats.execUsHistogram, PERCENT_99), stats.maxExecUs);
+        dumpString += buf;
+    }
 }
 
 int32_t TaskQueue::Start()
 {
     std::unique_lock<std::mutex> lock(mutex_);
+    if (mode_ == SHARED_POOL) {
+        if (!isExit_) {
+            MEDIA_LOGW("Started already, ignore ! [%{public}s]", name_.c_str());
+            return MSERR_OK;
+        }
+        isExit_ = false;
+        return MSERR_OK;
+    }
+
     if (thread_ != nullptr) {
         MEDIA_LOGW("Started already, ignore ! [%{public}s]", name_.c_str());
         return MSERR_OK;
@@ -49,6 +201,20 @@ int32_t TaskQueue::Stop() noexcept
         return MSERR_OK;
     }
 
+    if (mode_ == SHARED_POOL) {
+        if (g_currentPoolQueue == this) {
+            MEDIA_LOGI("Stop at the task thread, reject");
+            return MSERR_INVALID_OPERATION;
+        }
+        isExit_ = true;
+        lock.unlock();
+        TaskWorkerPool::GetInstance().Remove(*this);
+        lock.lock();
+        CancelNotExecutedTaskLocked();
+        strandState_ = STRAND_IDLE;
+        return MSERR_OK;
+    }
+
     if (std::this_thread::get_id() == thread_->get_id()) {
         MEDIA_LOGI("Stop at the task thread, reject");
         return MSERR_INVALID_OPERATION;
@@ -97,11 +263,28 @@ int32_t TaskQueue::EnqueueTask(const std::shared_ptr<ITaskHandler> &task, bool c
         "Enqueue task but timestamp is overflow, why? [%{public}s]", name_.c_str());
 
     uint64_t executeTimeNs = delayUs * US_TO_NS + curTimeNs;
-    auto iter = std::find_if(taskList_.begin(), taskList_.end(), [executeTimeNs](const TaskHandlerItem &item) {
-        return (item.executeTimeNs_ > executeTimeNs);
-    });
-    (void)taskList_.insert(iter, {task, executeTimeNs});
-    cond_.notify_all();
+    if (delayUs == 0) {
+        // fast path, the steady clock is read under lock, so the immediate tasks are already in order.
+        immediateTasks_.push_back({task, executeTimeNs, nextSeq_++});
+        stats_.OnEnqueued(immediateTasks_.size() - immediateHead_ + delayedTasks_.size());
+        if (mode_ == SHARED_POOL) {
+            SchedulePoolLocked();
+        } else {
+            cond_.notify_one();
+        }
+        return 0;
+    }
+
+    bool earliest = delayedTasks_.empty() || (executeTimeNs < delayedTasks_.front().executeTimeNs_);
+    delayedTasks_.push_back({task, executeTimeNs, nextSeq_++});
+    std::push_heap(delayedTasks_.begin(), delayedTasks_.end(), TaskHandlerItemLater());
+    stats_.OnEnqueued(immediateTasks_.size() - immediateHead_ + delayedTasks_.size());
+    if (mode_ == SHARED_POOL) {
+        SchedulePoolLocked();
+    } else if (earliest) {
+        // only need to wake up the processor when its waiting deadline is changed.
+        cond_.notify_one();
+    }
 
     return 0;
 }
@@ -109,11 +292,52 @@ int32_t TaskQueue::EnqueueTask(const std::shared_ptr<ITaskHandler> &task, bool c
 void TaskQueue::CancelNotExecutedTaskLocked()
 {
     MEDIA_LOGI("All task not executed are being cancelled..........[%{public}s]", name_.c_str());
-    while (!taskList_.empty()) {
-        std::shared_ptr<ITaskHandler> task = taskList_.front().task_;
-        taskList_.pop_front();
+    while (HasTaskLocked()) {
+        std::shared_ptr<ITaskHandler> task = NextTaskLocked().task_;
+        PopNextTaskLocked();
         if (task != nullptr) {
             task->Cancel();
+            stats_.OnCanceled();
+        }
+    }
+}
+
+bool TaskQueue::HasTaskLocked() const
+{
+    return (immediateHead_ < immediateTasks_.size()) || !delayedTasks_.empty();
+}
+
+const TaskQueue::TaskHandlerItem &TaskQueue::NextTaskLocked() const
+{
+    if (immediateHead_ >= immediateTasks_.size()) {
+        return delayedTasks_.front();
+    }
+    const TaskHandlerItem &immediate = immediateTasks_[immediateHead_];
+    if (delayedTasks_.empty()) {
+        return immediate;
+    }
+    // a delayed task that expired before the immediate task was enqueued goes first.
+    if (TaskHandlerItemLater()(immediate, delayedTasks_.front())) {
+        return delayedTasks_.front();
+    }
+    return immediate;
+}
+
+void TaskQueue::PopNextTaskLocked()
+{
+    if (!delayedTasks_.empty() && (&NextTaskLocked() == &delayedTasks_.front())) {
+        std::pop_heap(delayedTasks_.begin(), delayedTasks_.end(), TaskHandlerItemLater());
+        delayedTasks_.pop_back();
+    } else {
+        immediateTasks_[immediateHead_].task_ = nullptr;
+        immediateHead_++;
+        constexpr size_t COMPACT_THRESHOLD = 64;
+        if (immediateHead_ == immediateTasks_.size()) {
+            immediateTasks_.clear();
+            immediateHead_ = 0;
+        } else if (immediateHead_ >= COMPACT_THRESHOLD && immediateHead_ * 2 >= immediateTasks_.size()) {
+            (void)immediateTasks_.erase(immediateTasks_.begin(), immediateTasks_.begin() + immediateHead_);
+            immediateHead_ = 0;
         }
     }
 }
@@ -123,15 +347,15 @@ void TaskQueue::TaskProcessor()
     MEDIA_LOGI("Enter TaskProcessor [%{public}s]", name_.c_str());
     while (true) {
         std::unique_lock<std::mutex> lock(mutex_);
-        cond_.wait(lock, [this] { return isExit_ || !taskList_.empty(); });
+        cond_.wait(lock, [this] { return isExit_ || HasTaskLocked(); });
         if (isExit_) {
             MEDIA_LOGI("Exit TaskProcessor [%{public}s]", name_.c_str());
             return;
         }
-        TaskHandlerItem item = taskList_.front();
+        TaskHandlerItem item = NextTaskLocked();
         uint64_t curTimeNs = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
         if (curTimeNs >= item.executeTimeNs_) {
-            taskList_.pop_front();
+            PopNextTaskLocked();
         } else {
             uint64_t diff =  item.executeTimeNs_ - curTimeNs;
             (void)cond_.wait_for(lock, std::chrono::nanoseconds(diff));
@@ -139,21 +363,91 @@ void TaskQueue::TaskProcessor()
         }
         lock.unlock();
 
-        if (item.task_ == nullptr || item.task_->IsCanceled()) {
-            MEDIA_LOGD("task is nullptr or task canceled. [%{public}s]", name_.c_str());
-            continue;
-        }
+        ExecuteTask(item);
+    }
+    MEDIA_LOGI("Leave TaskProcessor [%{public}s]", name_.c_str());
+}
 
-        item.task_->Execute();
-        if (item.task_->GetAttribute().periodicTimeUs_ == UINT64_MAX) {
-            continue;
-        }
-        int32_t res = EnqueueTask(item.task_, false, item.task_->GetAttribute().periodicTimeUs_);
-        if (res != MSERR_OK) {
-            MEDIA_LOGW("enqueue periodic task failed:%d, why? [%{public}s]", res, name_.c_str());
+void TaskQueue::ExecuteTask(const TaskHandlerItem &item)
+{
+    if (item.task_ == nullptr || item.task_->IsCanceled()) {
+        MEDIA_LOGD("task is nullptr or task canceled. [%{public}s]", name_.c_str());
+        if (item.task_ != nullptr) {
+            stats_.OnCanceled();
         }
+        return;
     }
-    MEDIA_LOGI("Leave TaskProcessor [%{public}s]", name_.c_str());
+
+    uint64_t startTimeNs = GetCurTimeNs();
+    item.task_->Execute();
+    uint64_t finishTimeNs = GetCurTimeNs();
+    uint64_t waitNs = (startTimeNs > item.executeTimeNs_) ? (startTimeNs - item.executeTimeNs_) : 0;
+    stats_.OnExecuted(waitNs / NS_PER_US, (finishTimeNs - startTimeNs) / NS_PER_US);
+    if (MediaTrace::IsEnabled(MEDIA_TRACE_TASK_QUEUE)) {
+        // the steady clock is the same monotonic clock, the arg is the waiting time in us.
+        MediaTrace::RecordSpan(traceName_, MEDIA_TRACE_TASK_QUEUE, startTimeNs, finishTimeNs,
+            static_cast<int64_t>(waitNs / NS_PER_US));
+    }
+    if (item.task_->GetAttribute().periodicTimeUs_ == UINT64_MAX) {
+        return;
+    }
+    int32_t res = EnqueueTask(item.task_, false, item.task_->GetAttribute().periodicTimeUs_);
+    if (res != MSERR_OK) {
+        MEDIA_LOGW("enqueue periodic task failed:%d, why? [%{public}s]", res, name_.c_str());
+    }
+}
+
+void TaskQueue::SchedulePoolLocked()
+{
+    if (strandState_ == STRAND_RUNNING) {
+        // the worker will reschedule this queue after the running task finished.
+        return;
+    }
+
+    uint64_t wakeNs = NextTaskLocked().executeTimeNs_;
+    if (strandState_ == STRAND_PENDING && wakeNs >= strandWakeNs_) {
+        return;
+    }
+    strandState_ = STRAND_PENDING;
+    strandWakeNs_ = wakeNs;
+    TaskWorkerPool::GetInstance().Schedule(*this, wakeNs);
+}
+
+uint64_t TaskQueue::RunOnPool()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (strandState_ == STRAND_RUNNING) {
+        // a stale schedule entry, the running worker will reschedule this queue.
+        return UINT64_MAX;
+    }
+    if (isExit_ || !HasTaskLocked()) {
+        strandState_ = STRAND_IDLE;
+        return UINT64_MAX;
+    }
+
+    TaskHandlerItem item = NextTaskLocked();
+    uint64_t curTimeNs = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    if (curTimeNs < item.executeTimeNs_) {
+        strandState_ = STRAND_PENDING;
+        strandWakeNs_ = item.executeTimeNs_;
+        return strandWakeNs_;
+    }
+    PopNextTaskLocked();
+    strandState_ = STRAND_RUNNING;
+    lock.unlock();
+
+    g_currentPoolQueue = this;
+    ExecuteTask(item);
+    g_currentPoolQueue = nullptr;
+
+    lock.lock();
+    if (isExit_ || !HasTaskLocked()) {
+        strandState_ = STRAND_IDLE;
+        return UINT64_MAX;
+    }
+    strandState_ = STRAND_PENDING;
+    strandWakeNs_ = NextTaskLocked().executeTimeNs_;
+    return strandWakeNs_;
 }
 }
 }
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "task_worker_pool.h"
+#include <algorithm>
+#include <chrono>
+#include "task_queue.h"
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "TaskWorkerPool"};
+    constexpr size_t MIN_WORKER_NUM = 2;
+}
+
+namespace OHOS {
+namespace Media {
+TaskWorkerPool &TaskWorkerPool::GetInstance()
+{
+    static TaskWorkerPool instance;
+    return instance;
+}
+
+TaskWorkerPool::TaskWorkerPool()
+{
+    maxWorkers_ = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), MIN_WORKER_NUM);
+    MEDIA_LOGI("task worker pool created, max workers: %{public}zu", maxWorkers_);
+}
+
+TaskWorkerPool::~TaskWorkerPool()
+{
+    std::vector<std::thread> workers;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        isExit_ = true;
+        cond_.notify_all();
+        std::swap(workers, workers_);
+    }
+
+    for (auto &worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void TaskWorkerPool::Schedule(TaskQueue &queue, uint64_t wakeNs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (isExit_) {
+        return;
+    }
+
+    ScheduleLocked(queue, wakeNs);
+    if (idleWorkers_ == 0) {
+        SpawnWorkerLocked();
+    }
+    cond_.notify_one();
+}
+
+void TaskWorkerPool::Remove(TaskQueue &queue)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    runningCond_.wait(lock, [&queue] { return queue.poolRunning_ == 0; });
+
+    queue.poolSeq_ = 0;
+    // purge all the entries of this queue, the stale ones included, the queue will be destroyed.
+    auto it = std::remove_if(scheduledQueues_.begin(), scheduledQueues_.end(),
+        [&queue](const ScheduleEntry &entry) { return entry.queue == &queue; });
+    (void)scheduledQueues_.erase(it, scheduledQueues_.end());
+    std::make_heap(scheduledQueues_.begin(), scheduledQueues_.end(), ScheduleEntryLater());
+}
+
+void TaskWorkerPool::ScheduleLocked(TaskQueue &queue, uint64_t wakeNs)
+{
+    if (queue.poolSeq_ != 0 && queue.poolWakeNs_ <= wakeNs) {
+        return;
+    }
+
+    // the old entry of this queue is left in the heap, and it will be dropped when popped.
+    queue.poolSeq_ = ++nextSeq_;
+    queue.poolWakeNs_ = wakeNs;
+    scheduledQueues_.push_back({ wakeNs, queue.poolSeq_, &queue });
+    std::push_heap(scheduledQueues_.begin(), scheduledQueues_.end(), ScheduleEntryLater());
+}
+
+void TaskWorkerPool::PopEntryLocked()
+{
+    std::pop_heap(scheduledQueues_.begin(), scheduledQueues_.end(), ScheduleEntryLater());
+    scheduledQueues_.pop_back();
+}
+
+void TaskWorkerPool::SpawnWorkerLocked()
+{
+    if (workers_.size() >= maxWorkers_) {
+        return;
+    }
+    workers_.emplace_back(&TaskWorkerPool::WorkerLoop, this);
+    MEDIA_LOGI("task worker pool grows to %{public}zu workers", workers_.size());
+}
+
+void TaskWorkerPool::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!isExit_) {
+        if (scheduledQueues_.empty()) {
+            idleWorkers_++;
+            cond_.wait(lock);
+            idleWorkers_--;
+            continue;
+        }
+
+        ScheduleEntry entry = scheduledQueues_.front();
+        if (entry.seq != entry.queue->poolSeq_) {
+            PopEntryLocked();
+            continue;
+        }
+        uint64_t curTimeNs = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        if (curTimeNs < entry.wakeNs) {
+            idleWorkers_++;
+            (void)cond_.wait_for(lock, std::chrono::nanoseconds(entry.wakeNs - curTimeNs));
+            idleWorkers_--;
+            continue;
+        }
+
+        TaskQueue *queue = entry.queue;
+        PopEntryLocked();
+        queue->poolSeq_ = 0;
+        queue->poolRunning_++;
+        if (!scheduledQueues_.empty()) {
+            if (idleWorkers_ == 0) {
+                SpawnWorkerLocked();
+            }
+            cond_.notify_one();
+        }
+        lock.unlock();
+
+        uint64_t nextWakeNs = queue->RunOnPool();
+
+        lock.lock();
+        if (--queue->poolRunning_ == 0) {
+            runningCond_.notify_all();
+        }
+        if (nextWakeNs != UINT64_MAX) {
+            ScheduleLocked(*queue, nextWakeNs);
+        }
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -15,9 +15,11 @@
 
 #include "time_monitor.h"
 #include "media_log.h"
+#include "media_trace.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "TimeMonitor"};
+constexpr uint64_t NS_PER_MS = 1000000;
 }
 
 namespace OHOS {
@@ -35,37 +37,18 @@ TimeMonitor::~TimeMonitor()
 
 void TimeMonitor::StartTime()
 {
-    int ret = gettimeofday(&startTime_, nullptr);
-    if (ret == -1) {
-        MEDIA_LOGE("get current time failed!");
-    }
+    startTimeNs_ = MediaTrace::GetTimeNs();
     isStart_ = true;
 }
 
 void TimeMonitor::FinishTime()
 {
     if (isStart_) {
-        int ret = gettimeofday(&finishTime_, nullptr);
-        if (ret == -1) {
-            MEDIA_LOGE("get current time failed!");
-        }
-        MEDIA_LOGD("%{public}s: elapsed time = %{public}" PRId64 " ms", objectName_.c_str(),
-            (Timeval2Sec(finishTime_, TIME_VAL_MS) - Timeval2Sec(startTime_, TIME_VAL_MS)));
+        // the monotonic clock is not affected by the wall time adjustment.
+        uint64_t elapsedNs = MediaTrace::GetTimeNs() - startTimeNs_;
+        MEDIA_LOGD("%{public}s: elapsed time = %{public}" PRIu64 " ms", objectName_.c_str(), elapsedNs / NS_PER_MS);
         isStart_ = false;
     }
 }
-
-int64_t TimeMonitor::Timeval2Sec(const timeval &tv, TimeValType valType) const
-{
-    if ((valType == TIME_VAL_MS) || (valType == TIME_VAL_US) || (valType == TIME_VAL_NS)) {
-        if ((static_cast<int64_t>(tv.tv_sec) < (LLONG_MAX / valType)) &&
-            (static_cast<int64_t>(tv.tv_usec) <= TIME_VAL_US)) {
-            return static_cast<int64_t>(tv.tv_sec) * valType + static_cast<int64_t>(tv.tv_usec) * valType / TIME_VAL_US;
-        } else {
-            MEDIA_LOGW("timestamp overflow! sec:%{public}ld, usec:%{public}ld", tv.tv_sec, tv.tv_usec);
-        }
-    }
-    return -1;
-}
 }
 }
@@ -14,8 +14,12 @@
  */
 
 #include "uri_helper.h"
+#include <cctype>
+#include <cerrno>
 #include <cstring>
 #include <climits>
+#include <cstdlib>
+#include <sys/stat.h>
 #include "media_errors.h"
 #include "media_log.h"
 
@@ -56,6 +60,9 @@ UriHelper::UriHelper(UriHelper &&rhs) noexcept
     uri_.swap(rhs.uri_);
     formattedUri_.swap(rhs.formattedUri_);
     type_ = rhs.type_;
+    fd_ = rhs.fd_;
+    offset_ = rhs.offset_;
+    size_ = rhs.size_;
 }
 
 UriHelper &UriHelper::operator=(UriHelper &&rhs) noexcept
@@ -67,6 +74,9 @@ UriHelper &UriHelper::operator=(UriHelper &&rhs) noexcept
     uri_.swap(rhs.uri_);
     formattedUri_.swap(rhs.formattedUri_);
     type_ = rhs.type_;
+    fd_ = rhs.fd_;
+    offset_ = rhs.offset_;
+    size_ = rhs.size_;
 
     return *this;
 }
@@ -74,7 +84,7 @@ UriHelper &UriHelper::operator=(UriHelper &&rhs) noexcept
 UriHelper &UriHelper::FormatMe()
 {
     static const std::map<std::string_view, uint8_t> VALID_URI_HEAD_MAP = {
-        {"file", URI_TYPE_FILE}, {"fd", URI_TYPE_FD}, {"http", URI_TYPE_HTTP}
+        {"file", URI_TYPE_FILE}, {"fd", URI_TYPE_FD}, {"http", URI_TYPE_HTTP}, {"https", URI_TYPE_HTTP}
     };
 
     if (!formattedUri_.empty()) {
@@ -82,6 +92,10 @@ UriHelper &UriHelper::FormatMe()
     }
 
     std::string_view::size_type start = uri_.find_first_not_of(' ');
+    if (start == std::string_view::npos) {
+        type_ = URI_TYPE_UNKNOWN;
+        return *this;
+    }
     std::string_view::size_type end = uri_.find_last_not_of(' ') + sizeof(char);
     formattedUri_ = uri_.substr(start, end);
     std::string_view rawUri = formattedUri_;
@@ -104,15 +118,120 @@ UriHelper &UriHelper::FormatMe()
         if (PathToRealPath(rawUri, formattedUri_)) {
             (void)formattedUri_.insert(0, "file://");
         }
+    } else if (type_ == URI_TYPE_FD) {
+        if (!ParseFdUri(rawUri)) {
+            type_ = URI_TYPE_UNKNOWN;
+            return *this;
+        }
+        formattedUri_ = MakeFdUri(fd_, offset_, size_);
     }
     return *this;
 }
 
+static bool StrToInt64(std::string_view str, int64_t &value)
+{
+    if (str.empty() || str.size() >= 32) { // 32 is enough for any int64.
+        return false;
+    }
+    std::string valStr(str);
+    char *end = nullptr;
+    errno = 0;
+    long long result = strtoll(valStr.c_str(), &end, 10); // 10 is the decimal base.
+    if (errno != 0 || end == nullptr || *end != '\0') {
+        return false;
+    }
+    value = static_cast<int64_t>(result);
+    return true;
+}
+
+bool UriHelper::ParseFdUri(std::string_view rawUri)
+{
+    std::string_view::size_type pos = rawUri.find('?');
+    int64_t fd = -1;
+    if (!StrToInt64(rawUri.substr(0, pos), fd) || fd < 0 || fd > INT32_MAX) {
+        MEDIA_LOGE("invalid fd uri: %{public}s", formattedUri_.c_str());
+        return false;
+    }
+
+    int64_t offset = 0;
+    int64_t size = -1;
+    std::string_view params = (pos == std::string_view::npos) ? "" : rawUri.substr(pos + 1);
+    while (!params.empty()) {
+        std::string_view::size_type andPos = params.find('&');
+        std::string_view param = params.substr(0, andPos);
+        params = (andPos == std::string_view::npos) ? "" : params.substr(andPos + 1);
+
+        std::string_view::size_type eqPos = param.find('=');
+        CHECK_AND_RETURN_RET_LOG(eqPos != std::string_view::npos, false, "invalid fd uri param");
+        std::string_view key = param.substr(0, eqPos);
+        int64_t value = 0;
+        CHECK_AND_RETURN_RET_LOG(StrToInt64(param.substr(eqPos + 1), value), false, "invalid fd uri param");
+        if (key == "offset") {
+            offset = value;
+        } else if (key == "size") {
+            size = value;
+        } else {
+            MEDIA_LOGW("unknown fd uri param ignored");
+        }
+    }
+
+    struct stat64 st = {};
+    CHECK_AND_RETURN_RET_LOG(fstat64(static_cast<int32_t>(fd), &st) == 0, false,
+        "invalid fd: %{public}" PRId64 ", errno: %{public}d", fd, errno);
+    CHECK_AND_RETURN_RET_LOG(S_ISREG(st.st_mode), false, "fd %{public}" PRId64 " is not a regular file", fd);
+    int64_t fileSize = static_cast<int64_t>(st.st_size);
+    CHECK_AND_RETURN_RET_LOG(offset >= 0 && offset < fileSize, false,
+        "invalid offset: %{public}" PRId64 ", file size: %{public}" PRId64, offset, fileSize);
+    CHECK_AND_RETURN_RET_LOG(size != 0, false, "invalid size: 0");
+    if (size < 0 || size > fileSize - offset) {
+        size = fileSize - offset;
+    }
+
+    fd_ = static_cast<int32_t>(fd);
+    offset_ = offset;
+    size_ = size;
+    return true;
+}
+
+std::string UriHelper::MakeFdUri(int32_t fd, int64_t offset, int64_t size)
+{
+    return "fd://" + std::to_string(fd) + "?offset=" + std::to_string(offset) + "&size=" + std::to_string(size);
+}
+
+int32_t UriHelper::GetFd() const
+{
+    return fd_;
+}
+
+int64_t UriHelper::GetOffset() const
+{
+    return offset_;
+}
+
+int64_t UriHelper::GetSize() const
+{
+    return size_;
+}
+
 uint8_t UriHelper::UriType() const
 {
     return type_;
 }
 
+bool UriHelper::IsFdScheme() const
+{
+    std::string_view::size_type start = 0;
+    while (start < uri_.size() && isspace(static_cast<unsigned char>(uri_[start])) != 0) {
+        start++;
+    }
+    std::string_view::size_type colon = uri_.find(':', start);
+    if (colon == std::string_view::npos || colon - start != strlen("fd")) {
+        return false;
+    }
+    return tolower(static_cast<unsigned char>(uri_[start])) == 'f' &&
+        tolower(static_cast<unsigned char>(uri_[start + 1])) == 'd';
+}
+
 std::string UriHelper::FormattedUri() const
 {
     return formattedUri_;
@@ -132,6 +251,21 @@ bool UriHelper::AccessCheck(uint8_t flag) const
         return true;
     }
 
+    if (type_ == URI_TYPE_FD) {
+        int flags = fcntl(fd_, F_GETFL);
+        if (flags == -1) {
+            return false;
+        }
+        uint32_t accMode = static_cast<uint32_t>(flags) & O_ACCMODE;
+        if ((flag & URI_READ) && accMode != O_RDONLY && accMode != O_RDWR) {
+            return false;
+        }
+        if ((flag & URI_WRITE) && accMode != O_WRONLY && accMode != O_RDWR) {
+            return false;
+        }
+        return true;
+    }
+
     return false; // Not implemented
 }
 }